@@ -136,6 +136,7 @@ void BoneTextureManager::cleanup() {
 
     if (boneTexture != 0) {
         glDeleteTextures(1, &boneTexture);
+        RenderDevice::getInstance().getStateCache().onTextureDeleted(boneTexture);
         boneTexture = 0;
     }
 
@@ -151,7 +152,7 @@ void BoneTextureManager::cleanup() {
 
 void BoneTextureManager::createBoneTexture() {
     glGenTextures(1, &boneTexture);
-    glBindTexture(GL_TEXTURE_2D, boneTexture);
+    RenderDevice::getInstance().getStateCache().bindTexture2D(1, boneTexture);  // 骨骼纹理固定使用单元1
 
     // 创建RGBA32F纹理，4列用于存储4x4矩阵
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, TEXTURE_WIDTH, TEXTURE_HEIGHT,
@@ -185,7 +186,7 @@ void BoneTextureManager::uploadRegion(uint32_t startBone, uint32_t boneCount) {
     }
 
     // 上传到GPU纹理的对应区域
-    glBindTexture(GL_TEXTURE_2D, boneTexture);
+    RenderDevice::getInstance().getStateCache().bindTexture2D(1, boneTexture);
     glTexSubImage2D(GL_TEXTURE_2D, 0,
                     0, static_cast<GLint>(startBone),              // x, y offset
                     TEXTURE_WIDTH, static_cast<GLint>(boneCount),  // width, height
@@ -294,13 +295,13 @@ struct TaskSystem::Impl {
         }
 
         // 查找动画和骨架的逻辑
-        auto animIt = asset->animations.find(input.animation);
-        auto skelIt = asset->skeletons.find(input.skeleton);
-        if (animIt == asset->animations.end() || skelIt == asset->skeletons.end() || !animIt->second.skeletal_animation) {
+        const auto* animEntry = asset->animations.get(input.animation);
+        const auto* skelEntry = asset->skeletons.get(input.skeleton);
+        if (!animEntry || !skelEntry || !animEntry->skeletal_animation) {
             return AnimationTaskOutput(input.skeleton, {}, input.taskId, false);
         }
-        const auto& animData = animIt->second;
-        const auto& skelPtr = skelIt->second;
+        const auto& animData = *animEntry;
+        const auto& skelPtr = *skelEntry;
 
         // 计算动画播放进度的逻辑
         float ratio = 0.0f;
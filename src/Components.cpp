@@ -1,4 +1,6 @@
 #include "EntityComponents.h"
+#include "Renderer.h"
+#include "ResourceManager.h"
 #include <algorithm>
 #include <iostream>
 #include <cmath>
@@ -8,16 +10,16 @@
 // =========================================================================
 
 RenderCommand RenderCommand::DrawMesh(const MeshData* mesh, const MeshData::SubMesh* submesh,
-                                      const glm::mat4& model, MaterialHandle mat, float depth, bool wireframe) {
+                                      const glm::mat4& model, uint32_t materialIndex, float depth, bool wireframe) {
     RenderCommand cmd(RenderCommandType::DRAW_MESH);
-    cmd.drawMesh = {mesh, submesh, model, mat, wireframe, depth};
+    cmd.drawMesh = {mesh, submesh, model, materialIndex, wireframe, depth};
     return cmd;
 }
 
 RenderCommand RenderCommand::DrawInstancedMesh(const MeshData* mesh, const MeshData::SubMesh* submesh,
-                                               const std::vector<glm::mat4>* instances, MaterialHandle mat) {
+                                               const std::vector<glm::mat4>* instances, uint32_t materialIndex) {
     RenderCommand cmd(RenderCommandType::DRAW_INSTANCED_MESH);
-    cmd.drawInstancedMesh = {mesh, submesh, instances, mat};
+    cmd.drawInstancedMesh = {mesh, submesh, instances, materialIndex};
     return cmd;
 }
 
@@ -27,41 +29,41 @@ RenderCommand RenderCommand::SetBones(const std::vector<glm::mat4>* bones, int c
     return cmd;
 }
 
-RenderCommand RenderCommand::SetUniformMat4(const std::string& name, const glm::mat4& value) {
+RenderCommand RenderCommand::SetUniformMat4(UniformId uniform, const glm::mat4& value) {
     RenderCommand cmd(RenderCommandType::SET_UNIFORM);
-    cmd.setUniform.name = name;
+    cmd.setUniform.uniform = uniform;
     cmd.setUniform.type = SetUniformData::MAT4;
     cmd.setUniform.mat4Value = value;
     return cmd;
 }
 
-RenderCommand RenderCommand::SetUniformVec3(const std::string& name, const glm::vec3& value) {
+RenderCommand RenderCommand::SetUniformVec3(UniformId uniform, const glm::vec3& value) {
     RenderCommand cmd(RenderCommandType::SET_UNIFORM);
-    cmd.setUniform.name = name;
+    cmd.setUniform.uniform = uniform;
     cmd.setUniform.type = SetUniformData::VEC3;
     cmd.setUniform.vec3Value = value;
     return cmd;
 }
 
-RenderCommand RenderCommand::SetUniformVec4(const std::string& name, const glm::vec4& value) {
+RenderCommand RenderCommand::SetUniformVec4(UniformId uniform, const glm::vec4& value) {
     RenderCommand cmd(RenderCommandType::SET_UNIFORM);
-    cmd.setUniform.name = name;
+    cmd.setUniform.uniform = uniform;
     cmd.setUniform.type = SetUniformData::VEC4;
     cmd.setUniform.vec4Value = value;
     return cmd;
 }
 
-RenderCommand RenderCommand::SetUniformFloat(const std::string& name, float value) {
+RenderCommand RenderCommand::SetUniformFloat(UniformId uniform, float value) {
     RenderCommand cmd(RenderCommandType::SET_UNIFORM);
-    cmd.setUniform.name = name;
+    cmd.setUniform.uniform = uniform;
     cmd.setUniform.type = SetUniformData::FLOAT;
     cmd.setUniform.floatValue = value;
     return cmd;
 }
 
-RenderCommand RenderCommand::SetUniformInt(const std::string& name, int value) {
+RenderCommand RenderCommand::SetUniformInt(UniformId uniform, int value) {
     RenderCommand cmd(RenderCommandType::SET_UNIFORM);
-    cmd.setUniform.name = name;
+    cmd.setUniform.uniform = uniform;
     cmd.setUniform.type = SetUniformData::INT;
     cmd.setUniform.intValue = value;
     return cmd;
@@ -283,113 +285,203 @@ entt::entity EntityFactory::createCamera(entt::registry& registry) {
     return entity;
 }
 
-std::vector<entt::entity> EntityFactory::createAnimatedModelFromAsset(entt::registry& registry, const ProcessedAsset& asset,
-                                                                      int modelIndex) {
-    std::vector<entt::entity> created_entities;
-    std::unordered_map<int, entt::entity> node_to_entity;
-    std::unordered_map<std::string, entt::entity> name_to_entity;
-
-    // --- 1. 创建一个"总根"实体, 它将是这个模型实例在场景中的唯一代表 ---
-    auto masterRoot = registry.create();
-    registry.emplace<Transform>(masterRoot);
-    registry.emplace<LocalTransform>(masterRoot); // 世界矩阵
-    registry.emplace<ModelRootTag>(masterRoot);   // 标记为总根
-    created_entities.push_back(masterRoot);
-    std::cout << "创建模型总根实体 " << modelIndex << ": " << static_cast<uint32_t>(masterRoot) << std::endl;
-
-    // --- 2. 为资源中的每个节点创建对应的实体和基础组件 ---
-    for (size_t nodeIdx = 0; nodeIdx < asset.nodes.size(); ++nodeIdx) {
-        const auto& node = asset.nodes[nodeIdx];
-        auto entity = registry.create();
-        created_entities.push_back(entity);
-        node_to_entity[static_cast<int>(nodeIdx)] = entity;
-
-        // 保证节点名唯一，用于后续骨骼映射
-        std::string node_name = node.name.empty()
-                                ? ("joint_" + std::to_string(nodeIdx))
-                                : node.name.c_str();
-        name_to_entity[node_name] = entity;
-
-        // 每个节点都有局部变换组件，其值由动画系统或父节点驱动
-        auto& transform = registry.emplace<Transform>(entity);
-        transform.position = ToGLM(node.local_transform.translation);
-        transform.rotation = ToGLM(node.local_transform.rotation);
-        transform.scale = ToGLM(node.local_transform.scale);
-
-        // 每个节点也都有世界变换组件，其值由变换系统计算
-        auto& localTransform = registry.emplace<LocalTransform>(entity);
-        localTransform.dirty = true; // 标记需要更新
-
-        // 如果节点有关联的网格，添加 MeshComponent
-        if (node.mesh.has_value()) {
-            registry.emplace<MeshComponent>(entity, node.mesh.value());
-            registry.emplace<RenderStateComponent>(entity);
+namespace {
+
+    // 创建模型实体用到的资源：节点、主骨架、网格和动画，句柄都能在asset中查到
+    struct ModelSource {
+        const std::vector<SceneNode>* nodes = nullptr;
+        std::optional<SkeletonHandle> skeleton;
+        std::vector<MeshHandle> meshes;
+        std::vector<AnimationHandle> animations;
+    };
+
+    std::vector<entt::entity> createAnimatedModel(entt::registry& registry, const ProcessedAsset& asset,
+                                                  const ModelSource& source, int modelIndex) {
+        const auto& nodes = *source.nodes;
+        std::vector<entt::entity> created_entities;
+        std::unordered_map<int, entt::entity> node_to_entity;
+        std::unordered_map<std::string, entt::entity> name_to_entity;
+
+        // --- 1. 创建一个"总根"实体, 它将是这个模型实例在场景中的唯一代表 ---
+        auto masterRoot = registry.create();
+        registry.emplace<Transform>(masterRoot);
+        registry.emplace<LocalTransform>(masterRoot); // 世界矩阵
+        registry.emplace<ModelRootTag>(masterRoot);   // 标记为总根
+        created_entities.push_back(masterRoot);
+        std::cout << "创建模型总根实体 " << modelIndex << ": " << static_cast<uint32_t>(masterRoot) << std::endl;
+
+        // --- 2. 为资源中的每个节点创建对应的实体和基础组件 ---
+        for (size_t nodeIdx = 0; nodeIdx < nodes.size(); ++nodeIdx) {
+            const auto& node = nodes[nodeIdx];
+            auto entity = registry.create();
+            created_entities.push_back(entity);
+            node_to_entity[static_cast<int>(nodeIdx)] = entity;
+
+            // 保证节点名唯一，用于后续骨骼映射
+            std::string node_name = node.name.empty()
+                                    ? ("joint_" + std::to_string(nodeIdx))
+                                    : node.name.c_str();
+            name_to_entity[node_name] = entity;
+
+            // 每个节点都有局部变换组件，其值由动画系统或父节点驱动
+            auto& transform = registry.emplace<Transform>(entity);
+            transform.position = ToGLM(node.local_transform.translation);
+            transform.rotation = ToGLM(node.local_transform.rotation);
+            transform.scale = ToGLM(node.local_transform.scale);
+
+            // 每个节点也都有世界变换组件，其值由变换系统计算
+            auto& localTransform = registry.emplace<LocalTransform>(entity);
+            localTransform.dirty = true; // 标记需要更新
+
+            // 如果节点有关联的网格，添加 MeshComponent
+            if (node.mesh.has_value()) {
+                registry.emplace<MeshComponent>(entity, node.mesh.value());
+                registry.emplace<RenderStateComponent>(entity);
+            }
         }
-    }
 
-    // --- 3. 建立实体间的父子层级关系 ---
-    for (const auto& [nodeIdx, entity] : node_to_entity) {
-        const auto& node = asset.nodes[nodeIdx];
-        if (node.parent_index >= 0) {
-            // 如果在 glTF 中有父节点，建立父子关系
-            registry.emplace<ParentEntity>(entity, node_to_entity.at(node.parent_index));
-        } else {
-            // 如果在 glTF 中是根节点，就让它成为我们新创建的 masterRoot 的子节点
-            registry.emplace<ParentEntity>(entity, masterRoot);
+        // --- 3. 建立实体间的父子层级关系 ---
+        for (const auto& [nodeIdx, entity] : node_to_entity) {
+            const auto& node = nodes[nodeIdx];
+            if (node.parent_index >= 0) {
+                // 如果在 glTF 中有父节点，建立父子关系
+                registry.emplace<ParentEntity>(entity, node_to_entity.at(node.parent_index));
+            } else {
+                // 如果在 glTF 中是根节点，就让它成为我们新创建的 masterRoot 的子节点
+                registry.emplace<ParentEntity>(entity, masterRoot);
+            }
         }
-    }
 
-    // --- 4. 将动画和骨架组件【统一】附加到总根实体上 ---
-    if (!asset.skeletons.empty()) {
-        SkeletonHandle main_skeleton_handle = asset.skeletons.begin()->first;
-
-        // 在总根上创建骨架组件
-        auto& skel_comp = registry.emplace<SkeletonComponent>(masterRoot);
-        skel_comp.handle = main_skeleton_handle;
-
-        const auto& skeleton_asset = asset.skeletons.at(main_skeleton_handle);
-        const int num_joints = skeleton_asset->num_joints();
-        const int num_soa_joints = skeleton_asset->num_soa_joints();
-
-        skel_comp.localTransforms.resize(num_soa_joints);
-        skel_comp.modelMatrices.resize(num_joints);
-        skel_comp.finalTransforms.resize(num_soa_joints);
-        skel_comp.skinningMatrices.resize(num_joints, glm::mat4(1.0f));
-        skel_comp.samplingContext = ozz::make_unique<ozz::animation::SamplingJob::Context>(num_joints);
-
-        // 核心：填充骨骼索引 -> 实体的映射表
-        for (int i = 0; i < skeleton_asset->num_joints(); ++i) {
-            std::string joint_name(skeleton_asset->joint_names()[i]);
-            if (name_to_entity.count(joint_name)) {
-                skel_comp.joint_entity_map[i] = name_to_entity.at(joint_name);
+        // --- 4. 将动画和骨架组件【统一】附加到总根实体上 ---
+        auto skeletonIt = source.skeleton.has_value() ? asset.skeletons.find(source.skeleton.value()) : asset.skeletons.end();
+        if (skeletonIt != asset.skeletons.end()) {
+            SkeletonHandle main_skeleton_handle = skeletonIt->first;
+
+            // 在总根上创建骨架组件
+            auto& skel_comp = registry.emplace<SkeletonComponent>(masterRoot);
+            skel_comp.handle = main_skeleton_handle;
+
+            const auto& skeleton_asset = skeletonIt->second;
+            const int num_joints = skeleton_asset->num_joints();
+            const int num_soa_joints = skeleton_asset->num_soa_joints();
+
+            skel_comp.localTransforms.resize(num_soa_joints);
+            skel_comp.modelMatrices.resize(num_joints);
+            skel_comp.finalTransforms.resize(num_soa_joints);
+            skel_comp.skinningMatrices.resize(num_joints, glm::mat4(1.0f));
+            skel_comp.samplingContext = ozz::make_unique<ozz::animation::SamplingJob::Context>(num_joints);
+
+            // 核心：填充骨骼索引 -> 实体的映射表
+            for (int i = 0; i < skeleton_asset->num_joints(); ++i) {
+                std::string joint_name(skeleton_asset->joint_names()[i]);
+                if (name_to_entity.count(joint_name)) {
+                    skel_comp.joint_entity_map[i] = name_to_entity.at(joint_name);
+                }
             }
-        }
 
-        // 为蒙皮网格找到逆绑定矩阵
-        for (const auto& [m_handle, m_data] : asset.meshes) {
-            if (m_data.skeleton.has_value()) {
-                skel_comp.inverseBindPoses = m_data.inverse_bind_poses;
-                break;
+            // 为蒙皮网格找到逆绑定矩阵
+            for (const auto& m_handle : source.meshes) {
+                auto meshIt = asset.meshes.find(m_handle);
+                if (meshIt != asset.meshes.end() && meshIt->second.skeleton.has_value()) {
+                    skel_comp.inverseBindPoses = meshIt->second.inverse_bind_poses;
+                    break;
+                }
             }
-        }
 
-        // 将动画播放器和控制器也附加到总根上
-        auto& multiTrack = registry.emplace<MultiTrackAnimationComponent>(masterRoot);
-        auto& controller = registry.emplace<AnimationControllerComponent>(masterRoot);
-        for (const auto& [handle, anim] : asset.animations) {
-            // 默认播放第一个动画轨道，防止模型加载后静止
-            if (multiTrack.activeTrackCount == 0) {
-                multiTrack.addTrack(handle, 1.0f, AnimationBlendMode::Replace);
+            // 将动画播放器和控制器也附加到总根上
+            auto& multiTrack = registry.emplace<MultiTrackAnimationComponent>(masterRoot);
+            auto& controller = registry.emplace<AnimationControllerComponent>(masterRoot);
+            for (const auto& handle : source.animations) {
+                auto animIt = asset.animations.find(handle);
+                if (animIt == asset.animations.end()) {
+                    continue;
+                }
+                const auto& anim = animIt->second;
+                // 默认播放第一个动画轨道，防止模型加载后静止
+                if (multiTrack.activeTrackCount == 0) {
+                    multiTrack.addTrack(handle, 1.0f, AnimationBlendMode::Replace);
+                }
+                controller.addAnimation(anim.name.c_str(), handle);
             }
-            controller.addAnimation(anim.name.c_str(), handle);
         }
+
+        // --- 5. 标记需要重建变换系统缓存 ---
+        // 注意：这里不再调用静态方法，而是让调用者负责通知变换系统
+        // 或者在下一帧自动检测到层级变化时重建缓存
+
+        return created_entities;
+    }
+
+    // ResourceReferenceComponent销毁时归还引用
+    void releaseResourceReferences(entt::registry& registry, entt::entity entity) {
+        auto& resources = ResourceManager::getInstance();
+        const auto& refs = registry.get<ResourceReferenceComponent>(entity);
+        for (auto handle : refs.meshes) resources.release(handle);
+        for (auto handle : refs.skeletons) resources.release(handle);
+        for (auto handle : refs.animations) resources.release(handle);
     }
 
-    // --- 5. 标记需要重建变换系统缓存 ---
-    // 注意：这里不再调用静态方法，而是让调用者负责通知变换系统
-    // 或者在下一帧自动检测到层级变化时重建缓存
+} // namespace
+
+std::vector<entt::entity> EntityFactory::createAnimatedModelFromAsset(entt::registry& registry, const ProcessedAsset& asset,
+                                                                      int modelIndex) {
+    ModelSource source;
+    source.nodes = &asset.nodes;
+    if (!asset.skeletons.empty()) {
+        source.skeleton = asset.skeletons.begin()->first;
+    }
+    for (const auto& [handle, mesh] : asset.meshes) {
+        source.meshes.push_back(handle);
+    }
+    for (const auto& [handle, anim] : asset.animations) {
+        source.animations.push_back(handle);
+    }
+    return createAnimatedModel(registry, asset, source, modelIndex);
+}
+
+std::vector<entt::entity> EntityFactory::createAnimatedModelFromPack(entt::registry& registry, PackHandle pack,
+                                                                     int modelIndex) {
+    const auto* packData = ResourceManager::getInstance().getPack(pack);
+    if (!packData || packData->state != ResourceManager::PackState::READY) {
+        std::cerr << "错误：资源包无效或尚未加载完成" << std::endl;
+        return {};
+    }
+
+    ModelSource source;
+    source.nodes = &packData->nodes;
+    if (!packData->skeletons.empty()) {
+        source.skeleton = packData->skeletons.front();
+    }
+    source.meshes = packData->meshes;
+    source.animations = packData->animations;
+    auto entities = createAnimatedModel(registry, Renderer::getInstance().getAsset(), source, modelIndex);
+
+    // 组件里保存的句柄各持有一份引用
+    auto& resources = ResourceManager::getInstance();
+    connectResourceReferences(registry);
+    for (auto entity : entities) {
+        ResourceReferenceComponent refs;
+        if (const auto* mesh = registry.try_get<MeshComponent>(entity)) {
+            if (resources.acquire(mesh->handle)) refs.meshes.push_back(mesh->handle);
+        }
+        if (const auto* skeleton = registry.try_get<SkeletonComponent>(entity)) {
+            if (resources.acquire(skeleton->handle)) refs.skeletons.push_back(skeleton->handle);
+        }
+        if (const auto* controller = registry.try_get<AnimationControllerComponent>(entity)) {
+            for (auto handle : controller->animations) {
+                if (resources.acquire(handle)) refs.animations.push_back(handle);
+            }
+        }
+        if (!refs.meshes.empty() || !refs.skeletons.empty() || !refs.animations.empty()) {
+            registry.emplace<ResourceReferenceComponent>(entity, std::move(refs));
+        }
+    }
+    return entities;
+}
 
-    return created_entities;
+void EntityFactory::connectResourceReferences(entt::registry& registry) {
+    // 重复连接同一监听函数不会重复调用
+    registry.on_destroy<ResourceReferenceComponent>().connect<&releaseResourceReferences>();
 }
 
 entt::entity EntityFactory::createInstancedMesh(entt::registry& registry, MeshHandle meshHandle) {
@@ -2,6 +2,7 @@
 
 #include "GltfTools/GltfTools.h"
 #include "GltfTools/AssetSerializer.h"
+#include "ShaderProgram.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -53,7 +54,7 @@ struct RenderCommand {
         const MeshData* mesh;
         const MeshData::SubMesh* submesh;
         glm::mat4 modelMatrix;
-        MaterialHandle material;
+        uint32_t materialIndex = 0;   // 稠密材质索引
         bool wireframe = false;
         float viewSpaceDepth = 0.0f;
     };
@@ -62,7 +63,7 @@ struct RenderCommand {
         const MeshData* mesh;
         const MeshData::SubMesh* submesh;
         const std::vector<glm::mat4>* instanceMatrices;
-        MaterialHandle material;
+        uint32_t materialIndex = 0;   // 稠密材质索引
     };
 
     struct SetBonesData {
@@ -71,7 +72,7 @@ struct RenderCommand {
     };
 
     struct SetUniformData {
-        std::string name;
+        UniformId uniform = UniformId::Count;  // 预解析的uniform ID
         enum Type { MAT4, VEC3, VEC4, FLOAT, INT } type;
 
         glm::mat4 mat4Value{1.0f};
@@ -96,15 +97,15 @@ struct RenderCommand {
 
     // 静态工厂方法
     static RenderCommand DrawMesh(const MeshData* mesh, const MeshData::SubMesh* submesh,
-                                  const glm::mat4& model, MaterialHandle mat, float depth, bool wireframe = false);
+                                  const glm::mat4& model, uint32_t materialIndex, float depth, bool wireframe = false);
     static RenderCommand DrawInstancedMesh(const MeshData* mesh, const MeshData::SubMesh* submesh,
-                                           const std::vector<glm::mat4>* instances, MaterialHandle mat);
+                                           const std::vector<glm::mat4>* instances, uint32_t materialIndex);
     static RenderCommand SetBones(const std::vector<glm::mat4>* bones, int count);
-    static RenderCommand SetUniformMat4(const std::string& name, const glm::mat4& value);
-    static RenderCommand SetUniformVec3(const std::string& name, const glm::vec3& value);
-    static RenderCommand SetUniformVec4(const std::string& name, const glm::vec4& value);
-    static RenderCommand SetUniformFloat(const std::string& name, float value);
-    static RenderCommand SetUniformInt(const std::string& name, int value);
+    static RenderCommand SetUniformMat4(UniformId uniform, const glm::mat4& value);
+    static RenderCommand SetUniformVec3(UniformId uniform, const glm::vec3& value);
+    static RenderCommand SetUniformVec4(UniformId uniform, const glm::vec4& value);
+    static RenderCommand SetUniformFloat(UniformId uniform, float value);
+    static RenderCommand SetUniformInt(UniformId uniform, int value);
 };
 
 // =========================================================================
@@ -244,6 +245,13 @@ struct TextureComponent {
     TextureHandle handle;
 };
 
+// 实体对ResourceManager资源持有的引用：创建时acquire，组件销毁（on_destroy）时release
+struct ResourceReferenceComponent {
+    std::vector<MeshHandle> meshes;
+    std::vector<SkeletonHandle> skeletons;
+    std::vector<AnimationHandle> animations;
+};
+
 struct CameraComponent {
     glm::vec3 target{0.0f, 0.5f, 0.0f};
     float distance = 4.0f;
@@ -308,6 +316,23 @@ struct InstancedMeshComponent {
 
 struct InstanceSourceComponent {};
 
+// 静态合批结果（README 8.5）：合并网格已是世界空间，包围盒用于按块剔除
+struct StaticBatchComponent {
+    // 每个源子网格在合并索引缓冲中的范围
+    struct SourceRange {
+        entt::entity source = entt::null;
+        uint32_t indexOffset = 0;
+        uint32_t indexCount = 0;
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+    };
+
+    glm::vec3 boundsMin{0.0f};
+    glm::vec3 boundsMax{0.0f};
+    glm::ivec3 chunk{0};
+    std::vector<SourceRange> sources;
+};
+
 // 新增一个Tag，用于标记当前玩家可以控制的角色
 struct ControllableCharacterTag {};
 
@@ -360,6 +385,15 @@ public:
                                                                   const ProcessedAsset& asset,
                                                                   int modelIndex = 0);
 
+    // 从ResourceManager加载的资源包创建模型实例，同一个包可以创建多次；
+    // 实体引用的网格、骨架和动画各acquire一次，实体销毁时释放，卸载资源包不会回收仍在使用的资源
+    static std::vector<entt::entity> createAnimatedModelFromPack(entt::registry& registry,
+                                                                 PackHandle pack,
+                                                                 int modelIndex = 0);
+
+    // 让ResourceReferenceComponent销毁时归还其中的引用；添加该组件前调用，可重复调用
+    static void connectResourceReferences(entt::registry& registry);
+
     static entt::entity createInstancedMesh(entt::registry& registry, MeshHandle meshHandle);
 
     static entt::entity createInstanceSource(entt::registry& registry,
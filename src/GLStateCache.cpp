@@ -0,0 +1,211 @@
+#include "GLStateCache.h"
+
+// =========================================================================
+// GLStateCache 实现
+// =========================================================================
+
+void GLStateCache::invalidate() {
+    program = UNKNOWN;
+    vertexArray = UNKNOWN;
+    activeTextureUnit = UNKNOWN;
+    textureUnits.fill(UNKNOWN);
+    arrayBuffer = UNKNOWN;
+    uniformBuffer = UNKNOWN;
+    vertexArrayStates.clear();
+
+    blend = Toggle::Unknown;
+    depthTest = Toggle::Unknown;
+    depthWrite = Toggle::Unknown;
+    cullFace = Toggle::Unknown;
+    blendSrc = UNKNOWN;
+    blendDst = UNKNOWN;
+    depthFunc = UNKNOWN;
+    cullMode = UNKNOWN;
+    frontFace = UNKNOWN;
+}
+
+void GLStateCache::useProgram(GLuint newProgram) {
+    if (filter(program == newProgram)) return;
+    program = newProgram;
+    glUseProgram(newProgram);
+}
+
+void GLStateCache::bindVertexArray(GLuint vao) {
+    if (filter(vertexArray == vao)) return;
+    vertexArray = vao;
+    glBindVertexArray(vao);
+}
+
+void GLStateCache::setActiveTextureUnit(uint32_t unit) {
+    if (filter(activeTextureUnit == unit)) return;
+    activeTextureUnit = unit;
+    glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLStateCache::bindTexture2D(uint32_t unit, GLuint texture) {
+    if (unit >= MAX_TEXTURE_UNITS) {
+        stats.issued += 2;
+        activeTextureUnit = unit;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        return;
+    }
+
+    if (filter(textureUnits[unit] == texture)) return;
+    // 只有真正需要换绑定时才切换活动单元
+    setActiveTextureUnit(unit);
+    textureUnits[unit] = texture;
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GLStateCache::bindBuffer(GLenum target, GLuint buffer) {
+    switch (target) {
+        case GL_ARRAY_BUFFER:
+            if (filter(arrayBuffer == buffer)) return;
+            arrayBuffer = buffer;
+            break;
+        case GL_UNIFORM_BUFFER:
+            if (filter(uniformBuffer == buffer)) return;
+            uniformBuffer = buffer;
+            break;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            if (vertexArray != UNKNOWN) {
+                auto& state = currentVertexArrayState();
+                if (filter(state.elementBufferKnown && state.elementBuffer == buffer)) return;
+                state.elementBuffer = buffer;
+                state.elementBufferKnown = true;
+            } else {
+                stats.issued++;
+            }
+            break;
+        default:
+            stats.issued++;
+            break;
+    }
+    glBindBuffer(target, buffer);
+}
+
+void GLStateCache::enableVertexAttrib(uint32_t index) {
+    if (vertexArray == UNKNOWN || index >= MAX_VERTEX_ATTRIBS) {
+        stats.issued++;
+        glEnableVertexAttribArray(index);
+        return;
+    }
+
+    auto& state = currentVertexArrayState();
+    uint32_t bit = 1u << index;
+    if (filter((state.knownMask & bit) && (state.enabledMask & bit))) return;
+    state.knownMask |= bit;
+    state.enabledMask |= bit;
+    glEnableVertexAttribArray(index);
+}
+
+void GLStateCache::disableVertexAttrib(uint32_t index) {
+    if (vertexArray == UNKNOWN || index >= MAX_VERTEX_ATTRIBS) {
+        stats.issued++;
+        glDisableVertexAttribArray(index);
+        return;
+    }
+
+    auto& state = currentVertexArrayState();
+    uint32_t bit = 1u << index;
+    if (filter((state.knownMask & bit) && !(state.enabledMask & bit))) return;
+    state.knownMask |= bit;
+    state.enabledMask &= ~bit;
+    glDisableVertexAttribArray(index);
+}
+
+void GLStateCache::vertexAttribDivisor(uint32_t index, uint32_t divisor) {
+    if (vertexArray == UNKNOWN || index >= MAX_VERTEX_ATTRIBS) {
+        stats.issued++;
+        glVertexAttribDivisor(index, divisor);
+        return;
+    }
+
+    auto& state = currentVertexArrayState();
+    uint32_t bit = 1u << index;
+    if (filter((state.knownDivisorMask & bit) && state.divisors[index] == divisor)) return;
+    state.knownDivisorMask |= bit;
+    state.divisors[index] = divisor;
+    glVertexAttribDivisor(index, divisor);
+}
+
+void GLStateCache::setToggle(Toggle& shadow, GLenum cap, bool enabled) {
+    Toggle wanted = enabled ? Toggle::On : Toggle::Off;
+    if (filter(shadow == wanted)) return;
+    shadow = wanted;
+    if (enabled) {
+        glEnable(cap);
+    } else {
+        glDisable(cap);
+    }
+}
+
+void GLStateCache::setBlend(bool enabled) {
+    setToggle(blend, GL_BLEND, enabled);
+}
+
+void GLStateCache::setBlendFunc(GLenum src, GLenum dst) {
+    if (filter(blendSrc == src && blendDst == dst)) return;
+    blendSrc = src;
+    blendDst = dst;
+    glBlendFunc(src, dst);
+}
+
+void GLStateCache::setDepthTest(bool enabled) {
+    setToggle(depthTest, GL_DEPTH_TEST, enabled);
+}
+
+void GLStateCache::setDepthWrite(bool enabled) {
+    Toggle wanted = enabled ? Toggle::On : Toggle::Off;
+    if (filter(depthWrite == wanted)) return;
+    depthWrite = wanted;
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void GLStateCache::setDepthFunc(GLenum func) {
+    if (filter(depthFunc == func)) return;
+    depthFunc = func;
+    glDepthFunc(func);
+}
+
+void GLStateCache::setCullFace(bool enabled) {
+    setToggle(cullFace, GL_CULL_FACE, enabled);
+}
+
+void GLStateCache::setCullMode(GLenum mode) {
+    if (filter(cullMode == mode)) return;
+    cullMode = mode;
+    glCullFace(mode);
+}
+
+void GLStateCache::setFrontFace(GLenum mode) {
+    if (filter(frontFace == mode)) return;
+    frontFace = mode;
+    glFrontFace(mode);
+}
+
+void GLStateCache::onVertexArrayDeleted(GLuint vao) {
+    vertexArrayStates.erase(vao);
+    if (vertexArray == vao) {
+        vertexArray = 0;
+    }
+}
+
+void GLStateCache::onBufferDeleted(GLuint buffer) {
+    if (arrayBuffer == buffer) arrayBuffer = 0;
+    if (uniformBuffer == buffer) uniformBuffer = 0;
+    for (auto& [vao, state] : vertexArrayStates) {
+        if (state.elementBufferKnown && state.elementBuffer == buffer) {
+            state.elementBuffer = 0;
+        }
+    }
+}
+
+void GLStateCache::onTextureDeleted(GLuint texture) {
+    for (auto& unit : textureUnits) {
+        if (unit == texture) {
+            unit = 0;
+        }
+    }
+}
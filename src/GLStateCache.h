@@ -0,0 +1,124 @@
+#pragma once
+
+#include "glad/glad.h"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+// =========================================================================
+// GL状态缓存 - 影子记录已绑定的状态，只把真正的变化交给驱动
+// =========================================================================
+
+/**
+ * 轻量GL状态跟踪层
+ * 职责：记录程序、VAO、纹理单元、缓冲绑定、混合/深度/剔除状态以及顶点属性
+ *      开关和divisor；重复设置时直接过滤，不产生GL调用。
+ * 约定：绘制路径上的所有绑定都必须经过这里，绕过缓存修改状态后需调用invalidate()。
+ */
+class GLStateCache {
+public:
+    static constexpr uint32_t MAX_TEXTURE_UNITS = 16;
+    static constexpr uint32_t MAX_VERTEX_ATTRIBS = 16;
+
+    /**
+     * 调用统计
+     */
+    struct StateStats {
+        uint32_t issued = 0;    // 实际发给驱动的调用
+        uint32_t filtered = 0;  // 被缓存过滤掉的冗余调用
+    };
+
+    GLStateCache() { invalidate(); }
+
+    /**
+     * 把所有影子状态标记为未知，下一次设置必然下发
+     */
+    void invalidate();
+
+    // 程序与VAO
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+
+    // 纹理（仅GL_TEXTURE_2D）
+    void bindTexture2D(uint32_t unit, GLuint texture);
+
+    // 缓冲：ELEMENT_ARRAY_BUFFER属于VAO状态，按当前VAO分别记录
+    void bindBuffer(GLenum target, GLuint buffer);
+
+    // 顶点属性（属于当前VAO的状态）
+    void enableVertexAttrib(uint32_t index);
+    void disableVertexAttrib(uint32_t index);
+    void vertexAttribDivisor(uint32_t index, uint32_t divisor);
+
+    // 固定管线状态
+    void setBlend(bool enabled);
+    void setBlendFunc(GLenum src, GLenum dst);
+    void setDepthTest(bool enabled);
+    void setDepthWrite(bool enabled);
+    void setDepthFunc(GLenum func);
+    void setCullFace(bool enabled);
+    void setCullMode(GLenum mode);
+    void setFrontFace(GLenum mode);
+
+    /**
+     * 对象删除后调用，清除指向它的影子绑定（GL会自动解绑已删除对象）
+     */
+    void onVertexArrayDeleted(GLuint vao);
+    void onBufferDeleted(GLuint buffer);
+    void onTextureDeleted(GLuint texture);
+
+    GLuint getProgram() const { return program; }
+    GLuint getVertexArray() const { return vertexArray; }
+
+    const StateStats& getStats() const { return stats; }
+    void resetStats() { stats = StateStats{}; }
+
+private:
+    // 三态布尔：未知/关/开
+    enum class Toggle : uint8_t { Unknown, Off, On };
+
+    // 每个VAO自己的属性状态
+    struct VertexArrayState {
+        uint32_t enabledMask = 0;
+        uint32_t knownMask = 0;  // enabledMask中哪些位是已知的
+        std::array<uint32_t, MAX_VERTEX_ATTRIBS> divisors{};
+        uint32_t knownDivisorMask = 0;
+        GLuint elementBuffer = 0;
+        bool elementBufferKnown = false;
+    };
+
+    static constexpr GLuint UNKNOWN = 0xFFFFFFFFu;
+
+    bool filter(bool redundant) {
+        if (redundant) {
+            stats.filtered++;
+            return true;
+        }
+        stats.issued++;
+        return false;
+    }
+
+    void setToggle(Toggle& shadow, GLenum cap, bool enabled);
+    void setActiveTextureUnit(uint32_t unit);
+    VertexArrayState& currentVertexArrayState() { return vertexArrayStates[vertexArray]; }
+
+    GLuint program = UNKNOWN;
+    GLuint vertexArray = UNKNOWN;
+    uint32_t activeTextureUnit = UNKNOWN;
+    std::array<GLuint, MAX_TEXTURE_UNITS> textureUnits{};
+    GLuint arrayBuffer = UNKNOWN;
+    GLuint uniformBuffer = UNKNOWN;
+    std::unordered_map<GLuint, VertexArrayState> vertexArrayStates;
+
+    Toggle blend = Toggle::Unknown;
+    Toggle depthTest = Toggle::Unknown;
+    Toggle depthWrite = Toggle::Unknown;
+    Toggle cullFace = Toggle::Unknown;
+    GLenum blendSrc = UNKNOWN;
+    GLenum blendDst = UNKNOWN;
+    GLenum depthFunc = UNKNOWN;
+    GLenum cullMode = UNKNOWN;
+    GLenum frontFace = UNKNOWN;
+
+    StateStats stats;
+};
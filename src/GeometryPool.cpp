@@ -0,0 +1,334 @@
+#include "GeometryPool.h"
+#include "RenderDevice.h"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+using spartan::asset::MeshData;
+using spartan::asset::VertexFormat;
+
+// =========================================================================
+// RangeAllocator 实现
+// =========================================================================
+
+void RangeAllocator::reset(uint32_t newCapacity) {
+    freeBlocks.clear();
+    if (newCapacity > 0) {
+        freeBlocks[0] = newCapacity;
+    }
+    capacity = newCapacity;
+    used = 0;
+}
+
+uint32_t RangeAllocator::allocate(uint32_t count) {
+    if (count == 0) {
+        return INVALID_OFFSET;
+    }
+
+    for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it) {
+        if (it->second < count) continue;
+
+        uint32_t offset = it->first;
+        uint32_t remaining = it->second - count;
+        freeBlocks.erase(it);
+        if (remaining > 0) {
+            freeBlocks[offset + count] = remaining;
+        }
+        used += count;
+        return offset;
+    }
+    return INVALID_OFFSET;
+}
+
+void RangeAllocator::free(uint32_t offset, uint32_t count) {
+    if (count == 0) {
+        return;
+    }
+    used -= count;
+
+    // 与后一个空闲块相接则合并
+    auto next = freeBlocks.lower_bound(offset);
+    if (next != freeBlocks.end() && offset + count == next->first) {
+        count += next->second;
+        next = freeBlocks.erase(next);
+    }
+
+    // 与前一个空闲块相接则并入前一块
+    if (next != freeBlocks.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += count;
+            return;
+        }
+    }
+    freeBlocks[offset] = count;
+}
+
+uint32_t RangeAllocator::getLargestFreeBlock() const {
+    uint32_t largest = 0;
+    for (const auto& [offset, count] : freeBlocks) {
+        largest = std::max(largest, count);
+    }
+    return largest;
+}
+
+// =========================================================================
+// GeometryPool 实现
+// =========================================================================
+
+void GeometryPool::setDefaultPageCapacity(uint32_t vertexCapacity, uint32_t indexCapacity) {
+    defaultVertexCapacity = std::max(vertexCapacity, 1u);
+    defaultIndexCapacity = std::max(indexCapacity, 3u);
+}
+
+uint64_t GeometryPool::computeFormatKey(const VertexFormat& format) {
+    // attribute_map是无序容器，按属性位排序后再哈希，保证相同格式得到相同的键
+    std::vector<std::pair<uint32_t, VertexFormat::AttributeInfo>> attributes;
+    attributes.reserve(format.attribute_map.size());
+    for (const auto& [attribute, info] : format.attribute_map) {
+        attributes.emplace_back(static_cast<uint32_t>(attribute), info);
+    }
+    std::sort(attributes.begin(), attributes.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // FNV-1a
+    uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](uint32_t value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+
+    mix(format.stride);
+    mix(format.quantized ? 1u : 0u);
+    for (const auto& [attribute, info] : attributes) {
+        mix(attribute);
+        mix(info.offset);
+        mix(info.components);
+        mix(info.type);
+        mix(info.normalized ? 1u : 0u);
+    }
+    return hash;
+}
+
+int GeometryPool::createPage(const MeshData& mesh, uint64_t formatKey) {
+    auto& device = RenderDevice::getInstance();
+    auto& state = device.getStateCache();
+
+    // 默认容量放不下的网格单独得到一页刚好够用的缓冲
+    uint32_t vertexCapacity = std::max(defaultVertexCapacity, mesh.vertex_count);
+    uint32_t indexCapacity = std::max(defaultIndexCapacity, mesh.GetIndexCount());
+    if (mesh.index_type == GL_UNSIGNED_SHORT) {
+        // 烘焙后的索引必须仍能用16位表示，且不能碰到图元重启索引0xFFFF
+        vertexCapacity = std::min(vertexCapacity, MeshData::MAX_16BIT_VERTEX_COUNT);
+    }
+
+    Page page;
+    page.formatKey = formatKey;
+    page.indexType = mesh.index_type;
+    page.stride = mesh.format.stride;
+    page.vertices.reset(vertexCapacity);
+    page.indices.reset(indexCapacity);
+
+    // 先清空错误队列，下面的GL_OUT_OF_MEMORY检查只反映本页的分配
+    while (glGetError() != GL_NO_ERROR) {
+    }
+
+    glGenVertexArrays(1, &page.vao);
+    state.bindVertexArray(page.vao);
+
+    glGenBuffers(1, &page.vbo);
+    state.bindBuffer(GL_ARRAY_BUFFER, page.vbo);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexCapacity) * page.stride, nullptr, GL_STATIC_DRAW);
+
+    device.setupVertexAttributes(mesh.format);
+
+    glGenBuffers(1, &page.ibo);
+    state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexCapacity) * mesh.GetIndexSize(),
+                 nullptr, GL_STATIC_DRAW);
+
+    state.bindVertexArray(0);
+
+    if (glGetError() == GL_OUT_OF_MEMORY) {
+        std::cerr << "错误：几何池页分配失败，顶点容量 " << vertexCapacity
+                  << "，索引容量 " << indexCapacity << std::endl;
+        destroyPage(page);
+        return -1;
+    }
+
+    // 复用已销毁页的槽位，网格记录的页索引保持不变
+    for (size_t i = 0; i < pages.size(); ++i) {
+        if (pages[i].vao == 0) {
+            pages[i] = std::move(page);
+            return static_cast<int>(i);
+        }
+    }
+    pages.push_back(std::move(page));
+    return static_cast<int>(pages.size()) - 1;
+}
+
+void GeometryPool::destroyPage(Page& page) {
+    auto& state = RenderDevice::getInstance().getStateCache();
+    if (page.vao) {
+        glDeleteVertexArrays(1, &page.vao);
+        state.onVertexArrayDeleted(page.vao);
+    }
+    if (page.vbo) {
+        glDeleteBuffers(1, &page.vbo);
+        state.onBufferDeleted(page.vbo);
+    }
+    if (page.ibo) {
+        glDeleteBuffers(1, &page.ibo);
+        state.onBufferDeleted(page.ibo);
+    }
+    page = Page();
+}
+
+bool GeometryPool::allocate(MeshData& mesh) {
+    if (mesh.GetVertexDataSize() == 0 || mesh.GetIndexCount() == 0 || mesh.vertex_count == 0) {
+        return false;
+    }
+    if (mesh.index_type == GL_UNSIGNED_SHORT && mesh.vertex_count > MeshData::MAX_16BIT_VERTEX_COUNT) {
+        return false;
+    }
+
+    const uint64_t formatKey = computeFormatKey(mesh.format);
+    const uint32_t indexCount = mesh.GetIndexCount();
+
+    int pageIndex = -1;
+    uint32_t baseVertex = RangeAllocator::INVALID_OFFSET;
+    uint32_t firstIndex = RangeAllocator::INVALID_OFFSET;
+
+    for (size_t i = 0; i < pages.size(); ++i) {
+        auto& page = pages[i];
+        if (page.vao == 0 || page.formatKey != formatKey || page.indexType != mesh.index_type) continue;
+
+        baseVertex = page.vertices.allocate(mesh.vertex_count);
+        if (baseVertex == RangeAllocator::INVALID_OFFSET) continue;
+
+        firstIndex = page.indices.allocate(indexCount);
+        if (firstIndex == RangeAllocator::INVALID_OFFSET) {
+            page.vertices.free(baseVertex, mesh.vertex_count);
+            continue;
+        }
+
+        pageIndex = static_cast<int>(i);
+        break;
+    }
+
+    if (pageIndex < 0) {
+        pageIndex = createPage(mesh, formatKey);
+        if (pageIndex < 0) {
+            return false;
+        }
+        baseVertex = pages[pageIndex].vertices.allocate(mesh.vertex_count);
+        firstIndex = pages[pageIndex].indices.allocate(indexCount);
+    }
+
+    auto& page = pages[pageIndex];
+    auto& state = RenderDevice::getInstance().getStateCache();
+
+    state.bindBuffer(GL_ARRAY_BUFFER, page.vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(baseVertex) * page.stride,
+                    static_cast<GLsizeiptr>(mesh.vertex_count) * page.stride, mesh.GetVertexData());
+
+    // 元素缓冲属于VAO状态，绑定页VAO后再更新
+    state.bindVertexArray(page.vao);
+    state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.ibo);
+    if (page.indexType == GL_UNSIGNED_SHORT) {
+        std::vector<uint16_t> bakedIndices(indexCount);
+        for (uint32_t i = 0; i < indexCount; ++i) {
+            bakedIndices[i] = static_cast<uint16_t>(mesh.GetIndex(i) + baseVertex);
+        }
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(firstIndex) * sizeof(uint16_t),
+                        bakedIndices.size() * sizeof(uint16_t), bakedIndices.data());
+    } else {
+        std::vector<uint32_t> bakedIndices(indexCount);
+        for (uint32_t i = 0; i < indexCount; ++i) {
+            bakedIndices[i] = mesh.GetIndex(i) + baseVertex;
+        }
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(firstIndex) * sizeof(uint32_t),
+                        bakedIndices.size() * sizeof(uint32_t), bakedIndices.data());
+    }
+    state.bindVertexArray(0);
+
+    page.meshCount++;
+
+    mesh.vao = page.vao;
+    mesh.vbo = page.vbo;
+    mesh.ibo = page.ibo;
+    mesh.gpu_pooled = true;
+    mesh.gpu_pool_page = static_cast<uint32_t>(pageIndex);
+    mesh.gpu_base_vertex = baseVertex;
+    mesh.gpu_first_index = firstIndex;
+    mesh.gpu_index_count = indexCount;
+    mesh.data_state = MeshData::SYNCED;
+    return true;
+}
+
+void GeometryPool::release(MeshData& mesh) {
+    if (!mesh.gpu_pooled || mesh.gpu_pool_page >= pages.size()) {
+        return;
+    }
+
+    auto& page = pages[mesh.gpu_pool_page];
+    page.vertices.free(mesh.gpu_base_vertex, mesh.vertex_count);
+    page.indices.free(mesh.gpu_first_index, mesh.gpu_index_count);
+    if (page.meshCount > 0) {
+        page.meshCount--;
+    }
+    if (page.meshCount == 0) {
+        // 空页立即释放GPU缓冲（卸载资源包后不再占用显存），槽位留给之后新建的页
+        destroyPage(page);
+    }
+
+    mesh.vao = 0;
+    mesh.vbo = 0;
+    mesh.ibo = 0;
+    mesh.gpu_pooled = false;
+    mesh.gpu_pool_page = 0;
+    mesh.gpu_base_vertex = 0;
+    mesh.gpu_first_index = 0;
+    mesh.gpu_index_count = 0;
+}
+
+void GeometryPool::cleanup() {
+    for (auto& page : pages) {
+        destroyPage(page);
+    }
+    pages.clear();
+}
+
+GeometryPool::PoolStats GeometryPool::getStats() const {
+    PoolStats stats;
+    for (const auto& page : pages) {
+        if (page.vao == 0) continue;
+        stats.pageCount++;
+        const uint32_t indexSize = page.indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+        stats.meshCount += page.meshCount;
+        stats.vertexBytesUsed += static_cast<uint64_t>(page.vertices.getUsed()) * page.stride;
+        stats.vertexBytesReserved += static_cast<uint64_t>(page.vertices.getCapacity()) * page.stride;
+        stats.indexBytesUsed += static_cast<uint64_t>(page.indices.getUsed()) * indexSize;
+        stats.indexBytesReserved += static_cast<uint64_t>(page.indices.getCapacity()) * indexSize;
+    }
+    return stats;
+}
+
+void GeometryPool::printStats() const {
+    PoolStats stats = getStats();
+    std::cout << "几何池: " << stats.pageCount << " 页, " << stats.meshCount << " 个网格" << std::endl;
+    std::cout << "  顶点缓冲: " << stats.vertexBytesUsed / 1024 << " / "
+              << stats.vertexBytesReserved / 1024 << " KB" << std::endl;
+    std::cout << "  索引缓冲: " << stats.indexBytesUsed / 1024 << " / "
+              << stats.indexBytesReserved / 1024 << " KB" << std::endl;
+
+    for (size_t i = 0; i < pages.size(); ++i) {
+        const auto& page = pages[i];
+        if (page.vao == 0) continue;
+        std::cout << "  页 " << i << ": 步长 " << page.stride
+                  << (page.indexType == GL_UNSIGNED_SHORT ? ", 16位索引" : ", 32位索引")
+                  << ", 网格 " << page.meshCount
+                  << ", 最大空闲顶点块 " << page.vertices.getLargestFreeBlock()
+                  << ", 空闲块数 " << page.vertices.getFreeBlockCount() << std::endl;
+    }
+}
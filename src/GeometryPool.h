@@ -0,0 +1,126 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "GltfTools/GltfTools.h"
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// =========================================================================
+// 几何池 - 相同顶点格式的网格共享大块VBO/IBO，每种格式一个VAO
+// =========================================================================
+
+/**
+ * 区间分配器
+ * 以元素为单位管理一段连续空间，空闲块按起始位置有序保存，释放时与相邻空闲块合并
+ */
+class RangeAllocator {
+public:
+    static constexpr uint32_t INVALID_OFFSET = 0xFFFFFFFFu;
+
+    void reset(uint32_t newCapacity);
+
+    /**
+     * 首次适配分配
+     * @return 起始位置，空间不足返回INVALID_OFFSET
+     */
+    uint32_t allocate(uint32_t count);
+
+    void free(uint32_t offset, uint32_t count);
+
+    uint32_t getCapacity() const { return capacity; }
+    uint32_t getUsed() const { return used; }
+    uint32_t getLargestFreeBlock() const;
+    size_t getFreeBlockCount() const { return freeBlocks.size(); }
+
+private:
+    std::map<uint32_t, uint32_t> freeBlocks;  // 起始位置 -> 长度
+    uint32_t capacity = 0;
+    uint32_t used = 0;
+};
+
+/**
+ * GPU几何池
+ * 职责：把顶点格式和索引类型相同的网格子分配进同一组大缓冲（页），
+ *      基础顶点在上传时烘焙进索引，连续绘制不同网格不需要切换VAO。
+ * 约定：池中网格的vao/vbo/ibo属于页，只能通过release()归还，不能直接删除。
+ */
+class GeometryPool {
+public:
+    static GeometryPool& getInstance() {
+        static GeometryPool instance;
+        return instance;
+    }
+
+    /**
+     * 池使用统计
+     */
+    struct PoolStats {
+        uint32_t pageCount = 0;
+        uint32_t meshCount = 0;
+        uint64_t vertexBytesUsed = 0;
+        uint64_t vertexBytesReserved = 0;
+        uint64_t indexBytesUsed = 0;
+        uint64_t indexBytesReserved = 0;
+    };
+
+    void setEnabled(bool value) { enabled = value; }
+    bool isEnabled() const { return enabled; }
+
+    /**
+     * 设置新建页的默认容量（16位索引页的顶点容量始终不超过MAX_16BIT_VERTEX_COUNT）
+     */
+    void setDefaultPageCapacity(uint32_t vertexCapacity, uint32_t indexCapacity);
+
+    /**
+     * 把网格上传到池中，成功后写入网格的vao/vbo/ibo和gpu_*字段
+     * @return 网格为空或缓冲创建失败时返回false，调用方可回退到独立缓冲
+     */
+    bool allocate(spartan::asset::MeshData& mesh);
+
+    /**
+     * 归还网格占用的区间（GPU数据不清零，只是可被复用），页中最后一个网格归还时删除整页
+     */
+    void release(spartan::asset::MeshData& mesh);
+
+    /**
+     * 删除所有页的GL对象
+     */
+    void cleanup();
+
+    PoolStats getStats() const;
+    void printStats() const;
+
+private:
+    GeometryPool() = default;
+    ~GeometryPool() = default;
+
+    // 一页：一组VBO/IBO及绑定了它们的VAO
+    struct Page {
+        uint64_t formatKey = 0;
+        GLenum indexType = GL_UNSIGNED_INT;
+        uint32_t stride = 0;
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLuint ibo = 0;
+        RangeAllocator vertices;
+        RangeAllocator indices;
+        uint32_t meshCount = 0;
+    };
+
+    static uint64_t computeFormatKey(const spartan::asset::VertexFormat& format);
+
+    /**
+     * 新建一页，容量至少能容纳给定网格
+     * @return 页索引，失败返回-1
+     */
+    int createPage(const spartan::asset::MeshData& mesh, uint64_t formatKey);
+
+    // 删除页的GL对象并清空页（vao为0表示空槽位）
+    void destroyPage(Page& page);
+
+    std::vector<Page> pages;
+    bool enabled = false;
+    uint32_t defaultVertexCapacity = spartan::asset::MeshData::MAX_16BIT_VERTEX_COUNT;
+    uint32_t defaultIndexCapacity = spartan::asset::MeshData::MAX_16BIT_VERTEX_COUNT * 6;
+};
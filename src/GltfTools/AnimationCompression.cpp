@@ -0,0 +1,157 @@
+#include "AnimationCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "ozz/animation/offline/animation_optimizer.h"
+#include "ozz/animation/offline/raw_animation_utils.h"
+#include "ozz/base/maths/transform.h"
+#include "ozz/base/span.h"
+
+namespace spartan {
+    namespace asset {
+
+        namespace {
+
+            using ozz::animation::offline::AnimationOptimizer;
+            using ozz::animation::offline::RawAnimation;
+
+            // 旋转/缩放误差在距离d处表现为约d*角度、d*缩放差的位移，d取足够大时两者也受位置容差约束
+            float ErrorDistance(const ProcessConfig& config, float tolerance) {
+                float distance = config.animation_error_distance;
+                if (config.animation_rotation_tolerance > 0.0f) {
+                    distance = std::max(distance, tolerance / config.animation_rotation_tolerance);
+                }
+                if (config.animation_scale_tolerance > 0.0f) {
+                    distance = std::max(distance, tolerance / config.animation_scale_tolerance);
+                }
+                return distance;
+            }
+
+            size_t CountKeys(const RawAnimation& animation) {
+                size_t keys = 0;
+                for (const auto& track : animation.tracks) {
+                    keys += track.translations.size() + track.rotations.size() + track.scales.size();
+                }
+                return keys;
+            }
+
+            size_t KeyBytes(const RawAnimation& animation) {
+                size_t bytes = 0;
+                for (const auto& track : animation.tracks) {
+                    bytes += track.translations.size() * sizeof(RawAnimation::TranslationKey) +
+                             track.rotations.size() * sizeof(RawAnimation::RotationKey) +
+                             track.scales.size() * sizeof(RawAnimation::ScaleKey);
+                }
+                return bytes;
+            }
+
+            float PositionError(const ozz::math::Float3& a, const ozz::math::Float3& b) {
+                return ozz::math::Length(a - b);
+            }
+
+            // q和-q表示同一旋转，取绝对值
+            float RotationError(const ozz::math::Quaternion& a, const ozz::math::Quaternion& b) {
+                const float dot = std::min(1.0f, std::abs(ozz::math::Dot(a, b)));
+                return 2.0f * std::acos(dot);
+            }
+
+            float ScaleError(const ozz::math::Float3& a, const ozz::math::Float3& b) {
+                return std::max({std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z)});
+            }
+
+        } // namespace
+
+        bool OptimizeRawAnimation(const RawAnimation& input, const ozz::animation::Skeleton& skeleton,
+                                  const ProcessConfig& config, RawAnimation& output) {
+            AnimationOptimizer optimizer;
+            const float tolerance = config.animation_position_tolerance;
+            optimizer.setting = AnimationOptimizer::Setting(tolerance, ErrorDistance(config, tolerance));
+
+            if (!config.animation_joint_tolerances.empty()) {
+                const auto names = skeleton.joint_names();
+                for (int joint = 0; joint < skeleton.num_joints(); ++joint) {
+                    auto it = config.animation_joint_tolerances.find(names[joint]);
+                    if (it != config.animation_joint_tolerances.end()) {
+                        optimizer.joints_setting_override[joint] =
+                                AnimationOptimizer::Setting(it->second, ErrorDistance(config, it->second));
+                    }
+                }
+            }
+
+            return optimizer(input, skeleton, &output);
+        }
+
+        AnimationErrorStats MeasureAnimationError(const RawAnimation& reference, const RawAnimation& optimized) {
+            AnimationErrorStats stats;
+            const int track_count = reference.num_tracks();
+            if (track_count == 0 || optimized.num_tracks() != track_count) {
+                return stats;
+            }
+
+            std::vector<ozz::math::Transform> expected(track_count);
+            std::vector<ozz::math::Transform> actual(track_count);
+            for (float time : ozz::animation::offline::ExtractTimePoints(reference)) {
+                if (!ozz::animation::offline::SampleAnimation(reference, time, ozz::make_span(expected)) ||
+                    !ozz::animation::offline::SampleAnimation(optimized, time, ozz::make_span(actual))) {
+                    break;
+                }
+                for (int joint = 0; joint < track_count; ++joint) {
+                    stats.max_position_error = std::max(stats.max_position_error,
+                                                        PositionError(expected[joint].translation,
+                                                                      actual[joint].translation));
+                    stats.max_rotation_error = std::max(stats.max_rotation_error,
+                                                        RotationError(expected[joint].rotation,
+                                                                      actual[joint].rotation));
+                    stats.max_scale_error = std::max(stats.max_scale_error,
+                                                     ScaleError(expected[joint].scale, actual[joint].scale));
+                }
+            }
+            return stats;
+        }
+
+        bool CompressRawAnimation(RawAnimation& animation, const ozz::animation::Skeleton& skeleton,
+                                  const ProcessConfig& config, AnimationCompressionStats& stats) {
+            stats = AnimationCompressionStats();
+            stats.keys_before = stats.keys_after = CountKeys(animation);
+            stats.bytes_before = stats.bytes_after = KeyBytes(animation);
+            if (!config.compress_animations) {
+                return false;
+            }
+
+            RawAnimation optimized;
+            if (!OptimizeRawAnimation(animation, skeleton, config, optimized)) {
+                return false;
+            }
+
+            stats.keys_after = CountKeys(optimized);
+            stats.bytes_after = KeyBytes(optimized);
+            stats.error = MeasureAnimationError(animation, optimized);
+            animation = std::move(optimized);
+            return true;
+        }
+
+        std::string FormatAnimationCompressionStats(const AnimationCompressionStats& stats) {
+            const double ratio = stats.bytes_before > 0
+                                 ? 100.0 * static_cast<double>(stats.bytes_after) / static_cast<double>(stats.bytes_before)
+                                 : 100.0;
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(1)
+                << "关键帧 " << stats.keys_before << " -> " << stats.keys_after
+                << ", 数据 " << stats.bytes_before / 1024.0 << " KB -> " << stats.bytes_after / 1024.0 << " KB"
+                << " (" << ratio << "%)";
+            if (stats.runtime_bytes > 0) {
+                out << ", 运行时 " << stats.runtime_bytes / 1024.0 << " KB";
+            }
+            out << std::setprecision(5)
+                << ", 最大误差 位置 " << stats.error.max_position_error
+                << " 旋转 " << stats.error.max_rotation_error
+                << " 缩放 " << stats.error.max_scale_error;
+            return out.str();
+        }
+
+    } // namespace asset
+} // namespace spartan
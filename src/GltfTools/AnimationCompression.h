@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "GltfTools.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/runtime/skeleton.h"
+
+namespace spartan {
+    namespace asset {
+
+// 压缩后与原始曲线的最大误差（关节局部空间，在原始关键帧时间点上比较）
+        struct AnimationErrorStats {
+            float max_position_error = 0.0f;  // 米
+            float max_rotation_error = 0.0f;  // 弧度
+            float max_scale_error = 0.0f;     // 各分量差的最大值
+        };
+
+// 单个剪辑的压缩统计
+        struct AnimationCompressionStats {
+            size_t keys_before = 0;
+            size_t keys_after = 0;
+            size_t bytes_before = 0;   // 关键帧数据字节数
+            size_t bytes_after = 0;
+            size_t runtime_bytes = 0;  // 构建后的ozz::animation::Animation大小，由调用方填写
+            AnimationErrorStats error;
+        };
+
+        /**
+         * 用ozz::animation::offline::AnimationOptimizer删除可由插值得到的关键帧
+         * ozz的误差沿关节层级累积，并在离关节setting.distance处测量（模拟对蒙皮顶点的影响），
+         * 位置容差直接作为setting.tolerance；测量距离取
+         * max(animation_error_distance, 位置容差/旋转容差, 位置容差/缩放容差)，
+         * 使单个关节的旋转/缩放误差同样不超过对应的容差。
+         * animation_joint_tolerances按关节名覆盖位置容差（写入joints_setting_override）。
+         * @return 优化失败时返回false，output被重置
+         */
+        bool OptimizeRawAnimation(const ozz::animation::offline::RawAnimation& input,
+                                  const ozz::animation::Skeleton& skeleton,
+                                  const ProcessConfig& config,
+                                  ozz::animation::offline::RawAnimation& output);
+
+        /**
+         * 在reference的所有关键帧时间点上采样两份动画，统计各关节局部变换的最大误差
+         */
+        AnimationErrorStats MeasureAnimationError(const ozz::animation::offline::RawAnimation& reference,
+                                                  const ozz::animation::offline::RawAnimation& optimized);
+
+        /**
+         * config.compress_animations开启时优化animation（原地替换）并统计压缩前后的大小和误差；
+         * 关闭或优化失败时animation保持不变，stats只记录原始大小
+         * @return 是否做了压缩
+         */
+        bool CompressRawAnimation(ozz::animation::offline::RawAnimation& animation,
+                                  const ozz::animation::Skeleton& skeleton,
+                                  const ProcessConfig& config,
+                                  AnimationCompressionStats& stats);
+
+        /**
+         * 单行压缩报告："关键帧 a -> b, 数据 x KB -> y KB, 最大误差 ..."
+         */
+        std::string FormatAnimationCompressionStats(const AnimationCompressionStats& stats);
+
+    } // namespace asset
+} // namespace spartan
@@ -0,0 +1,288 @@
+#include "AssetCache.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+// 禁用json.hpp的警告
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-literal-operator"
+#endif
+#include "json.hpp"
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+namespace spartan {
+    namespace asset {
+
+        namespace {
+
+            // 不存在的依赖文件的哈希值（"MISSING!"）
+            constexpr uint64_t MISSING_FILE_HASH = 0x4D495353494E4721ull;
+
+            constexpr uint32_t GLB_MAGIC = 0x46546C67;       // 'glTF'
+            constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;  // 'JSON'
+
+            uint64_t HashString(const std::string& str) {
+                return HashBytes64(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+            }
+
+            uint64_t FloatBits(float value) {
+                uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                return bits;
+            }
+
+            // 逐字段加入影响输出的配置（不直接哈希结构体，避免填充字节）；并行导入的输出与串行一致，不参与
+            void AppendConfig(std::vector<uint64_t>& parts, const ProcessConfig& config) {
+                parts.push_back(config.merge_meshes_by_material);
+                parts.push_back(config.generate_tangents);
+                parts.push_back(config.optimize_vertex_cache);
+                parts.push_back(config.optimize_overdraw);
+                parts.push_back(FloatBits(config.overdraw_acmr_threshold));
+                parts.push_back(config.optimize_vertex_fetch);
+                parts.push_back(config.quantize_vertices);
+                parts.push_back(config.use_16bit_indices);
+                parts.push_back(FloatBits(config.vertex_position_epsilon));
+                parts.push_back(FloatBits(config.vertex_normal_epsilon));
+
+                parts.push_back(config.compress_textures);
+                parts.push_back(config.generate_mipmaps);
+                parts.push_back(config.max_texture_size);
+
+                parts.push_back(config.compress_animations);
+                parts.push_back(FloatBits(config.animation_position_tolerance));
+                parts.push_back(FloatBits(config.animation_rotation_tolerance));
+                parts.push_back(FloatBits(config.animation_scale_tolerance));
+                parts.push_back(FloatBits(config.animation_error_distance));
+                // 关节覆盖按名字排序，与unordered_map的遍历顺序无关
+                std::vector<std::pair<std::string, float>> joint_tolerances(config.animation_joint_tolerances.begin(),
+                                                                            config.animation_joint_tolerances.end());
+                std::sort(joint_tolerances.begin(), joint_tolerances.end());
+                parts.push_back(joint_tolerances.size());
+                for (const auto& [name, tolerance] : joint_tolerances) {
+                    parts.push_back(HashString(name));
+                    parts.push_back(FloatBits(tolerance));
+                }
+
+                parts.push_back(config.max_bones_per_vertex);
+                parts.push_back(config.max_morph_targets);
+                parts.push_back(config.enable_gpu_skinning);
+                parts.push_back(config.enable_instancing);
+            }
+
+            // glTF的JSON部分；.glb取第一个块（规范要求为JSON块）
+            bool ExtractJson(const uint8_t* data, size_t size, const char*& json, size_t& json_size) {
+                uint32_t magic = 0;
+                if (size >= sizeof(magic)) {
+                    std::memcpy(&magic, data, sizeof(magic));
+                }
+                if (magic != GLB_MAGIC) {
+                    json = reinterpret_cast<const char*>(data);
+                    json_size = size;
+                    return true;
+                }
+
+                // 12字节文件头 + 8字节块头
+                uint32_t chunk_length = 0;
+                uint32_t chunk_type = 0;
+                if (size < 20) return false;
+                std::memcpy(&chunk_length, data + 12, sizeof(chunk_length));
+                std::memcpy(&chunk_type, data + 16, sizeof(chunk_type));
+                if (chunk_type != GLB_CHUNK_JSON || chunk_length > size - 20) return false;
+                json = reinterpret_cast<const char*>(data + 20);
+                json_size = chunk_length;
+                return true;
+            }
+
+            // URI中的%XX转义
+            std::string DecodeUri(const std::string& uri) {
+                std::string decoded;
+                decoded.reserve(uri.size());
+                for (size_t i = 0; i < uri.size(); ++i) {
+                    if (uri[i] == '%' && i + 2 < uri.size() &&
+                        std::isxdigit(static_cast<unsigned char>(uri[i + 1])) &&
+                        std::isxdigit(static_cast<unsigned char>(uri[i + 2]))) {
+                        decoded.push_back(static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16)));
+                        i += 2;
+                    } else {
+                        decoded.push_back(uri[i]);
+                    }
+                }
+                return decoded;
+            }
+
+            // 外部缓冲和图像的URI（内嵌的data URI已包含在源文件内容中）
+            std::vector<std::string> CollectExternalUris(const char* json, size_t json_size) {
+                std::vector<std::string> uris;
+                nlohmann::json document = nlohmann::json::parse(json, json + json_size, nullptr, false);
+                if (document.is_discarded() || !document.is_object()) {
+                    return uris;
+                }
+                for (const char* array_name : {"buffers", "images"}) {
+                    auto array = document.find(array_name);
+                    if (array == document.end() || !array->is_array()) continue;
+                    for (const auto& item : *array) {
+                        auto uri = item.find("uri");
+                        if (uri == item.end() || !uri->is_string()) continue;
+                        const std::string& value = uri->get_ref<const std::string&>();
+                        if (value.compare(0, 5, "data:") != 0) {
+                            uris.push_back(DecodeUri(value));
+                        }
+                    }
+                }
+                return uris;
+            }
+
+        } // namespace
+
+        AssetCache::AssetCache(const std::string& directory)
+                : directory_(directory) {
+        }
+
+        bool AssetCache::ComputeKey(const char* gltf_path, const ProcessConfig& config, uint64_t& key) {
+            auto start = std::chrono::high_resolution_clock::now();
+
+            MappedFile source;
+            if (!source.Open(gltf_path)) {
+                SetError(source.GetLastError());
+                return false;
+            }
+
+            std::vector<uint64_t> parts;
+            parts.push_back(COOKER_VERSION);
+            parts.push_back(AssetFileHeader::VERSION);
+            AppendConfig(parts, config);
+            parts.push_back(HashBytes64(source.Data(), source.Size()));
+
+            // 依赖按出现顺序加入：URI本身和文件内容
+            const char* json = nullptr;
+            size_t json_size = 0;
+            if (ExtractJson(source.Data(), source.Size(), json, json_size)) {
+                const std::filesystem::path base = std::filesystem::path(gltf_path).parent_path();
+                for (const std::string& uri : CollectExternalUris(json, json_size)) {
+                    parts.push_back(HashString(uri));
+                    MappedFile dependency;
+                    const std::string path = (base / std::filesystem::u8path(uri)).string();
+                    parts.push_back(dependency.Open(path.c_str())
+                                    ? HashBytes64(dependency.Data(), dependency.Size())
+                                    : MISSING_FILE_HASH);
+                }
+            }
+
+            key = HashBytes64(reinterpret_cast<const uint8_t*>(parts.data()), parts.size() * sizeof(uint64_t));
+            stats_.hash_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - start).count();
+            return true;
+        }
+
+        bool AssetCache::Load(const char* gltf_path, const ProcessConfig& config, ProcessedAsset& asset,
+                              const GltfProcessor::ProgressCallback& progress) {
+            uint64_t key = 0;
+            const bool has_key = ComputeKey(gltf_path, config, key);
+            auto start = std::chrono::high_resolution_clock::now();
+
+            std::string cache_path;
+            if (has_key) {
+                cache_path = GetCachePath(gltf_path, key);
+                std::error_code ec;
+                if (std::filesystem::exists(cache_path, ec)) {
+                    // 网格直接引用映射的缓存文件，Renderer::uploadMesh上传后释放映射视图，不再复制CPU数据
+                    AssetSerializer serializer;
+                    serializer.SetZeroCopyMeshesEnabled(true);
+                    if (serializer.DeserializeFromFile(asset, cache_path.c_str())) {
+                        stats_.hits++;
+                        stats_.load_ms = std::chrono::duration<double, std::milli>(
+                                std::chrono::high_resolution_clock::now() - start).count();
+                        std::cout << "资产缓存命中: " << cache_path << " (哈希 " << stats_.hash_ms
+                                  << " ms, 加载 " << stats_.load_ms << " ms)" << std::endl;
+                        return true;
+                    }
+                    std::cerr << "资产缓存文件无效，重新处理: " << cache_path << " ("
+                              << serializer.GetLastError() << ")" << std::endl;
+                    std::remove(cache_path.c_str());
+                    stats_.rejected++;
+                }
+            }
+
+            stats_.misses++;
+            GltfProcessor processor(config);
+            if (progress) {
+                processor.SetProgressCallback(progress);
+            }
+            if (!processor.ProcessFile(gltf_path, asset)) {
+                SetError(processor.GetLastError());
+                return false;
+            }
+            stats_.load_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - start).count();
+
+            if (!has_key) {
+                return true;
+            }
+
+            // 先写临时文件再改名，中断的写入不会留下半个缓存文件
+            std::error_code ec;
+            std::filesystem::create_directories(directory_, ec);
+            const std::string temp_path = cache_path + ".tmp";
+            AssetSerializer serializer;
+            serializer.SetCompressionEnabled(enable_compression_);
+            if (ec || !serializer.SerializeToFile(asset, temp_path.c_str())) {
+                std::cerr << "无法写入资产缓存: " << temp_path << std::endl;
+                std::remove(temp_path.c_str());
+                return true;
+            }
+            std::filesystem::rename(temp_path, cache_path, ec);
+            if (ec) {
+                std::remove(temp_path.c_str());
+                return true;
+            }
+
+            stats_.saved++;
+            RemoveStaleEntries(gltf_path, cache_path);
+            std::cout << "资产已写入缓存: " << cache_path << std::endl;
+            return true;
+        }
+
+        std::string AssetCache::GetCachePrefix(const char* gltf_path) const {
+            // 路径哈希区分不同目录下的同名文件
+            std::error_code ec;
+            std::filesystem::path absolute = std::filesystem::absolute(gltf_path, ec);
+            const std::string path_string = ec ? std::string(gltf_path) : absolute.lexically_normal().string();
+
+            char hash[16];
+            snprintf(hash, sizeof(hash), "%08x", static_cast<uint32_t>(HashString(path_string)));
+            return std::filesystem::path(gltf_path).stem().string() + "-" + hash + "-";
+        }
+
+        std::string AssetCache::GetCachePath(const char* gltf_path, uint64_t key) const {
+            char name[32];
+            snprintf(name, sizeof(name), "%016llx.sprt", static_cast<unsigned long long>(key));
+            return directory_ + "/" + GetCachePrefix(gltf_path) + name;
+        }
+
+        void AssetCache::RemoveStaleEntries(const char* gltf_path, const std::string& keep_path) {
+            const std::string prefix = GetCachePrefix(gltf_path);
+            const std::string keep_name = std::filesystem::path(keep_path).filename().string();
+
+            std::error_code ec;
+            std::vector<std::filesystem::path> stale;
+            for (std::filesystem::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+                const std::string name = it->path().filename().string();
+                if (name != keep_name && name.compare(0, prefix.size(), prefix) == 0) {
+                    stale.push_back(it->path());
+                }
+            }
+            for (const auto& path : stale) {
+                std::filesystem::remove(path, ec);
+            }
+        }
+
+    } // namespace asset
+} // namespace spartan
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "AssetSerializer.h"
+#include "GltfTools.h"
+
+namespace spartan {
+    namespace asset {
+
+        /**
+         * 烘焙资产缓存
+         * 以(glTF源文件内容, 外部缓冲/图像内容, ProcessConfig, 文件格式和处理器版本)的哈希为键，
+         * 把GltfProcessor的输出存成.sprt，之后直接反序列化；任一输入变化都会得到新的键。
+         * 缓存文件损坏或版本不符时删除并重新处理。
+         */
+        class AssetCache {
+        public:
+            // 处理管线的输出变化（但ProcessConfig和文件格式不变）时递增，使旧缓存失效
+            static constexpr uint32_t COOKER_VERSION = 2;
+
+            struct CacheStats {
+                uint32_t hits = 0;       // 从缓存加载
+                uint32_t misses = 0;     // 没有对应的缓存，重新处理
+                uint32_t rejected = 0;   // 缓存文件无法加载，已删除
+                uint32_t saved = 0;      // 写入的缓存文件
+                double hash_ms = 0.0;    // 最近一次计算键的耗时
+                double load_ms = 0.0;    // 最近一次加载/处理的耗时
+            };
+
+            explicit AssetCache(const std::string& directory = "asset_cache");
+
+            /**
+             * 加载资产：键命中时从缓存反序列化，否则处理源文件并写入缓存
+             * 缓存目录不可写时只处理不缓存，不影响返回结果
+             * 命中时网格零拷贝引用映射的缓存文件（vertex_buffer/index_buffer为空，经GetVertexData/GetIndex访问）
+             */
+            bool Load(const char* gltf_path, const ProcessConfig& config, ProcessedAsset& asset,
+                      const GltfProcessor::ProgressCallback& progress = nullptr);
+
+            /**
+             * 计算缓存键；缺失的外部文件按"不存在"参与哈希，出现后键随之变化
+             * @return 源文件无法读取时返回false
+             */
+            bool ComputeKey(const char* gltf_path, const ProcessConfig& config, uint64_t& key);
+
+            // 缓存文件使用的压缩选项（见AssetSerializer::SetCompressionEnabled），默认不压缩以便映射后直接使用
+            void SetCompressionEnabled(bool enabled) { enable_compression_ = enabled; }
+
+            const CacheStats& GetStats() const { return stats_; }
+            const std::string& GetLastError() const { return last_error_; }
+
+        private:
+            // 缓存文件名：源文件名-路径哈希-键.sprt，同一源文件的旧键在写入新缓存后删除
+            std::string GetCachePrefix(const char* gltf_path) const;
+            std::string GetCachePath(const char* gltf_path, uint64_t key) const;
+            void RemoveStaleEntries(const char* gltf_path, const std::string& keep_path);
+
+            void SetError(const std::string& error) { last_error_ = error; }
+
+            std::string directory_;
+            bool enable_compression_ = false;
+            CacheStats stats_;
+            std::string last_error_;
+        };
+
+    } // namespace asset
+} // namespace spartan
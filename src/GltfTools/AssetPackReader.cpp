@@ -0,0 +1,470 @@
+#include "AssetPackReader.h"
+#include <algorithm>
+
+namespace spartan {
+    namespace asset {
+
+        namespace {
+
+            // CPU侧占用的估算，只统计随条目释放的大块数据
+            size_t EstimateItemBytes(const MeshData& mesh) {
+                const size_t index_bytes = mesh.HasMappedData()
+                                           ? static_cast<size_t>(mesh.mapped_index_count) * mesh.GetIndexSize()
+                                           : mesh.index_buffer.size() * sizeof(mesh.index_buffer[0]);
+                return sizeof(MeshData) + mesh.GetVertexDataSize() + index_bytes +
+                       mesh.submeshes.size() * sizeof(MeshData::SubMesh) +
+                       mesh.inverse_bind_poses.size() * sizeof(glm::mat4);
+            }
+
+            size_t EstimateItemBytes(const AnimationData& anim) {
+                size_t bytes = sizeof(AnimationData);
+                if (anim.skeletal_animation) {
+                    bytes += anim.skeletal_animation->size();
+                }
+                for (const auto& [node, data] : anim.node_animations) {
+                    bytes += (data.position_times.size() + data.rotation_times.size() + data.scale_times.size()) * sizeof(float) +
+                             (data.position_values.size() + data.scale_values.size()) * sizeof(ozz::math::Float3) +
+                             data.rotation_values.size() * sizeof(ozz::math::Quaternion);
+                }
+                return bytes;
+            }
+
+        } // namespace
+
+        AssetPackReader::~AssetPackReader() {
+            Close();
+        }
+
+        bool AssetPackReader::Open(const char* filepath, ProcessedAsset& resident) {
+            Close();
+
+            std::string error;
+            std::shared_ptr<MappedFile> mapping = MappedFile::OpenShared(filepath, &error);
+            if (!mapping) {
+                SetError(error);
+                return false;
+            }
+            const size_t file_size = mapping->Size();
+
+            AssetFileHeader file_header;
+            if (file_size < sizeof(file_header)) {
+                SetError("File too small");
+                return false;
+            }
+            std::memcpy(&file_header, mapping->Data(), sizeof(file_header));
+
+            std::lock_guard<std::mutex> load_lock(load_mutex_);
+            if (!serializer_.ValidateFileHeader(file_header, file_size)) {
+                SetError(serializer_.GetLastError());
+                return false;
+            }
+
+            std::vector<ChunkHeader> chunk_headers(file_header.chunk_count);
+            std::memcpy(chunk_headers.data(), mapping->Data() + sizeof(file_header),
+                        sizeof(ChunkHeader) * chunk_headers.size());
+            if (!serializer_.ValidateChunkHeaders(chunk_headers, file_size)) {
+                SetError(serializer_.GetLastError());
+                return false;
+            }
+
+            // 其他块通过索引引用字符串，先处理字符串表
+            std::stable_sort(chunk_headers.begin(), chunk_headers.end(),
+                             [](const ChunkHeader& a, const ChunkHeader& b) {
+                                 return (a.type == ChunkType::STRING_TABLE) > (b.type == ChunkType::STRING_TABLE);
+                             });
+
+            resident = ProcessedAsset();
+            serializer_.string_table_.Clear();
+
+            bool has_item_index = false;
+            std::vector<ItemIndexEntry> entries;
+            for (const auto& header : chunk_headers) {
+                const uint8_t* chunk_data = mapping->Data() + header.offset;
+                if (header.type == ChunkType::MESHES || header.type == ChunkType::ANIMATIONS) {
+                    LazyChunk& chunk = header.type == ChunkType::MESHES ? mesh_chunk_ : animation_chunk_;
+                    chunk.header = header;
+                    if (header.codec != ChunkCodec::STORE && header.size > 0 &&
+                        !serializer_.ParseBlockTable(chunk_data, header, chunk.blocks)) {
+                        SetError("Invalid block table");
+                        return false;
+                    }
+                    continue;
+                }
+                if (header.type == ChunkType::ITEM_INDEX) {
+                    // 索引块通常很小，压缩时整体解压
+                    std::vector<uint8_t> decompressed;
+                    const uint8_t* index_data = chunk_data;
+                    size_t index_size = static_cast<size_t>(header.size);
+                    if (header.codec != ChunkCodec::STORE) {
+                        if (!serializer_.DecompressChunk(chunk_data, header, decompressed)) {
+                            SetError("Failed to decompress item index");
+                            return false;
+                        }
+                        index_data = decompressed.data();
+                        index_size = decompressed.size();
+                    }
+                    if (!serializer_.DeserializeItemIndex(index_data, index_size, entries)) {
+                        SetError("Invalid item index");
+                        return false;
+                    }
+                    has_item_index = true;
+                    continue;
+                }
+                if (header.size > 0 && !serializer_.DeserializeChunk(resident, header, chunk_data, nullptr, mapping)) {
+                    SetError(serializer_.GetLastError());
+                    return false;
+                }
+            }
+
+            if (!has_item_index && (mesh_chunk_.header.size > 0 || animation_chunk_.header.size > 0)) {
+                SetError("Missing item index");
+                return false;
+            }
+
+            // 条目必须落在所属块（解压后）的范围内
+            SlotMap<MeshTag, size_t> mesh_items;
+            SlotMap<AnimationTag, size_t> animation_items;
+            for (size_t i = 0; i < entries.size(); ++i) {
+                const ItemIndexEntry& entry = entries[i];
+                const LazyChunk* chunk = entry.chunk == ChunkType::MESHES ? &mesh_chunk_ :
+                                         entry.chunk == ChunkType::ANIMATIONS ? &animation_chunk_ : nullptr;
+                if (!chunk || chunk->header.size == 0 || entry.size == 0 ||
+                    entry.offset > chunk->header.uncompressed_size ||
+                    entry.size > chunk->header.uncompressed_size - entry.offset) {
+                    SetError("Item index entry out of chunk bounds");
+                    return false;
+                }
+                if (entry.handle_id == 0 || entry.handle_id > SLOT_MAP_MAX_ID) {
+                    SetError("Item index entry has invalid handle");
+                    return false;
+                }
+                if (entry.chunk == ChunkType::MESHES) {
+                    mesh_items[MeshHandle(entry.handle_id, entry.handle_generation)] = i;
+                } else {
+                    animation_items[AnimationHandle(entry.handle_id, entry.handle_generation)] = i;
+                }
+            }
+
+            std::lock_guard<std::mutex> state_lock(state_mutex_);
+            entries_ = std::move(entries);
+            mesh_items_ = std::move(mesh_items);
+            animation_items_ = std::move(animation_items);
+            slots_.assign(entries_.size(), ItemSlot());
+            mapping_ = std::move(mapping);
+            return true;
+        }
+
+        void AssetPackReader::Close() {
+            // 先停止后台线程，再清空状态；剩余的请求在关闭后执行，得到空指针
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                stop_worker_ = true;
+            }
+            queue_cv_.notify_all();
+            if (worker_.joinable()) {
+                worker_.join();
+            }
+
+            std::deque<std::function<void()>> pending;
+            {
+                std::lock_guard<std::mutex> load_lock(load_mutex_);
+                std::lock_guard<std::mutex> state_lock(state_mutex_);
+                mapping_.reset();
+                mesh_chunk_ = LazyChunk();
+                animation_chunk_ = LazyChunk();
+                entries_.clear();
+                mesh_items_.clear();
+                animation_items_.clear();
+                slots_.clear();
+                lru_.clear();
+                resident_bytes_ = 0;
+
+                std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+                pending.swap(queue_);
+                stop_worker_ = false;
+            }
+            for (auto& task : pending) {
+                task();
+            }
+        }
+
+        std::vector<MeshHandle> AssetPackReader::GetMeshHandles() const {
+            std::vector<MeshHandle> handles;
+            handles.reserve(mesh_items_.size());
+            for (const auto& [handle, index] : mesh_items_) {
+                handles.push_back(handle);
+            }
+            return handles;
+        }
+
+        std::vector<AnimationHandle> AssetPackReader::GetAnimationHandles() const {
+            std::vector<AnimationHandle> handles;
+            handles.reserve(animation_items_.size());
+            for (const auto& [handle, index] : animation_items_) {
+                handles.push_back(handle);
+            }
+            return handles;
+        }
+
+        bool AssetPackReader::FindItem(ChunkType chunk, uint32_t id, uint32_t generation, size_t& index) const {
+            if (chunk == ChunkType::MESHES) {
+                const size_t* item = mesh_items_.get(MeshHandle(id, generation));
+                if (!item) return false;
+                index = *item;
+            } else {
+                const size_t* item = animation_items_.get(AnimationHandle(id, generation));
+                if (!item) return false;
+                index = *item;
+            }
+            return true;
+        }
+
+        std::shared_ptr<MeshData> AssetPackReader::AcquireMesh(MeshHandle handle) {
+            size_t index;
+            if (!FindItem(ChunkType::MESHES, handle.id, handle.generation, index)) {
+                return nullptr;
+            }
+            std::shared_ptr<MeshData> mesh;
+            std::shared_ptr<AnimationData> animation;
+            if (TouchResident(index, &mesh, &animation)) {
+                return mesh;
+            }
+
+            std::lock_guard<std::mutex> load_lock(load_mutex_);
+            // 等待加载锁期间可能已被其他线程加载
+            if (TouchResident(index, &mesh, &animation)) {
+                return mesh;
+            }
+            if (!LoadItem(index, mesh, animation)) {
+                return nullptr;
+            }
+            Insert(index, mesh, animation);
+            return mesh;
+        }
+
+        std::shared_ptr<AnimationData> AssetPackReader::AcquireAnimation(AnimationHandle handle) {
+            size_t index;
+            if (!FindItem(ChunkType::ANIMATIONS, handle.id, handle.generation, index)) {
+                return nullptr;
+            }
+            std::shared_ptr<MeshData> mesh;
+            std::shared_ptr<AnimationData> animation;
+            if (TouchResident(index, &mesh, &animation)) {
+                return animation;
+            }
+
+            std::lock_guard<std::mutex> load_lock(load_mutex_);
+            if (TouchResident(index, &mesh, &animation)) {
+                return animation;
+            }
+            if (!LoadItem(index, mesh, animation)) {
+                return nullptr;
+            }
+            Insert(index, mesh, animation);
+            return animation;
+        }
+
+        std::shared_future<std::shared_ptr<MeshData>> AssetPackReader::RequestMesh(MeshHandle handle) {
+            auto promise = std::make_shared<std::promise<std::shared_ptr<MeshData>>>();
+            std::shared_future<std::shared_ptr<MeshData>> future = promise->get_future().share();
+
+            size_t index;
+            std::shared_ptr<MeshData> mesh;
+            std::shared_ptr<AnimationData> animation;
+            if (!FindItem(ChunkType::MESHES, handle.id, handle.generation, index)) {
+                promise->set_value(nullptr);
+            } else if (TouchResident(index, &mesh, &animation)) {
+                promise->set_value(std::move(mesh));
+            } else {
+                Enqueue([this, handle, promise]() { promise->set_value(AcquireMesh(handle)); });
+            }
+            return future;
+        }
+
+        std::shared_future<std::shared_ptr<AnimationData>> AssetPackReader::RequestAnimation(AnimationHandle handle) {
+            auto promise = std::make_shared<std::promise<std::shared_ptr<AnimationData>>>();
+            std::shared_future<std::shared_ptr<AnimationData>> future = promise->get_future().share();
+
+            size_t index;
+            std::shared_ptr<MeshData> mesh;
+            std::shared_ptr<AnimationData> animation;
+            if (!FindItem(ChunkType::ANIMATIONS, handle.id, handle.generation, index)) {
+                promise->set_value(nullptr);
+            } else if (TouchResident(index, &mesh, &animation)) {
+                promise->set_value(std::move(animation));
+            } else {
+                Enqueue([this, handle, promise]() { promise->set_value(AcquireAnimation(handle)); });
+            }
+            return future;
+        }
+
+        bool AssetPackReader::TouchResident(size_t index, std::shared_ptr<MeshData>* mesh,
+                                            std::shared_ptr<AnimationData>* animation) {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (index >= slots_.size() || !slots_[index].resident) {
+                return false;
+            }
+            ItemSlot& slot = slots_[index];
+            lru_.splice(lru_.begin(), lru_, slot.lru);
+            *mesh = slot.mesh;
+            *animation = slot.animation;
+            return true;
+        }
+
+        bool AssetPackReader::LoadItem(size_t index, std::shared_ptr<MeshData>& mesh,
+                                       std::shared_ptr<AnimationData>& animation) {
+            const ItemIndexEntry& entry = entries_[index];
+            const LazyChunk& chunk = entry.chunk == ChunkType::MESHES ? mesh_chunk_ : animation_chunk_;
+            const ChunkHeader& header = chunk.header;
+
+            // 未压缩块直接在映射上读取；压缩块只解压覆盖条目的子块，窗口从第一个子块的起始偏移开始
+            const uint8_t* window = nullptr;
+            uint8_t* writable = nullptr;
+            uint64_t origin = 0;
+            size_t window_size = 0;
+            std::shared_ptr<const void> owner;
+            if (header.codec == ChunkCodec::STORE) {
+                window = mapping_->Data() + header.offset;
+                window_size = static_cast<size_t>(header.size);
+                owner = mapping_;
+            } else {
+                const AssetSerializer::BlockTable& blocks = chunk.blocks;
+                const size_t first = static_cast<size_t>(entry.offset / blocks.block_size);
+                const size_t last = static_cast<size_t>((entry.offset + entry.size + blocks.block_size - 1) / blocks.block_size);
+                origin = static_cast<uint64_t>(first) * blocks.block_size;
+                window_size = std::min(last * blocks.block_size, blocks.output_size) - static_cast<size_t>(origin);
+
+                auto buffer = std::make_shared<std::vector<uint8_t>>(window_size);
+                if (!serializer_.DecompressBlocks(blocks, first, last, buffer->data())) {
+                    SetError("Failed to decompress item blocks");
+                    return false;
+                }
+                window = buffer->data();
+                writable = buffer->data();
+                owner = std::move(buffer);
+            }
+
+            // 非零拷贝时窗口不持有owner，反序列化期间由这里保持解压缓冲
+            serializer_.BeginChunkWindow(window, writable, origin, window_size, owner);
+            const uint8_t* ptr = window + (entry.offset - origin);
+            size_t remaining = static_cast<size_t>(entry.size);
+            bool success = false;
+            if (entry.chunk == ChunkType::MESHES) {
+                MeshHandle handle;
+                mesh = std::make_shared<MeshData>();
+                success = serializer_.DeserializeMesh(ptr, remaining, handle, *mesh) &&
+                          handle == MeshHandle(entry.handle_id, entry.handle_generation);
+            } else {
+                AnimationHandle handle;
+                animation = std::make_shared<AnimationData>();
+                success = serializer_.DeserializeAnimation(ptr, remaining, handle, *animation) &&
+                          handle == AnimationHandle(entry.handle_id, entry.handle_generation);
+            }
+            serializer_.EndChunkWindow();
+
+            if (!success) {
+                mesh.reset();
+                animation.reset();
+                SetError("Failed to deserialize item " + std::to_string(entry.handle_id));
+            }
+            return success;
+        }
+
+        void AssetPackReader::Insert(size_t index, std::shared_ptr<MeshData> mesh,
+                                     std::shared_ptr<AnimationData> animation) {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            ItemSlot& slot = slots_[index];
+            slot.bytes = mesh ? EstimateItemBytes(*mesh) : EstimateItemBytes(*animation);
+            slot.mesh = std::move(mesh);
+            slot.animation = std::move(animation);
+            slot.resident = true;
+            lru_.push_front(index);
+            slot.lru = lru_.begin();
+            resident_bytes_ += slot.bytes;
+            TrimResidency();
+        }
+
+        void AssetPackReader::TrimResidency() {
+            // 网格上传GPU后可能已释放CPU数据，淘汰前重新估算；外部仍持有的条目沿用上次的估算，避免与使用方竞争
+            resident_bytes_ = 0;
+            for (size_t index : lru_) {
+                ItemSlot& slot = slots_[index];
+                if (slot.mesh ? slot.mesh.use_count() == 1 : slot.animation.use_count() == 1) {
+                    slot.bytes = slot.mesh ? EstimateItemBytes(*slot.mesh) : EstimateItemBytes(*slot.animation);
+                }
+                resident_bytes_ += slot.bytes;
+            }
+            if (residency_budget_ == 0) {
+                return;
+            }
+
+            // 从最久未使用的一端淘汰，跳过外部仍持有的条目（刚加载的条目在最前端，不会被淘汰）
+            auto it = lru_.end();
+            while (resident_bytes_ > residency_budget_ && it != lru_.begin()) {
+                --it;
+                ItemSlot& slot = slots_[*it];
+                const long use_count = slot.mesh ? slot.mesh.use_count() : slot.animation.use_count();
+                if (use_count > 1 || it == lru_.begin()) {
+                    continue;
+                }
+                resident_bytes_ -= slot.bytes;
+                slot = ItemSlot();
+                it = lru_.erase(it);
+            }
+        }
+
+        void AssetPackReader::SetResidencyBudget(size_t bytes) {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            residency_budget_ = bytes;
+            TrimResidency();
+        }
+
+        size_t AssetPackReader::GetResidentBytes() const {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            return resident_bytes_;
+        }
+
+        size_t AssetPackReader::GetResidentItemCount() const {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            return lru_.size();
+        }
+
+        std::string AssetPackReader::GetLastError() const {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            return last_error_;
+        }
+
+        void AssetPackReader::SetError(const std::string& error) {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            last_error_ = error;
+        }
+
+        void AssetPackReader::Enqueue(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                queue_.push_back(std::move(task));
+                if (!worker_.joinable()) {
+                    worker_ = std::thread(&AssetPackReader::WorkerLoop, this);
+                }
+            }
+            queue_cv_.notify_one();
+        }
+
+        void AssetPackReader::WorkerLoop() {
+            for (;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(queue_mutex_);
+                    queue_cv_.wait(lock, [this]() { return stop_worker_ || !queue_.empty(); });
+                    if (stop_worker_) {
+                        return;
+                    }
+                    task = std::move(queue_.front());
+                    queue_.pop_front();
+                }
+                task();
+            }
+        }
+
+    } // namespace asset
+} // namespace spartan
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AssetSerializer.h"
+
+namespace spartan {
+    namespace asset {
+
+        /**
+         * 按需加载的资源包读取器
+         * 打开时只读取文件头、块表和条目索引，并整体加载网格/动画以外的小块（材质、纹理、骨骼、场景节点等）；
+         * 网格和动画在首次访问时才解压覆盖它的子块并反序列化，打开耗时与包内网格/动画的数据量无关。
+         * 常驻的网格/动画按最近使用排序，超出预算时淘汰外部不再持有的条目（只释放CPU侧数据）。
+         * 目前只有RunAssetLoadBenchmark使用；ResourceManager仍经AssetCache整体加载资源包，尚未接入按需模式。
+         */
+        class AssetPackReader {
+        public:
+            AssetPackReader() = default;
+            ~AssetPackReader();
+
+            AssetPackReader(const AssetPackReader&) = delete;
+            AssetPackReader& operator=(const AssetPackReader&) = delete;
+
+            // 打开资源包，非网格/动画数据写入resident（meshes和animations保持为空）
+            bool Open(const char* filepath, ProcessedAsset& resident);
+            // 等待后台请求结束并释放映射；未完成的请求得到空指针
+            void Close();
+            bool IsOpen() const { return mapping_ != nullptr; }
+
+            std::vector<MeshHandle> GetMeshHandles() const;
+            std::vector<AnimationHandle> GetAnimationHandles() const;
+
+            // 同步获取，首次访问时在调用线程加载；句柄不存在或数据损坏时返回空指针
+            std::shared_ptr<MeshData> AcquireMesh(MeshHandle handle);
+            std::shared_ptr<AnimationData> AcquireAnimation(AnimationHandle handle);
+
+            // 异步获取：已常驻时立即就绪，否则交给后台线程加载
+            std::shared_future<std::shared_ptr<MeshData>> RequestMesh(MeshHandle handle);
+            std::shared_future<std::shared_ptr<AnimationData>> RequestAnimation(AnimationHandle handle);
+
+            // 常驻预算（字节），0 = 不限制
+            void SetResidencyBudget(size_t bytes);
+            size_t GetResidentBytes() const;
+            size_t GetResidentItemCount() const;
+
+            // 零拷贝网格：顶点/索引指向映射或解压缓冲，需在Open之前设置
+            void SetZeroCopyMeshesEnabled(bool enabled) { serializer_.SetZeroCopyMeshesEnabled(enabled); }
+            // 解压子块使用的线程数，0 = 硬件线程数
+            void SetWorkerThreadCount(uint32_t count) { serializer_.SetWorkerThreadCount(count); }
+
+            std::string GetLastError() const;
+
+        private:
+            // 可按需加载的块（网格、动画）
+            struct LazyChunk {
+                ChunkHeader header{};
+                AssetSerializer::BlockTable blocks;  // 仅压缩块使用
+            };
+
+            // 条目的常驻状态，与entries_一一对应
+            struct ItemSlot {
+                std::shared_ptr<MeshData> mesh;
+                std::shared_ptr<AnimationData> animation;
+                size_t bytes = 0;
+                bool resident = false;
+                std::list<size_t>::iterator lru;
+            };
+
+            // 查找条目，不存在返回false
+            bool FindItem(ChunkType chunk, uint32_t id, uint32_t generation, size_t& index) const;
+            // 已常驻时更新使用顺序并返回true
+            bool TouchResident(size_t index, std::shared_ptr<MeshData>* mesh, std::shared_ptr<AnimationData>* animation);
+            // 解压并反序列化一个条目（持有load_mutex_）
+            bool LoadItem(size_t index, std::shared_ptr<MeshData>& mesh, std::shared_ptr<AnimationData>& animation);
+            void Insert(size_t index, std::shared_ptr<MeshData> mesh, std::shared_ptr<AnimationData> animation);
+            // 重新估算常驻大小并按LRU淘汰（持有state_mutex_）
+            void TrimResidency();
+
+            void Enqueue(std::function<void()> task);
+            void WorkerLoop();
+            void SetError(const std::string& error);
+
+            // 打开后只读：映射、块信息和条目索引
+            std::shared_ptr<MappedFile> mapping_;
+            LazyChunk mesh_chunk_;
+            LazyChunk animation_chunk_;
+            std::vector<ItemIndexEntry> entries_;
+            SlotMap<MeshTag, size_t> mesh_items_;
+            SlotMap<AnimationTag, size_t> animation_items_;
+
+            // 加载锁：序列化器不是线程安全的，同一时刻只加载一个条目
+            std::mutex load_mutex_;
+            AssetSerializer serializer_;
+
+            // 状态锁：常驻表、LRU和错误信息；加载期间不持有，常驻条目的获取不会被后台加载阻塞
+            mutable std::mutex state_mutex_;
+            std::vector<ItemSlot> slots_;
+            std::list<size_t> lru_;  // 前端为最近使用
+            size_t resident_bytes_ = 0;
+            size_t residency_budget_ = 0;
+            std::string last_error_;
+
+            // 后台加载线程，首次异步请求时启动
+            std::mutex queue_mutex_;
+            std::condition_variable queue_cv_;
+            std::deque<std::function<void()>> queue_;
+            std::thread worker_;
+            bool stop_worker_ = false;
+        };
+
+    } // namespace asset
+} // namespace spartan
@@ -1,10 +1,21 @@
 #include "AssetSerializer.h"
+#include "AssetPackReader.h"
 #include "OzzSerializationHelper.h"
+#include "ParallelFor.h"
 #include "ozz/base/io/archive.h"
 #include "ozz/base/io/stream.h"
 #include <sstream>
 #include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
 
 // 为了实现ProcessedAsset的序列化方法
 #include "GltfTools.h"
@@ -12,6 +23,40 @@
 namespace spartan {
     namespace asset {
 
+        namespace {
+
+            template<typename T>
+            T AlignOffset(T offset) {
+                const T alignment = AssetFileHeader::BLOB_ALIGNMENT;
+                return (offset + alignment - 1) / alignment * alignment;
+            }
+
+            // 用LZ_FAST试压缩，估计数据段压缩后的大小（用于决定是否过滤）
+            size_t EstimateCompressedSize(const uint8_t* data, size_t size) {
+                std::vector<uint8_t> scratch(LzCompressBound(std::min<size_t>(size, COMPRESSED_BLOCK_SIZE)));
+                size_t total = 0;
+                for (size_t begin = 0; begin < size; begin += COMPRESSED_BLOCK_SIZE) {
+                    const size_t block = std::min<size_t>(COMPRESSED_BLOCK_SIZE, size - begin);
+                    const size_t compressed = LzCompress(data + begin, block, scratch.data(), scratch.size(), false);
+                    total += compressed > 0 ? std::min(compressed, block) : block;
+                }
+                return total;
+            }
+
+            // 当前常驻内存（仅Linux，其他平台返回0）
+            size_t GetResidentBytes() {
+#ifdef __linux__
+                std::ifstream statm("/proc/self/statm");
+                size_t total_pages = 0, resident_pages = 0;
+                if (statm >> total_pages >> resident_pages) {
+                    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+                }
+#endif
+                return 0;
+            }
+
+        } // namespace
+
 // StringTable 实现
         uint32_t StringTable::AddString(const char* str) {
             if (!str || str[0] == '\0') {
@@ -101,35 +146,63 @@ namespace spartan {
                 return false;
             }
 
-            // 清空字符串表
+            // 清空字符串表和条目索引
             string_table_.Clear();
+            item_index_.clear();
 
             // 准备各个数据块
             std::vector<std::vector<uint8_t>> chunks(static_cast<size_t>(ChunkType::CHUNK_COUNT));
             std::vector<ChunkHeader> chunk_headers(static_cast<size_t>(ChunkType::CHUNK_COUNT));
+            ReserveChunks(asset, chunks);
 
             // 序列化各个部分
             SerializeMetadata(asset, chunks[static_cast<size_t>(ChunkType::METADATA)]);
-            SerializeMeshes(asset, chunks[static_cast<size_t>(ChunkType::MESHES)]);
+            const bool filter_meshes = enable_stream_filters_ &&
+                                       chunk_codecs_[static_cast<size_t>(ChunkType::MESHES)] != ChunkCodec::STORE;
+            SerializeMeshes(asset, chunks[static_cast<size_t>(ChunkType::MESHES)], filter_meshes);
             SerializeMaterials(asset, chunks[static_cast<size_t>(ChunkType::MATERIALS)]);
             SerializeTextures(asset, chunks[static_cast<size_t>(ChunkType::TEXTURES)]);
             SerializeSkeletons(asset, chunks[static_cast<size_t>(ChunkType::SKELETONS)]);
             SerializeAnimations(asset, chunks[static_cast<size_t>(ChunkType::ANIMATIONS)]);
             SerializeSceneNodes(asset, chunks[static_cast<size_t>(ChunkType::SCENE_NODES)]);
 
-            // 序列化字符串表
+            // 序列化字符串表和条目索引（依赖上面各部分记录的位置）
             string_table_.Serialize(chunks[static_cast<size_t>(ChunkType::STRING_TABLE)]);
+            SerializeItemIndex(chunks[static_cast<size_t>(ChunkType::ITEM_INDEX)]);
+
+            // 按块选择的编码压缩，压缩后不更小的块仍原样存储
+            std::vector<uint64_t> uncompressed_sizes(chunks.size());
+            std::vector<ChunkCodec> codecs(chunks.size(), ChunkCodec::STORE);
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                uncompressed_sizes[i] = chunks[i].size();
+                if (chunk_codecs_[i] == ChunkCodec::STORE || chunks[i].empty()) continue;
+
+                std::vector<uint8_t> compressed;
+                if (CompressChunk(chunks[i], chunk_codecs_[i], compressed)) {
+                    chunks[i].swap(compressed);
+                    codecs[i] = chunk_codecs_[i];
+                } else if (i == static_cast<size_t>(ChunkType::MESHES) && filter_meshes) {
+                    // 过滤后的数据只能在可写的解压缓冲里还原，原样存储时改写为不过滤的数据；
+                    // 过滤不改变数据段的位置和大小，已写入的条目索引仍然有效，重复记录的条目丢弃
+                    const size_t item_count = item_index_.size();
+                    chunks[i].clear();
+                    SerializeMeshes(asset, chunks[i], false);
+                    item_index_.resize(item_count);
+                }
+            }
 
-            // 计算偏移和大小
-            uint64_t current_offset = sizeof(AssetFileHeader) +
-                                      sizeof(ChunkHeader) * static_cast<size_t>(ChunkType::CHUNK_COUNT);
+            // 计算偏移和大小（每个块按BLOB_ALIGNMENT对齐）
+            uint64_t current_offset = AlignOffset(sizeof(AssetFileHeader) +
+                                                  sizeof(ChunkHeader) * static_cast<size_t>(ChunkType::CHUNK_COUNT));
 
             for (size_t i = 0; i < chunks.size(); ++i) {
                 auto& header = chunk_headers[i];
                 header.type = static_cast<ChunkType>(i);
                 header.offset = current_offset;
                 header.size = chunks[i].size();
-                header.uncompressed_size = header.size; // 暂不压缩
+                header.uncompressed_size = uncompressed_sizes[i];
+                header.codec = codecs[i];
+                header.block_size = codecs[i] == ChunkCodec::STORE ? 0 : COMPRESSED_BLOCK_SIZE;
 
                 // 计算item_count
                 switch (header.type) {
@@ -151,18 +224,24 @@ namespace spartan {
                     case ChunkType::SCENE_NODES:
                         header.item_count = static_cast<uint32_t>(asset.nodes.size());
                         break;
+                    case ChunkType::ITEM_INDEX:
+                        header.item_count = static_cast<uint32_t>(item_index_.size());
+                        break;
                     default:
                         header.item_count = 1;
                 }
 
-                current_offset += header.size;
+                current_offset = AlignOffset(current_offset + header.size);
             }
 
             // 写入文件头
             AssetFileHeader file_header;
             file_header.magic = AssetFileHeader::MAGIC;
             file_header.version = AssetFileHeader::VERSION;
-            file_header.flags = enable_compression_ ? 1 : 0;
+            file_header.flags = 0;
+            for (const auto& header : chunk_headers) {
+                if (header.codec != ChunkCodec::STORE) file_header.flags |= AssetFileHeader::FLAG_COMPRESSED;
+            }
             file_header.chunk_count = static_cast<uint32_t>(ChunkType::CHUNK_COUNT);
             file_header.total_size = current_offset;
             file_header.checksum = 0; // TODO: 计算校验和
@@ -174,106 +253,425 @@ namespace spartan {
                 file.write(reinterpret_cast<const char*>(&header), sizeof(header));
             }
 
-            // 写入块数据
-            for (const auto& chunk : chunks) {
-                if (!chunk.empty()) {
-                    file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+            // 写入块数据，块之间用0填充到对齐位置
+            static const char padding[AssetFileHeader::BLOB_ALIGNMENT] = {};
+            uint64_t written = sizeof(AssetFileHeader) + sizeof(ChunkHeader) * chunk_headers.size();
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                file.write(padding, static_cast<std::streamsize>(chunk_headers[i].offset - written));
+                if (!chunks[i].empty()) {
+                    file.write(reinterpret_cast<const char*>(chunks[i].data()), chunks[i].size());
                 }
+                written = chunk_headers[i].offset + chunks[i].size();
             }
+            file.write(padding, static_cast<std::streamsize>(file_header.total_size - written));
 
+            if (!file) {
+                SetError(std::string("Failed to write file: ") + filepath);
+                return false;
+            }
             return true;
         }
 
         bool AssetSerializer::DeserializeFromFile(ProcessedAsset& asset, const char* filepath) {
-            std::ifstream file(filepath, std::ios::binary | std::ios::ate);
-            if (!file.is_open()) {
-                SetError(std::string("Failed to open file for reading: ") + filepath);
-                return false;
+            // 映射模式下整个文件只读映射一次，块数据直接在映射内存上解析；
+            // 否则按块读入临时缓冲（旧路径）
+            std::shared_ptr<MappedFile> mapping;
+            std::ifstream file;
+            size_t file_size = 0;
+
+            if (enable_memory_mapping_) {
+                std::string error;
+                mapping = MappedFile::OpenShared(filepath, &error);
+                if (!mapping) {
+                    SetError(error);
+                    return false;
+                }
+                file_size = mapping->Size();
+            } else {
+                file.open(filepath, std::ios::binary | std::ios::ate);
+                if (!file.is_open()) {
+                    SetError(std::string("Failed to open file for reading: ") + filepath);
+                    return false;
+                }
+                file_size = static_cast<size_t>(file.tellg());
+                file.seekg(0, std::ios::beg);
             }
 
-            // 获取文件大小
-            size_t file_size = file.tellg();
-            file.seekg(0, std::ios::beg);
-
-            // 读取文件头
+            // 读取文件头和块头
             AssetFileHeader file_header;
-            file.read(reinterpret_cast<char*>(&file_header), sizeof(file_header));
-
-            if (file_header.magic != AssetFileHeader::MAGIC) {
-                SetError("Invalid file magic number");
+            if (file_size < sizeof(file_header)) {
+                SetError("File too small");
                 return false;
             }
+            if (mapping) {
+                std::memcpy(&file_header, mapping->Data(), sizeof(file_header));
+            } else {
+                file.read(reinterpret_cast<char*>(&file_header), sizeof(file_header));
+            }
 
-            if (file_header.version != AssetFileHeader::VERSION) {
-                SetError("Unsupported file version");
+            if (!ValidateFileHeader(file_header, file_size)) {
                 return false;
             }
 
-            // 读取块头
+            const size_t headers_size = sizeof(ChunkHeader) * static_cast<size_t>(file_header.chunk_count);
             std::vector<ChunkHeader> chunk_headers(file_header.chunk_count);
-            file.read(reinterpret_cast<char*>(chunk_headers.data()),
-                      sizeof(ChunkHeader) * file_header.chunk_count);
+            if (mapping) {
+                std::memcpy(chunk_headers.data(), mapping->Data() + sizeof(file_header), headers_size);
+            } else {
+                file.read(reinterpret_cast<char*>(chunk_headers.data()), headers_size);
+            }
+
+            if (!ValidateChunkHeaders(chunk_headers, file_size)) {
+                return false;
+            }
+
+            // 其他块通过索引引用字符串，先处理字符串表
+            std::stable_sort(chunk_headers.begin(), chunk_headers.end(),
+                             [](const ChunkHeader& a, const ChunkHeader& b) {
+                                 return (a.type == ChunkType::STRING_TABLE) > (b.type == ChunkType::STRING_TABLE);
+                             });
 
             // 清空资产数据
             asset = ProcessedAsset();
             string_table_.Clear();
 
             // 处理每个数据块
+            std::vector<uint8_t> chunk_storage;
             for (const auto& header : chunk_headers) {
                 if (header.size == 0) continue;
 
-                // 读取块数据
-                std::vector<uint8_t> chunk_data(header.size);
-                file.seekg(header.offset);
-                file.read(reinterpret_cast<char*>(chunk_data.data()), header.size);
-
-                // 反序列化块
-                bool success = false;
-                switch (header.type) {
-                    case ChunkType::STRING_TABLE:
-                        success = string_table_.Deserialize(chunk_data.data(), chunk_data.size());
-                        break;
-                    case ChunkType::METADATA:
-                        success = DeserializeMetadata(asset, chunk_data.data(), chunk_data.size());
-                        break;
-                    case ChunkType::MESHES:
-                        success = DeserializeMeshes(asset, chunk_data.data(), chunk_data.size());
-                        break;
-                    case ChunkType::MATERIALS:
-                        success = DeserializeMaterials(asset, chunk_data.data(), chunk_data.size());
-                        break;
-                    case ChunkType::TEXTURES:
-                        success = DeserializeTextures(asset, chunk_data.data(), chunk_data.size());
-                        break;
-                    case ChunkType::SKELETONS:
-                        success = DeserializeSkeletons(asset, chunk_data.data(), chunk_data.size());
-                        break;
-                    case ChunkType::ANIMATIONS:
-                        success = DeserializeAnimations(asset, chunk_data.data(), chunk_data.size());
-                        break;
-                    case ChunkType::SCENE_NODES:
-                        success = DeserializeSceneNodes(asset, chunk_data.data(), chunk_data.size());
-                        break;
-                    default:
-                        SetError("Unknown chunk type");
+                if (mapping) {
+                    if (!DeserializeChunk(asset, header, mapping->Data() + header.offset, nullptr, mapping)) {
                         return false;
+                    }
+                } else {
+                    chunk_storage.resize(header.size);
+                    file.seekg(header.offset);
+                    file.read(reinterpret_cast<char*>(chunk_storage.data()), header.size);
+                    if (!DeserializeChunk(asset, header, chunk_storage.data(), chunk_storage.data(), nullptr)) {
+                        return false;
+                    }
                 }
+            }
+            return true;
+        }
+
+        bool AssetSerializer::ValidateFileHeader(const AssetFileHeader& file_header, size_t file_size) {
+            if (file_header.magic != AssetFileHeader::MAGIC) {
+                SetError("Invalid file magic number");
+                return false;
+            }
+
+            if (file_header.version != AssetFileHeader::VERSION) {
+                SetError("Unsupported file version");
+                return false;
+            }
 
-                if (!success) {
-                    SetError(std::string("Failed to deserialize chunk type: ") +
+            const size_t headers_size = sizeof(ChunkHeader) * static_cast<size_t>(file_header.chunk_count);
+            if (file_header.chunk_count > static_cast<uint32_t>(ChunkType::CHUNK_COUNT) ||
+                file_size < sizeof(file_header) + headers_size) {
+                SetError("Invalid chunk table");
+                return false;
+            }
+            return true;
+        }
+
+        bool AssetSerializer::ValidateChunkHeaders(const std::vector<ChunkHeader>& chunk_headers, size_t file_size) {
+            for (const auto& header : chunk_headers) {
+                if (header.offset > file_size || header.size > file_size - header.offset ||
+                    header.offset % AssetFileHeader::BLOB_ALIGNMENT != 0) {
+                    SetError("Chunk out of file bounds");
+                    return false;
+                }
+                if (header.codec != ChunkCodec::STORE && header.codec != ChunkCodec::LZ_FAST &&
+                    header.codec != ChunkCodec::LZ_HIGH) {
+                    SetError("Unknown chunk codec");
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool AssetSerializer::DeserializeChunk(ProcessedAsset& asset, const ChunkHeader& header, const uint8_t* chunk_data,
+                                               uint8_t* writable_data, const std::shared_ptr<const void>& mapping) {
+            // 未压缩块零拷贝时引用文件映射；压缩块解压到独立缓冲，零拷贝网格共同持有该缓冲
+            std::shared_ptr<std::vector<uint8_t>> decompressed;
+            if (header.codec != ChunkCodec::STORE) {
+                decompressed = std::make_shared<std::vector<uint8_t>>();
+                if (!DecompressChunk(chunk_data, header, *decompressed)) {
+                    SetError(std::string("Failed to decompress chunk type: ") +
                              std::to_string(static_cast<int>(header.type)));
                     return false;
                 }
+                BeginChunkWindow(decompressed->data(), decompressed->data(), 0, decompressed->size(), decompressed);
+            } else {
+                BeginChunkWindow(chunk_data, writable_data, 0, header.size, mapping);
+            }
+            const uint8_t* data = chunk_base_;
+            const size_t size = chunk_end_;
+
+            // 反序列化块
+            bool success = false;
+            switch (header.type) {
+                case ChunkType::STRING_TABLE:
+                    success = string_table_.Deserialize(data, size);
+                    break;
+                case ChunkType::METADATA:
+                    success = DeserializeMetadata(asset, data, size);
+                    break;
+                case ChunkType::MESHES:
+                    success = DeserializeMeshes(asset, data, size);
+                    break;
+                case ChunkType::MATERIALS:
+                    success = DeserializeMaterials(asset, data, size);
+                    break;
+                case ChunkType::TEXTURES:
+                    success = DeserializeTextures(asset, data, size);
+                    break;
+                case ChunkType::SKELETONS:
+                    success = DeserializeSkeletons(asset, data, size);
+                    break;
+                case ChunkType::ANIMATIONS:
+                    success = DeserializeAnimations(asset, data, size);
+                    break;
+                case ChunkType::SCENE_NODES:
+                    success = DeserializeSceneNodes(asset, data, size);
+                    break;
+                case ChunkType::ITEM_INDEX:
+                    // 只用于按需加载，整体加载时忽略
+                    success = true;
+                    break;
+                default:
+                    SetError("Unknown chunk type");
+                    success = false;
+                    break;
+            }
+
+            // 映射/解压缓冲由零拷贝网格共同持有，这里只释放自己的引用
+            EndChunkWindow();
+            if (!success) {
+                SetError(std::string("Failed to deserialize chunk type: ") +
+                         std::to_string(static_cast<int>(header.type)));
+                return false;
+            }
+            return true;
+        }
+
+        void AssetSerializer::BeginChunkWindow(const uint8_t* data, uint8_t* writable_data, uint64_t origin, size_t size,
+                                               std::shared_ptr<const void> owner) {
+            chunk_base_ = data;
+            chunk_writable_base_ = writable_data;
+            chunk_origin_ = origin;
+            chunk_end_ = origin + size;
+            blob_owner_ = enable_zero_copy_meshes_ ? std::move(owner) : nullptr;
+        }
+
+        void AssetSerializer::EndChunkWindow() {
+            chunk_base_ = nullptr;
+            chunk_writable_base_ = nullptr;
+            chunk_origin_ = 0;
+            chunk_end_ = 0;
+            blob_owner_.reset();
+        }
+
+        void AssetSerializer::WriteBlob(std::vector<uint8_t>& buffer, const void* data, uint32_t size) {
+            Write(buffer, size);
+            size_t offset = AlignOffset(buffer.size() + sizeof(uint32_t));
+            Write(buffer, static_cast<uint32_t>(offset));
+            // 填充字节为0，数据直接追加，不先清零
+            buffer.resize(offset);
+            if (size > 0) {
+                const auto* bytes = static_cast<const uint8_t*>(data);
+                buffer.insert(buffer.end(), bytes, bytes + size);
+            }
+        }
+
+        template<typename T>
+        void AssetSerializer::WriteOzzObject(std::vector<uint8_t>& buffer, const T& object) {
+            // 先写大小占位，序列化后回填
+            const size_t size_offset = buffer.size();
+            Write(buffer, uint32_t(0));
+            const auto size = static_cast<uint32_t>(AppendOzzObject(object, buffer));
+            std::memcpy(buffer.data() + size_offset, &size, sizeof(size));
+        }
+
+        bool AssetSerializer::ReadBlob(const uint8_t*& data, size_t& remaining,
+                                       const uint8_t*& blob, uint32_t& size) {
+            uint32_t offset;
+            if (!Read(data, remaining, size)) return false;
+            if (!Read(data, remaining, offset)) return false;
+
+            // 数据段必须位于当前位置之后、窗口之内，且满足对齐（偏移相对于整个块，窗口从chunk_origin_开始）
+            const uint64_t position = chunk_origin_ + static_cast<uint64_t>(data - chunk_base_);
+            if (!chunk_base_ || offset < position || offset % AssetFileHeader::BLOB_ALIGNMENT != 0 ||
+                offset > chunk_end_ || size > chunk_end_ - offset) {
+                return false;
+            }
+
+            blob = chunk_base_ + (offset - chunk_origin_);
+            data = blob + size;
+            remaining = static_cast<size_t>(chunk_end_ - offset - size);
+            return true;
+        }
+
+        void AssetSerializer::WriteVertexBlob(std::vector<uint8_t>& buffer, const MeshData& mesh, bool filter) {
+            const uint8_t* vertices = mesh.GetVertexData();
+            const size_t size = mesh.GetVertexDataSize();
+            const uint32_t stride = mesh.format.stride;
+
+            StreamFilter vertex_filter = StreamFilter::NONE;
+            if (filter && stride > 1 && size == static_cast<size_t>(mesh.vertex_count) * stride) {
+                temp_buffer_.resize(size);
+                EncodeBytePlanes(vertices, mesh.vertex_count, stride, temp_buffer_.data());
+                if (EstimateCompressedSize(temp_buffer_.data(), size) < EstimateCompressedSize(vertices, size)) {
+                    vertex_filter = StreamFilter::BYTE_PLANES;
+                    vertices = temp_buffer_.data();
+                }
+            }
+
+            Write(buffer, static_cast<uint8_t>(vertex_filter));
+            WriteBlob(buffer, vertices, static_cast<uint32_t>(size));
+        }
+
+        void AssetSerializer::WriteIndexBlob(std::vector<uint8_t>& buffer, const void* data, uint32_t count,
+                                             uint32_t index_size, bool filter) {
+            const uint8_t* indices = static_cast<const uint8_t*>(data);
+            const size_t size = static_cast<size_t>(count) * index_size;
+
+            StreamFilter index_filter = StreamFilter::NONE;
+            if (filter && count > 0) {
+                temp_buffer_.resize(size);
+                EncodeIndexDeltas(indices, count, index_size, temp_buffer_.data());
+                if (EstimateCompressedSize(temp_buffer_.data(), size) < EstimateCompressedSize(indices, size)) {
+                    index_filter = StreamFilter::DELTA_ZIGZAG;
+                    indices = temp_buffer_.data();
+                }
+            }
+
+            Write(buffer, static_cast<uint8_t>(index_filter));
+            WriteBlob(buffer, indices, static_cast<uint32_t>(size));
+        }
+
+        bool AssetSerializer::UnfilterBlob(StreamFilter filter, const uint8_t* blob, size_t count, size_t element_size) {
+            if (filter == StreamFilter::NONE) return true;
+            // 过滤器只用于压缩块，解压缓冲可写；映射的只读块里出现过滤器说明文件损坏
+            if (!chunk_writable_base_) return false;
+
+            uint8_t* target = chunk_writable_base_ + (blob - chunk_base_);
+            temp_buffer_.assign(blob, blob + count * element_size);
+            switch (filter) {
+                case StreamFilter::BYTE_PLANES:
+                    DecodeBytePlanes(temp_buffer_.data(), count, element_size, target);
+                    return true;
+                case StreamFilter::DELTA_ZIGZAG:
+                    if (element_size != 2 && element_size != 4) return false;
+                    DecodeIndexDeltas(temp_buffer_.data(), count, element_size, target);
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // 关键帧值按连续的float数组读写
+        static_assert(sizeof(ozz::math::Float3) == 3 * sizeof(float), "Float3 must be tightly packed");
+        static_assert(sizeof(ozz::math::Quaternion) == 4 * sizeof(float), "Quaternion must be tightly packed");
+
+        // 整体写入的结构，布局必须与逐个float读取的顺序一致
+        static_assert(sizeof(ozz::math::Transform) == 10 * sizeof(float), "Transform must be tightly packed");
+        static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "mat4 must be tightly packed");
+
+        void AssetSerializer::WriteKeyframes(std::vector<uint8_t>& buffer, const float* values, size_t count,
+                                             size_t components, bool filter) {
+            if (count == 0) return;
+
+            if (filter) {
+                keyframe_buffer_.resize(count * components);
+                EncodeXorDelta(values, count, components, keyframe_buffer_.data());
+                WriteArray(buffer, keyframe_buffer_.data(), keyframe_buffer_.size());
+            } else {
+                WriteArray(buffer, values, count * components);
             }
+        }
 
+        bool AssetSerializer::ReadKeyframes(const uint8_t*& data, size_t& remaining, float* values, size_t count,
+                                            size_t components, bool filter) {
+            const size_t elements = count * components;
+            if (elements > remaining / sizeof(float)) return false;
+            const size_t bytes = elements * sizeof(float);
+            if (bytes == 0) return true;
+
+            if (filter) {
+                std::vector<uint32_t> encoded(elements);
+                std::memcpy(encoded.data(), data, bytes);
+                DecodeXorDelta(encoded.data(), count, components, values);
+            } else {
+                std::memcpy(values, data, bytes);
+            }
+            data += bytes;
+            remaining -= bytes;
             return true;
         }
 
+// 预留块容量：大块数据按实际大小计算，其余字段按每个条目的上限估计
+        void AssetSerializer::ReserveChunks(const ProcessedAsset& asset, std::vector<std::vector<uint8_t>>& chunks) const {
+            constexpr size_t ITEM_OVERHEAD = 256;
+            constexpr size_t BLOB_OVERHEAD = 2 * sizeof(uint32_t) + sizeof(uint8_t) + AssetFileHeader::BLOB_ALIGNMENT;
+
+            size_t mesh_bytes = sizeof(uint32_t);
+            for (const auto& [handle, mesh] : asset.meshes) {
+                mesh_bytes += ITEM_OVERHEAD + 2 * BLOB_OVERHEAD +
+                              mesh.format.attribute_map.size() * 4 * sizeof(uint32_t) +
+                              mesh.GetVertexDataSize() + static_cast<size_t>(mesh.GetIndexCount()) * mesh.GetIndexSize() +
+                              mesh.submeshes.size() * sizeof(MeshData::SubMesh) +
+                              mesh.inverse_bind_poses.size() * sizeof(glm::mat4);
+            }
+
+            size_t texture_bytes = sizeof(uint32_t);
+            for (const auto& [handle, texture] : asset.textures) {
+                texture_bytes += ITEM_OVERHEAD + BLOB_OVERHEAD + texture.pixels.size();
+            }
+
+            size_t skeleton_bytes = sizeof(uint32_t);
+            for (const auto& [handle, skeleton] : asset.skeletons) {
+                // 每个关节：名称、父索引、绑定姿势
+                skeleton_bytes += ITEM_OVERHEAD +
+                                  (skeleton ? static_cast<size_t>(skeleton->num_joints()) * (64 + sizeof(ozz::math::Transform)) : 0);
+            }
+
+            size_t animation_bytes = sizeof(uint32_t);
+            for (const auto& [handle, anim] : asset.animations) {
+                animation_bytes += ITEM_OVERHEAD + (anim.skeletal_animation ? anim.skeletal_animation->size() : 0);
+                for (const auto& [node, data] : anim.node_animations) {
+                    animation_bytes += 8 * sizeof(uint32_t) +
+                                       (data.position_times.size() + data.rotation_times.size() + data.scale_times.size()) * sizeof(float) +
+                                       (data.position_values.size() + data.scale_values.size()) * sizeof(ozz::math::Float3) +
+                                       data.rotation_values.size() * sizeof(ozz::math::Quaternion);
+                }
+            }
+
+            size_t node_bytes = 2 * sizeof(uint32_t) + asset.root_nodes.size() * sizeof(int);
+            for (const auto& node : asset.nodes) {
+                node_bytes += ITEM_OVERHEAD / 2 + node.children.size() * sizeof(int);
+            }
+
+            chunks[static_cast<size_t>(ChunkType::MESHES)].reserve(mesh_bytes);
+            chunks[static_cast<size_t>(ChunkType::MATERIALS)].reserve(sizeof(uint32_t) + asset.materials.size() * ITEM_OVERHEAD);
+            chunks[static_cast<size_t>(ChunkType::TEXTURES)].reserve(texture_bytes);
+            chunks[static_cast<size_t>(ChunkType::SKELETONS)].reserve(skeleton_bytes);
+            chunks[static_cast<size_t>(ChunkType::ANIMATIONS)].reserve(animation_bytes);
+            chunks[static_cast<size_t>(ChunkType::SCENE_NODES)].reserve(node_bytes);
+            chunks[static_cast<size_t>(ChunkType::ITEM_INDEX)].reserve(
+                    sizeof(uint32_t) + (asset.meshes.size() + asset.animations.size()) * sizeof(ItemIndexEntry));
+        }
+
 // 序列化网格数据
-        void AssetSerializer::SerializeMeshes(const ProcessedAsset& asset, std::vector<uint8_t>& buffer) {
+        void AssetSerializer::SerializeMeshes(const ProcessedAsset& asset, std::vector<uint8_t>& buffer,
+                                              bool filter_streams) {
             Write(buffer, static_cast<uint32_t>(asset.meshes.size()));
 
             for (const auto& [handle, mesh] : asset.meshes) {
+                const size_t item_begin = buffer.size();
+
                 // 写入句柄
                 Write(buffer, handle.id);
                 Write(buffer, handle.generation);
@@ -281,6 +679,7 @@ namespace spartan {
                 // 写入顶点格式
                 Write(buffer, mesh.format.attributes);
                 Write(buffer, mesh.format.stride);
+                Write(buffer, mesh.format.quantized);
                 Write(buffer, static_cast<uint32_t>(mesh.format.attribute_map.size()));
 
                 for (const auto& [attr, info] : mesh.format.attribute_map) {
@@ -291,23 +690,24 @@ namespace spartan {
                     Write(buffer, info.normalized);
                 }
 
-                // 写入顶点数据
+                // 写入顶点数据（对齐数据段，可直接上传）
                 Write(buffer, mesh.vertex_count);
-                Write(buffer, static_cast<uint32_t>(mesh.vertex_buffer.size()));
-                if (!mesh.vertex_buffer.empty()) {
-                    size_t offset = buffer.size();
-                    buffer.resize(offset + mesh.vertex_buffer.size());
-                    std::memcpy(buffer.data() + offset, mesh.vertex_buffer.data(),
-                                mesh.vertex_buffer.size());
-                }
-
-                // 写入索引数据
-                Write(buffer, static_cast<uint32_t>(mesh.index_buffer.size()));
-                if (!mesh.index_buffer.empty()) {
-                    size_t offset = buffer.size();
-                    buffer.resize(offset + mesh.index_buffer.size() * sizeof(uint32_t));
-                    std::memcpy(buffer.data() + offset, mesh.index_buffer.data(),
-                                mesh.index_buffer.size() * sizeof(uint32_t));
+                WriteVertexBlob(buffer, mesh, filter_streams);
+
+                // 写入索引数据（按GPU宽度存储，16位网格按16位存储）
+                const uint32_t index_count = mesh.GetIndexCount();
+                Write(buffer, mesh.index_type);
+                Write(buffer, index_count);
+                if (mesh.index_type == GL_UNSIGNED_SHORT) {
+                    std::vector<uint16_t> narrow(index_count);
+                    for (uint32_t j = 0; j < index_count; ++j) {
+                        narrow[j] = static_cast<uint16_t>(mesh.GetIndex(j));
+                    }
+                    WriteIndexBlob(buffer, narrow.data(), index_count, sizeof(uint16_t), filter_streams);
+                } else if (mesh.mapped_indices) {
+                    WriteIndexBlob(buffer, mesh.mapped_indices, index_count, sizeof(uint32_t), filter_streams);
+                } else {
+                    WriteIndexBlob(buffer, mesh.index_buffer.data(), index_count, sizeof(uint32_t), filter_streams);
                 }
 
                 // 写入子网格
@@ -318,12 +718,10 @@ namespace spartan {
                     Write(buffer, submesh.base_vertex);
                     Write(buffer, submesh.material.id);
                     Write(buffer, submesh.material.generation);
-                    Write(buffer, submesh.aabb_min.x);
-                    Write(buffer, submesh.aabb_min.y);
-                    Write(buffer, submesh.aabb_min.z);
-                    Write(buffer, submesh.aabb_max.x);
-                    Write(buffer, submesh.aabb_max.y);
-                    Write(buffer, submesh.aabb_max.z);
+                    Write(buffer, submesh.aabb_min);
+                    Write(buffer, submesh.aabb_max);
+                    Write(buffer, submesh.dequant_offset);
+                    Write(buffer, submesh.dequant_scale);
                 }
 
                 // 写入骨骼信息
@@ -332,15 +730,13 @@ namespace spartan {
                     Write(buffer, mesh.skeleton->id);
                     Write(buffer, mesh.skeleton->generation);
 
+                    // 按列主序的16个float整体写入，与逐元素mat[i][j]的顺序相同
                     Write(buffer, static_cast<uint32_t>(mesh.inverse_bind_poses.size()));
-                    for (const auto& mat : mesh.inverse_bind_poses) {
-                        for (int i = 0; i < 4; ++i) {
-                            for (int j = 0; j < 4; ++j) {
-                                Write(buffer, mat[i][j]);
-                            }
-                        }
-                    }
+                    WriteArray(buffer, mesh.inverse_bind_poses.data(), mesh.inverse_bind_poses.size());
                 }
+
+                item_index_.push_back({ChunkType::MESHES, handle.id, handle.generation, 0, item_begin,
+                                       buffer.size() - item_begin});
             }
         }
 
@@ -404,6 +800,9 @@ namespace spartan {
                 Write(buffer, texture.is_srgb);
                 Write(buffer, texture.mip_levels);
                 Write(buffer, texture.generate_mipmaps);
+
+                // 写入像素数据（全部mip级别）
+                WriteBlob(buffer, texture.pixels.data(), static_cast<uint32_t>(texture.pixels.size()));
             }
         }
 
@@ -416,13 +815,7 @@ namespace spartan {
                 Write(buffer, handle.generation);
 
                 if (skeleton) {
-                    // 使用辅助函数序列化骨骼
-                    auto data = SerializeOzzObject(*skeleton);
-                    Write(buffer, static_cast<uint32_t>(data.size()));
-
-                    size_t offset = buffer.size();
-                    buffer.resize(offset + data.size());
-                    std::memcpy(buffer.data() + offset, data.data(), data.size());
+                    WriteOzzObject(buffer, *skeleton);
                 } else {
                     Write(buffer, uint32_t(0));
                 }
@@ -433,6 +826,8 @@ namespace spartan {
             Write(buffer, static_cast<uint32_t>(asset.animations.size()));
 
             for (const auto& [handle, anim] : asset.animations) {
+                const size_t item_begin = buffer.size();
+
                 // --- 1. 序列化基本信息和句柄 ---
                 Write(buffer, handle.id);
                 Write(buffer, handle.generation);
@@ -454,47 +849,73 @@ namespace spartan {
                     Write(buffer, anim.target_mesh->id);
                     Write(buffer, anim.target_mesh->generation);
                 }
+                Write(buffer, anim.root_motion_joint_index.has_value());
+                if (anim.root_motion_joint_index.has_value()) {
+                    Write(buffer, anim.root_motion_joint_index.value());
+                }
 
                 // --- 3. 序列化OZZ骨骼动画数据 ---
                 bool has_skeletal = anim.skeletal_animation != nullptr;
                 Write(buffer, has_skeletal);
                 if (has_skeletal) {
-                    auto data = SerializeOzzObject(*anim.skeletal_animation);
-                    Write(buffer, static_cast<uint32_t>(data.size()));
-                    if (!data.empty()) {
-                        size_t offset = buffer.size();
-                        buffer.resize(offset + data.size());
-                        std::memcpy(buffer.data() + offset, data.data(), data.size());
-                    }
+                    WriteOzzObject(buffer, *anim.skeletal_animation);
                 }
 
                 // --- 4. 【核心改动】序列化节点变换动画的 map ---
                 bool has_node_animations = !anim.node_animations.empty();
                 Write(buffer, has_node_animations);
                 if (has_node_animations) {
+                    const bool filter_keys = enable_stream_filters_ &&
+                                             chunk_codecs_[static_cast<size_t>(ChunkType::ANIMATIONS)] != ChunkCodec::STORE;
+                    Write(buffer, static_cast<uint8_t>(filter_keys ? StreamFilter::XOR_DELTA : StreamFilter::NONE));
                     Write(buffer, static_cast<uint32_t>(anim.node_animations.size()));
                     for (const auto& [node_idx, data] : anim.node_animations) {
                         Write(buffer, node_idx); // 写入键 (node_index)
 
-                        // 序列化值 (NodeTransformData)
+                        // 序列化值 (NodeTransformData)，值的数量与时间相同
                         Write(buffer, static_cast<uint32_t>(data.position_times.size()));
-                        for (float t : data.position_times) Write(buffer, t);
-                        for (const auto& v : data.position_values) { Write(buffer, v.x); Write(buffer, v.y); Write(buffer, v.z); }
+                        WriteKeyframes(buffer, data.position_times.data(), data.position_times.size(), 1, filter_keys);
+                        WriteKeyframes(buffer, reinterpret_cast<const float*>(data.position_values.data()), data.position_values.size(), 3, filter_keys);
 
                         Write(buffer, static_cast<uint32_t>(data.rotation_times.size()));
-                        for (float t : data.rotation_times) Write(buffer, t);
-                        for (const auto& q : data.rotation_values) { Write(buffer, q.x); Write(buffer, q.y); Write(buffer, q.z); Write(buffer, q.w); }
+                        WriteKeyframes(buffer, data.rotation_times.data(), data.rotation_times.size(), 1, filter_keys);
+                        WriteKeyframes(buffer, reinterpret_cast<const float*>(data.rotation_values.data()), data.rotation_values.size(), 4, filter_keys);
 
                         Write(buffer, static_cast<uint32_t>(data.scale_times.size()));
-                        for (float t : data.scale_times) Write(buffer, t);
-                        for (const auto& v : data.scale_values) { Write(buffer, v.x); Write(buffer, v.y); Write(buffer, v.z); }
+                        WriteKeyframes(buffer, data.scale_times.data(), data.scale_times.size(), 1, filter_keys);
+                        WriteKeyframes(buffer, reinterpret_cast<const float*>(data.scale_values.data()), data.scale_values.size(), 3, filter_keys);
 
                         Write(buffer, static_cast<uint8_t>(data.interpolation));
                     }
                 }
 
+                item_index_.push_back({ChunkType::ANIMATIONS, handle.id, handle.generation, 0, item_begin,
+                                       buffer.size() - item_begin});
+            }
+        }
+
+// 条目索引
+        void AssetSerializer::SerializeItemIndex(std::vector<uint8_t>& buffer) {
+            Write(buffer, static_cast<uint32_t>(item_index_.size()));
+            for (const auto& entry : item_index_) {
+                Write(buffer, entry);
+            }
+        }
+
+        bool AssetSerializer::DeserializeItemIndex(const uint8_t* data, size_t size, std::vector<ItemIndexEntry>& entries) {
+            const uint8_t* ptr = data;
+            size_t remaining = size;
+
+            uint32_t count;
+            if (!Read(ptr, remaining, count) || count > remaining / sizeof(ItemIndexEntry)) return false;
+
+            entries.resize(count);
+            for (auto& entry : entries) {
+                if (!Read(ptr, remaining, entry)) return false;
             }
+            return true;
         }
+
 // 序列化场景节点
         void AssetSerializer::SerializeSceneNodes(const ProcessedAsset& asset, std::vector<uint8_t>& buffer) {
             // 节点数据
@@ -505,19 +926,10 @@ namespace spartan {
                 Write(buffer, node.parent_index);
 
                 Write(buffer, static_cast<uint32_t>(node.children.size()));
-                for (int child : node.children) Write(buffer, child);
+                WriteArray(buffer, node.children.data(), node.children.size());
 
-                // 变换
-                Write(buffer, node.local_transform.translation.x);
-                Write(buffer, node.local_transform.translation.y);
-                Write(buffer, node.local_transform.translation.z);
-                Write(buffer, node.local_transform.rotation.x);
-                Write(buffer, node.local_transform.rotation.y);
-                Write(buffer, node.local_transform.rotation.z);
-                Write(buffer, node.local_transform.rotation.w);
-                Write(buffer, node.local_transform.scale.x);
-                Write(buffer, node.local_transform.scale.y);
-                Write(buffer, node.local_transform.scale.z);
+                // 变换（平移、旋转、缩放共10个float）
+                Write(buffer, node.local_transform);
 
                 // 资源引用
                 Write(buffer, node.mesh.has_value());
@@ -547,7 +959,7 @@ namespace spartan {
 
             // 根节点
             Write(buffer, static_cast<uint32_t>(asset.root_nodes.size()));
-            for (int root : asset.root_nodes) Write(buffer, root);
+            WriteArray(buffer, asset.root_nodes.data(), asset.root_nodes.size());
         }
 
 // 序列化元数据
@@ -563,6 +975,10 @@ namespace spartan {
             Write(buffer, asset.metadata.stats.total_bones);
             Write(buffer, asset.metadata.stats.total_animations);
             Write(buffer, asset.metadata.stats.total_memory_bytes);
+
+            // 句柄生成器：加载后新建的资源（如静态合批）不能与已有句柄冲突
+            Write(buffer, asset.handle_generator.next_id);
+            Write(buffer, asset.handle_generator.generation);
         }
 
 // 反序列化网格数据
@@ -575,98 +991,138 @@ namespace spartan {
 
             for (uint32_t i = 0; i < mesh_count; ++i) {
                 MeshHandle handle;
-                if (!Read(ptr, remaining, handle.id)) return false;
-                if (!Read(ptr, remaining, handle.generation)) return false;
+                MeshData mesh;
+                if (!DeserializeMesh(ptr, remaining, handle, mesh)) return false;
+                if (!IsSlotMapHandle(handle)) return false;
+                asset.meshes[handle] = std::move(mesh);
+            }
 
-                MeshData& mesh = asset.meshes[handle];
+            return true;
+        }
 
-                // 读取顶点格式
-                if (!Read(ptr, remaining, mesh.format.attributes)) return false;
-                if (!Read(ptr, remaining, mesh.format.stride)) return false;
+        bool AssetSerializer::DeserializeMesh(const uint8_t*& ptr, size_t& remaining, MeshHandle& handle, MeshData& mesh) {
+            if (!Read(ptr, remaining, handle.id)) return false;
+            if (!Read(ptr, remaining, handle.generation)) return false;
 
-                uint32_t attr_count;
-                if (!Read(ptr, remaining, attr_count)) return false;
+            // 读取顶点格式
+            if (!Read(ptr, remaining, mesh.format.attributes)) return false;
+            if (!Read(ptr, remaining, mesh.format.stride)) return false;
+            if (!Read(ptr, remaining, mesh.format.quantized)) return false;
 
-                for (uint32_t j = 0; j < attr_count; ++j) {
-                    VertexFormat::Attribute attr;
-                    VertexFormat::AttributeInfo info;
+            uint32_t attr_count;
+            if (!Read(ptr, remaining, attr_count)) return false;
 
-                    if (!Read(ptr, remaining, attr)) return false;
-                    if (!Read(ptr, remaining, info.offset)) return false;
-                    if (!Read(ptr, remaining, info.components)) return false;
-                    if (!Read(ptr, remaining, info.type)) return false;
-                    if (!Read(ptr, remaining, info.normalized)) return false;
+            for (uint32_t j = 0; j < attr_count; ++j) {
+                VertexFormat::Attribute attr;
+                VertexFormat::AttributeInfo info;
 
-                    mesh.format.attribute_map[attr] = info;
-                }
+                if (!Read(ptr, remaining, attr)) return false;
+                if (!Read(ptr, remaining, info.offset)) return false;
+                if (!Read(ptr, remaining, info.components)) return false;
+                if (!Read(ptr, remaining, info.type)) return false;
+                if (!Read(ptr, remaining, info.normalized)) return false;
 
-                // 读取顶点数据
-                if (!Read(ptr, remaining, mesh.vertex_count)) return false;
+                mesh.format.attribute_map[attr] = info;
+            }
 
-                uint32_t vertex_buffer_size;
-                if (!Read(ptr, remaining, vertex_buffer_size)) return false;
+            // 读取顶点数据
+            if (!Read(ptr, remaining, mesh.vertex_count)) return false;
 
-                if (vertex_buffer_size > 0) {
-                    if (remaining < vertex_buffer_size) return false;
+            uint8_t vertex_filter;
+            if (!Read(ptr, remaining, vertex_filter)) return false;
 
-                    mesh.vertex_buffer.resize(vertex_buffer_size);
-                    std::memcpy(mesh.vertex_buffer.data(), ptr, vertex_buffer_size);
-                    ptr += vertex_buffer_size;
-                    remaining -= vertex_buffer_size;
+            const uint8_t* vertex_blob = nullptr;
+            uint32_t vertex_buffer_size = 0;
+            if (!ReadBlob(ptr, remaining, vertex_blob, vertex_buffer_size)) return false;
+            if (vertex_filter != static_cast<uint8_t>(StreamFilter::NONE)) {
+                if (vertex_filter != static_cast<uint8_t>(StreamFilter::BYTE_PLANES) ||
+                    vertex_buffer_size != static_cast<size_t>(mesh.vertex_count) * mesh.format.stride ||
+                    !UnfilterBlob(StreamFilter::BYTE_PLANES, vertex_blob, mesh.vertex_count, mesh.format.stride)) {
+                    return false;
                 }
+            }
 
-                // 读取索引数据
-                uint32_t index_count;
-                if (!Read(ptr, remaining, index_count)) return false;
+            // 读取索引数据
+            if (!Read(ptr, remaining, mesh.index_type)) return false;
+            if (mesh.index_type != GL_UNSIGNED_SHORT && mesh.index_type != GL_UNSIGNED_INT) return false;
 
-                if (index_count > 0) {
-                    size_t index_size = index_count * sizeof(uint32_t);
-                    if (remaining < index_size) return false;
+            uint32_t index_count;
+            if (!Read(ptr, remaining, index_count)) return false;
 
-                    mesh.index_buffer.resize(index_count);
-                    std::memcpy(mesh.index_buffer.data(), ptr, index_size);
-                    ptr += index_size;
-                    remaining -= index_size;
+            uint8_t index_filter;
+            if (!Read(ptr, remaining, index_filter)) return false;
+
+            const uint8_t* index_blob = nullptr;
+            uint32_t index_blob_size = 0;
+            if (!ReadBlob(ptr, remaining, index_blob, index_blob_size)) return false;
+            if (index_blob_size != static_cast<size_t>(index_count) * mesh.GetIndexSize()) return false;
+            if (index_filter != static_cast<uint8_t>(StreamFilter::NONE)) {
+                if (index_filter != static_cast<uint8_t>(StreamFilter::DELTA_ZIGZAG) ||
+                    !UnfilterBlob(StreamFilter::DELTA_ZIGZAG, index_blob, index_count, mesh.GetIndexSize())) {
+                    return false;
                 }
+            }
 
-                // 读取子网格
-                uint32_t submesh_count;
-                if (!Read(ptr, remaining, submesh_count)) return false;
-
-                mesh.submeshes.resize(submesh_count);
-                for (auto& submesh : mesh.submeshes) {
-                    if (!Read(ptr, remaining, submesh.index_offset)) return false;
-                    if (!Read(ptr, remaining, submesh.index_count)) return false;
-                    if (!Read(ptr, remaining, submesh.base_vertex)) return false;
-                    if (!Read(ptr, remaining, submesh.material.id)) return false;
-                    if (!Read(ptr, remaining, submesh.material.generation)) return false;
-                    if (!Read(ptr, remaining, submesh.aabb_min.x)) return false;
-                    if (!Read(ptr, remaining, submesh.aabb_min.y)) return false;
-                    if (!Read(ptr, remaining, submesh.aabb_min.z)) return false;
-                    if (!Read(ptr, remaining, submesh.aabb_max.x)) return false;
-                    if (!Read(ptr, remaining, submesh.aabb_max.y)) return false;
-                    if (!Read(ptr, remaining, submesh.aabb_max.z)) return false;
+            if (blob_owner_ && vertex_buffer_size == static_cast<size_t>(mesh.vertex_count) * mesh.format.stride) {
+                // 零拷贝：直接引用映射内存或解压缓冲
+                mesh.mapped_storage = blob_owner_;
+                mesh.mapped_vertices = vertex_blob;
+                mesh.mapped_indices = index_count > 0 ? index_blob : nullptr;
+                mesh.mapped_index_count = index_count;
+            } else {
+                mesh.vertex_buffer.assign(vertex_blob, vertex_blob + vertex_buffer_size);
+
+                mesh.index_buffer.resize(index_count);
+                if (mesh.index_type == GL_UNSIGNED_SHORT) {
+                    for (uint32_t j = 0; j < index_count; ++j) {
+                        uint16_t narrow;
+                        std::memcpy(&narrow, index_blob + j * sizeof(uint16_t), sizeof(narrow));
+                        mesh.index_buffer[j] = narrow;
+                    }
+                } else if (index_count > 0) {
+                    std::memcpy(mesh.index_buffer.data(), index_blob, index_blob_size);
                 }
+            }
 
-                // 读取骨骼信息
-                bool has_skeleton;
-                if (!Read(ptr, remaining, has_skeleton)) return false;
+            // 读取子网格
+            uint32_t submesh_count;
+            if (!Read(ptr, remaining, submesh_count)) return false;
+
+            mesh.submeshes.resize(submesh_count);
+            for (auto& submesh : mesh.submeshes) {
+                if (!Read(ptr, remaining, submesh.index_offset)) return false;
+                if (!Read(ptr, remaining, submesh.index_count)) return false;
+                if (!Read(ptr, remaining, submesh.base_vertex)) return false;
+                if (!Read(ptr, remaining, submesh.material.id)) return false;
+                if (!Read(ptr, remaining, submesh.material.generation)) return false;
+                if (!Read(ptr, remaining, submesh.aabb_min.x)) return false;
+                if (!Read(ptr, remaining, submesh.aabb_min.y)) return false;
+                if (!Read(ptr, remaining, submesh.aabb_min.z)) return false;
+                if (!Read(ptr, remaining, submesh.aabb_max.x)) return false;
+                if (!Read(ptr, remaining, submesh.aabb_max.y)) return false;
+                if (!Read(ptr, remaining, submesh.aabb_max.z)) return false;
+                if (!Read(ptr, remaining, submesh.dequant_offset)) return false;
+                if (!Read(ptr, remaining, submesh.dequant_scale)) return false;
+            }
 
-                if (has_skeleton) {
-                    SkeletonHandle skel_handle;
-                    if (!Read(ptr, remaining, skel_handle.id)) return false;
-                    if (!Read(ptr, remaining, skel_handle.generation)) return false;
-                    mesh.skeleton = skel_handle;
+            // 读取骨骼信息
+            bool has_skeleton;
+            if (!Read(ptr, remaining, has_skeleton)) return false;
+
+            if (has_skeleton) {
+                SkeletonHandle skel_handle;
+                if (!Read(ptr, remaining, skel_handle.id)) return false;
+                if (!Read(ptr, remaining, skel_handle.generation)) return false;
+                mesh.skeleton = skel_handle;
 
-                    uint32_t bind_pose_count;
-                    if (!Read(ptr, remaining, bind_pose_count)) return false;
+                uint32_t bind_pose_count;
+                if (!Read(ptr, remaining, bind_pose_count)) return false;
 
-                    mesh.inverse_bind_poses.resize(bind_pose_count);
-                    for (auto& mat : mesh.inverse_bind_poses) {
-                        for (int row = 0; row < 4; ++row) {
-                            for (int col = 0; col < 4; ++col) {
-                                if (!Read(ptr, remaining, mat[row][col])) return false;
-                            }
+                mesh.inverse_bind_poses.resize(bind_pose_count);
+                for (auto& mat : mesh.inverse_bind_poses) {
+                    for (int row = 0; row < 4; ++row) {
+                        for (int col = 0; col < 4; ++col) {
+                            if (!Read(ptr, remaining, mat[row][col])) return false;
                         }
                     }
                 }
@@ -687,6 +1143,7 @@ namespace spartan {
                 MaterialHandle handle;
                 if (!Read(ptr, remaining, handle.id)) return false;
                 if (!Read(ptr, remaining, handle.generation)) return false;
+                if (!IsSlotMapHandle(handle)) return false;
 
                 MaterialData& material = asset.materials[handle];
 
@@ -751,6 +1208,7 @@ namespace spartan {
                 TextureHandle handle;
                 if (!Read(ptr, remaining, handle.id)) return false;
                 if (!Read(ptr, remaining, handle.generation)) return false;
+                if (!IsSlotMapHandle(handle)) return false;
 
                 TextureData& texture = asset.textures[handle];
 
@@ -769,6 +1227,15 @@ namespace spartan {
                 if (!Read(ptr, remaining, texture.is_srgb)) return false;
                 if (!Read(ptr, remaining, texture.mip_levels)) return false;
                 if (!Read(ptr, remaining, texture.generate_mipmaps)) return false;
+
+                const uint8_t* pixel_blob = nullptr;
+                uint32_t pixel_size = 0;
+                if (!ReadBlob(ptr, remaining, pixel_blob, pixel_size)) return false;
+
+                if (pixel_size > 0) {
+                    if (texture.mip_levels == 0 || texture.mip_levels > 32 || pixel_size != texture.GetMipOffset(texture.mip_levels)) return false;
+                    texture.pixels.assign(pixel_blob, pixel_blob + pixel_size);
+                }
             }
 
             return true;
@@ -786,6 +1253,7 @@ namespace spartan {
                 SkeletonHandle handle;
                 if (!Read(ptr, remaining, handle.id)) return false;
                 if (!Read(ptr, remaining, handle.generation)) return false;
+                if (!IsSlotMapHandle(handle)) return false;
 
                 uint32_t data_size;
                 if (!Read(ptr, remaining, data_size)) return false;
@@ -830,98 +1298,122 @@ namespace spartan {
             if (!Read(ptr, remaining, anim_count)) return false;
 
             for (uint32_t i = 0; i < anim_count; ++i) {
-                // --- 1. 反序列化基本信息和句柄 ---
                 AnimationHandle handle;
-                if (!Read(ptr, remaining, handle.id)) return false;
-                if (!Read(ptr, remaining, handle.generation)) return false;
-                AnimationData& anim = asset.animations[handle];
+                AnimationData anim;
+                if (!DeserializeAnimation(ptr, remaining, handle, anim)) return false;
+                if (!IsSlotMapHandle(handle)) return false;
+                asset.animations[handle] = std::move(anim);
+            }
 
-                uint32_t name_idx;
-                if (!Read(ptr, remaining, name_idx)) return false;
-                anim.name = string_table_.GetString(name_idx);
+            return true;
+        }
 
-                if (!Read(ptr, remaining, anim.duration)) return false;
+        bool AssetSerializer::DeserializeAnimation(const uint8_t*& ptr, size_t& remaining, AnimationHandle& handle,
+                                                   AnimationData& anim) {
+            // --- 1. 反序列化基本信息和句柄 ---
+            if (!Read(ptr, remaining, handle.id)) return false;
+            if (!Read(ptr, remaining, handle.generation)) return false;
+
+            uint32_t name_idx;
+            if (!Read(ptr, remaining, name_idx)) return false;
+            anim.name = string_table_.GetString(name_idx);
+
+            if (!Read(ptr, remaining, anim.duration)) return false;
+
+            // --- 2. 反序列化目标资源引用 ---
+            bool has_value;
+            if (!Read(ptr, remaining, has_value)) return false;
+            if (has_value) {
+                SkeletonHandle skel_handle;
+                if (!Read(ptr, remaining, skel_handle.id)) return false;
+                if (!Read(ptr, remaining, skel_handle.generation)) return false;
+                anim.target_skeleton = skel_handle;
+            }
 
-                // --- 2. 反序列化目标资源引用 ---
-                bool has_value;
-                if (!Read(ptr, remaining, has_value)) return false;
-                if (has_value) {
-                    SkeletonHandle skel_handle;
-                    if (!Read(ptr, remaining, skel_handle.id)) return false;
-                    if (!Read(ptr, remaining, skel_handle.generation)) return false;
-                    anim.target_skeleton = skel_handle;
-                }
+            if (!Read(ptr, remaining, has_value)) return false;
+            if (has_value) {
+                uint32_t node_idx;
+                if (!Read(ptr, remaining, node_idx)) return false;
+                anim.target_node = node_idx;
+            }
 
-                if (!Read(ptr, remaining, has_value)) return false;
-                if (has_value) {
-                    uint32_t node_idx;
-                    if (!Read(ptr, remaining, node_idx)) return false;
-                    anim.target_node = node_idx;
-                }
+            if (!Read(ptr, remaining, has_value)) return false;
+            if (has_value) {
+                MeshHandle mesh_handle;
+                if (!Read(ptr, remaining, mesh_handle.id)) return false;
+                if (!Read(ptr, remaining, mesh_handle.generation)) return false;
+                anim.target_mesh = mesh_handle;
+            }
 
-                if (!Read(ptr, remaining, has_value)) return false;
-                if (has_value) {
-                    MeshHandle mesh_handle;
-                    if (!Read(ptr, remaining, mesh_handle.id)) return false;
-                    if (!Read(ptr, remaining, mesh_handle.generation)) return false;
-                    anim.target_mesh = mesh_handle;
-                }
+            if (!Read(ptr, remaining, has_value)) return false;
+            if (has_value) {
+                uint32_t joint_index;
+                if (!Read(ptr, remaining, joint_index)) return false;
+                anim.root_motion_joint_index = joint_index;
+            }
 
-                // --- 3. 反序列化OZZ骨骼动画数据 ---
-                if (!Read(ptr, remaining, has_value)) return false;
-                if (has_value) {
-                    uint32_t data_size;
-                    if (!Read(ptr, remaining, data_size)) return false;
-                    if (data_size > 0) {
-                        if (remaining < data_size) return false;
-                        anim.skeletal_animation = std::make_unique<ozz::animation::Animation>();
-                        if (!DeserializeOzzObject(ptr, data_size, *anim.skeletal_animation)) {
-                            return false;
-                        }
-                        ptr += data_size;
-                        remaining -= data_size;
+            // --- 3. 反序列化OZZ骨骼动画数据 ---
+            if (!Read(ptr, remaining, has_value)) return false;
+            if (has_value) {
+                uint32_t data_size;
+                if (!Read(ptr, remaining, data_size)) return false;
+                if (data_size > 0) {
+                    if (remaining < data_size) return false;
+                    anim.skeletal_animation = ozz::make_unique<ozz::animation::Animation>();
+                    if (!DeserializeOzzObject(ptr, data_size, *anim.skeletal_animation)) {
+                        return false;
                     }
+                    ptr += data_size;
+                    remaining -= data_size;
                 }
+            }
 
-                // --- 4. 【核心改动】反序列化节点变换动画的 map ---
-                if (!Read(ptr, remaining, has_value)) return false;
-                if (has_value) {
-                    uint32_t map_size;
-                    if (!Read(ptr, remaining, map_size)) return false;
-                    for (uint32_t j = 0; j < map_size; ++j) {
-                        uint32_t node_idx;
-                        if (!Read(ptr, remaining, node_idx)) return false;
-                        auto& node_data = anim.node_animations[node_idx]; // 获取或创建 map 中的元素
-
-                        uint32_t count;
-                        // 位置
-                        if (!Read(ptr, remaining, count)) return false;
-                        node_data.position_times.resize(count);
-                        for (auto& t : node_data.position_times) { if (!Read(ptr, remaining, t)) return false; }
-                        node_data.position_values.resize(count);
-                        for (auto& v : node_data.position_values) { if (!Read(ptr, remaining, v.x) || !Read(ptr, remaining, v.y) || !Read(ptr, remaining, v.z)) return false; }
-
-                        // 旋转
-                        if (!Read(ptr, remaining, count)) return false;
-                        node_data.rotation_times.resize(count);
-                        for (auto& t : node_data.rotation_times) { if (!Read(ptr, remaining, t)) return false; }
-                        node_data.rotation_values.resize(count);
-                        for (auto& q : node_data.rotation_values) { if (!Read(ptr, remaining, q.x) || !Read(ptr, remaining, q.y) || !Read(ptr, remaining, q.z) || !Read(ptr, remaining, q.w)) return false; }
-
-                        // 缩放
-                        if (!Read(ptr, remaining, count)) return false;
-                        node_data.scale_times.resize(count);
-                        for (auto& t : node_data.scale_times) { if (!Read(ptr, remaining, t)) return false; }
-                        node_data.scale_values.resize(count);
-                        for (auto& v : node_data.scale_values) { if (!Read(ptr, remaining, v.x) || !Read(ptr, remaining, v.y) || !Read(ptr, remaining, v.z)) return false; }
-
-                        // 插值类型
-                        uint8_t interp;
-                        if (!Read(ptr, remaining, interp)) return false;
-                        node_data.interpolation = static_cast<NodeTransformData::InterpolationType>(interp);
-                    }
+            // --- 4. 【核心改动】反序列化节点变换动画的 map ---
+            if (!Read(ptr, remaining, has_value)) return false;
+            if (has_value) {
+                uint8_t keyframe_filter;
+                if (!Read(ptr, remaining, keyframe_filter)) return false;
+                if (keyframe_filter != static_cast<uint8_t>(StreamFilter::NONE) &&
+                    keyframe_filter != static_cast<uint8_t>(StreamFilter::XOR_DELTA)) {
+                    return false;
                 }
+                const bool filter_keys = keyframe_filter == static_cast<uint8_t>(StreamFilter::XOR_DELTA);
 
+                uint32_t map_size;
+                if (!Read(ptr, remaining, map_size)) return false;
+                for (uint32_t j = 0; j < map_size; ++j) {
+                    uint32_t node_idx;
+                    if (!Read(ptr, remaining, node_idx)) return false;
+                    auto& node_data = anim.node_animations[node_idx]; // 获取或创建 map 中的元素
+
+                    // 先检查剩余长度再分配，避免损坏的数量导致巨量分配
+                    uint32_t count;
+                    // 位置
+                    if (!Read(ptr, remaining, count) || count > remaining / (4 * sizeof(float))) return false;
+                    node_data.position_times.resize(count);
+                    node_data.position_values.resize(count);
+                    if (!ReadKeyframes(ptr, remaining, node_data.position_times.data(), count, 1, filter_keys) ||
+                        !ReadKeyframes(ptr, remaining, reinterpret_cast<float*>(node_data.position_values.data()), count, 3, filter_keys)) return false;
+
+                    // 旋转
+                    if (!Read(ptr, remaining, count) || count > remaining / (5 * sizeof(float))) return false;
+                    node_data.rotation_times.resize(count);
+                    node_data.rotation_values.resize(count);
+                    if (!ReadKeyframes(ptr, remaining, node_data.rotation_times.data(), count, 1, filter_keys) ||
+                        !ReadKeyframes(ptr, remaining, reinterpret_cast<float*>(node_data.rotation_values.data()), count, 4, filter_keys)) return false;
+
+                    // 缩放
+                    if (!Read(ptr, remaining, count) || count > remaining / (4 * sizeof(float))) return false;
+                    node_data.scale_times.resize(count);
+                    node_data.scale_values.resize(count);
+                    if (!ReadKeyframes(ptr, remaining, node_data.scale_times.data(), count, 1, filter_keys) ||
+                        !ReadKeyframes(ptr, remaining, reinterpret_cast<float*>(node_data.scale_values.data()), count, 3, filter_keys)) return false;
+
+                    // 插值类型
+                    uint8_t interp;
+                    if (!Read(ptr, remaining, interp)) return false;
+                    node_data.interpolation = static_cast<NodeTransformData::InterpolationType>(interp);
+                }
             }
 
             return true;
@@ -1039,6 +1531,9 @@ namespace spartan {
             if (!Read(ptr, remaining, asset.metadata.stats.total_animations)) return false;
             if (!Read(ptr, remaining, asset.metadata.stats.total_memory_bytes)) return false;
 
+            if (!Read(ptr, remaining, asset.handle_generator.next_id)) return false;
+            if (!Read(ptr, remaining, asset.handle_generator.generation)) return false;
+
             return true;
         }
 
@@ -1067,21 +1562,118 @@ namespace spartan {
             return true;
         }
 
-// 压缩函数（暂不实现）
-        bool AssetSerializer::CompressChunk(const std::vector<uint8_t>& input, std::vector<uint8_t>& output) {
-            // TODO: 实现压缩（如LZ4）
-            output = input;
-            return true;
+// 压缩
+        void AssetSerializer::SetCompressionEnabled(bool enabled) {
+            for (size_t i = 0; i < static_cast<size_t>(ChunkType::CHUNK_COUNT); ++i) {
+                chunk_codecs_[i] = enabled ? ChunkCodec::LZ_FAST : ChunkCodec::STORE;
+            }
+            if (enabled) {
+                SetChunkCodec(ChunkType::MESHES, ChunkCodec::LZ_HIGH);
+                SetChunkCodec(ChunkType::TEXTURES, ChunkCodec::LZ_HIGH);
+                SetChunkCodec(ChunkType::ANIMATIONS, ChunkCodec::LZ_HIGH);
+            }
+        }
+
+        bool AssetSerializer::CompressChunk(const std::vector<uint8_t>& input, ChunkCodec codec,
+                                            std::vector<uint8_t>& output) {
+            const size_t block_count = (input.size() + COMPRESSED_BLOCK_SIZE - 1) / COMPRESSED_BLOCK_SIZE;
+            std::vector<std::vector<uint8_t>> blocks(block_count);
+
+            // 子块互不依赖，并行压缩；压缩后不更小的子块原样存储（大小为0）
+            ParallelFor(block_count, worker_thread_count_, [&](size_t i) {
+                const size_t begin = i * COMPRESSED_BLOCK_SIZE;
+                const size_t size = std::min<size_t>(COMPRESSED_BLOCK_SIZE, input.size() - begin);
+                auto& block = blocks[i];
+                block.resize(LzCompressBound(size));
+                size_t compressed = LzCompress(input.data() + begin, size, block.data(), block.size(),
+                                               codec == ChunkCodec::LZ_HIGH);
+                block.resize(compressed < size ? compressed : 0);
+            });
+
+            output.clear();
+            Write(output, static_cast<uint32_t>(block_count));
+            for (size_t i = 0; i < block_count; ++i) {
+                const size_t size = std::min<size_t>(COMPRESSED_BLOCK_SIZE, input.size() - i * COMPRESSED_BLOCK_SIZE);
+                const uint32_t entry = blocks[i].empty() ? (static_cast<uint32_t>(size) | STORED_BLOCK_BIT)
+                                                         : static_cast<uint32_t>(blocks[i].size());
+                Write(output, entry);
+            }
+            for (size_t i = 0; i < block_count; ++i) {
+                const size_t begin = i * COMPRESSED_BLOCK_SIZE;
+                if (blocks[i].empty()) {
+                    const size_t size = std::min<size_t>(COMPRESSED_BLOCK_SIZE, input.size() - begin);
+                    output.insert(output.end(), input.begin() + begin, input.begin() + begin + size);
+                } else {
+                    output.insert(output.end(), blocks[i].begin(), blocks[i].end());
+                }
+            }
+
+            // 整体没有变小就不压缩
+            return output.size() < input.size();
+        }
+
+        bool AssetSerializer::DecompressChunk(const uint8_t* input, const ChunkHeader& header,
+                                              std::vector<uint8_t>& output) {
+            BlockTable table;
+            if (!ParseBlockTable(input, header, table)) return false;
+
+            output.resize(table.output_size);
+            return DecompressBlocks(table, 0, table.entries.size(), output.data());
         }
 
-        bool AssetSerializer::DecompressChunk(const uint8_t* input, size_t input_size,
-                                              std::vector<uint8_t>& output, size_t output_size) {
-            // TODO: 实现解压
-            output.resize(output_size);
-            std::memcpy(output.data(), input, input_size);
+        bool AssetSerializer::ParseBlockTable(const uint8_t* input, const ChunkHeader& header, BlockTable& table) {
+            table.block_size = header.block_size;
+            table.output_size = static_cast<size_t>(header.uncompressed_size);
+            // LZ格式的压缩比上限约为255:1，超过说明块头损坏，避免按错误的大小分配
+            if (table.block_size == 0 || table.output_size == 0 || table.output_size / 256 > header.size) {
+                return false;
+            }
+
+            const uint8_t* ptr = input;
+            size_t remaining = static_cast<size_t>(header.size);
+            uint32_t block_count = 0;
+            if (!Read(ptr, remaining, block_count)) return false;
+            if (block_count != (table.output_size + table.block_size - 1) / table.block_size ||
+                remaining / sizeof(uint32_t) < block_count) {
+                return false;
+            }
+
+            table.entries.resize(block_count);
+            table.offsets.resize(block_count);
+            for (uint32_t i = 0; i < block_count; ++i) {
+                if (!Read(ptr, remaining, table.entries[i])) return false;
+            }
+            size_t data_offset = 0;
+            for (uint32_t i = 0; i < block_count; ++i) {
+                const size_t size = table.entries[i] & ~STORED_BLOCK_BIT;
+                if (size > remaining - data_offset) return false;
+                table.offsets[i] = data_offset;
+                data_offset += size;
+            }
+            table.data = ptr;
             return true;
         }
 
+        bool AssetSerializer::DecompressBlocks(const BlockTable& table, size_t first, size_t last, uint8_t* output) {
+            std::vector<uint8_t> block_ok(last - first, 0);
+            ParallelFor(last - first, worker_thread_count_, [&](size_t k) {
+                const size_t i = first + k;
+                const uint8_t* src = table.data + table.offsets[i];
+                const size_t src_size = table.entries[i] & ~STORED_BLOCK_BIT;
+                uint8_t* dst = output + k * table.block_size;
+                const size_t dst_size = std::min(table.block_size, table.output_size - i * table.block_size);
+                if (table.entries[i] & STORED_BLOCK_BIT) {
+                    if (src_size != dst_size) return;
+                    std::memcpy(dst, src, dst_size);
+                    block_ok[k] = 1;
+                } else {
+                    block_ok[k] = LzDecompress(src, src_size, dst, dst_size) ? 1 : 0;
+                }
+            });
+
+            return std::all_of(block_ok.begin(), block_ok.end(), [](uint8_t ok) { return ok != 0; });
+        }
+
 // ProcessedAsset的序列化方法实现
         bool ProcessedAsset::Serialize(const char* output_path) const {
             AssetSerializer serializer;
@@ -1093,5 +1685,176 @@ namespace spartan {
             return serializer.DeserializeFromFile(*this, input_path);
         }
 
+// 加载基准
+        void RunAssetLoadBenchmark(const char* gltf_path) {
+            ProcessedAsset source;
+            GltfProcessor processor;
+            if (!processor.ProcessFile(gltf_path, source)) {
+                std::cerr << "加载基准: 处理glTF失败: " << processor.GetLastError() << std::endl;
+                return;
+            }
+
+            // 临时文件写到系统临时目录，基准结束（包括中途失败）时删除；
+            // 守卫先于读取器构造，析构时映射已经释放
+            std::error_code ec;
+            const std::filesystem::path temp_dir = std::filesystem::temp_directory_path(ec);
+            const std::string stem = std::filesystem::path(gltf_path).stem().string();
+            const std::string sprt_path = (temp_dir / (stem + ".bench.sprt")).string();
+            const std::string compressed_path = (temp_dir / (stem + ".bench.lz.sprt")).string();
+            const std::string stored_path = (temp_dir / (stem + ".bench.stored.sprt")).string();
+            struct TempFiles {
+                std::vector<std::string> paths;
+                ~TempFiles() {
+                    for (const auto& path : paths) {
+                        std::error_code remove_ec;
+                        std::filesystem::remove(path, remove_ec);
+                    }
+                }
+            } temp_files{{sprt_path, compressed_path, stored_path}};
+
+            AssetSerializer writer;
+            auto write_start = std::chrono::high_resolution_clock::now();
+            if (!writer.SerializeToFile(source, sprt_path.c_str())) {
+                std::cerr << "加载基准: 写入失败: " << writer.GetLastError() << std::endl;
+                return;
+            }
+            double write_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - write_start).count();
+            writer.SetCompressionEnabled(true);
+            auto compress_start = std::chrono::high_resolution_clock::now();
+            if (!writer.SerializeToFile(source, compressed_path.c_str())) {
+                std::cerr << "加载基准: 写入失败: " << writer.GetLastError() << std::endl;
+                return;
+            }
+            double compress_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - compress_start).count();
+            source = ProcessedAsset();
+
+            auto file_size = [](const std::string& path) {
+                std::ifstream file(path, std::ios::binary | std::ios::ate);
+                return file.is_open() ? static_cast<size_t>(file.tellg()) : size_t(0);
+            };
+            std::cout << "=== 资产加载基准: " << sprt_path << " ===" << std::endl;
+            std::cout << std::fixed << std::setprecision(2)
+                      << "  文件大小: 未压缩 " << file_size(sprt_path) / 1024 << " KB (写入 " << write_ms << " ms), 压缩 "
+                      << file_size(compressed_path) / 1024 << " KB (写入 " << compress_ms << " ms)"
+                      << std::defaultfloat << std::endl;
+
+            // 加载后读一遍所有网格数据，模拟GPU上传对内存的访问
+            auto run = [&](const char* label, const std::string& path, bool mapped) {
+                const size_t rss_before = GetResidentBytes();
+                auto start = std::chrono::high_resolution_clock::now();
+
+                ProcessedAsset asset;
+                AssetSerializer serializer;
+                serializer.SetMemoryMappingEnabled(mapped);
+                serializer.SetZeroCopyMeshesEnabled(mapped);
+                if (!serializer.DeserializeFromFile(asset, path.c_str())) {
+                    std::cerr << "  " << label << ": 加载失败: " << serializer.GetLastError() << std::endl;
+                    return;
+                }
+                double load_ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::high_resolution_clock::now() - start).count();
+                const size_t rss_loaded = GetResidentBytes();
+
+                uint64_t checksum = 0;
+                for (const auto& [handle, mesh] : asset.meshes) {
+                    const uint8_t* vertices = mesh.GetVertexData();
+                    for (size_t i = 0; i < mesh.GetVertexDataSize(); i += 64) {
+                        checksum += vertices[i];
+                    }
+                    for (uint32_t i = 0; i < mesh.GetIndexCount(); i += 16) {
+                        checksum += mesh.GetIndex(i);
+                    }
+                }
+                double total_ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::high_resolution_clock::now() - start).count();
+                const size_t rss_touched = GetResidentBytes();
+
+                std::cout << std::fixed << std::setprecision(2)
+                          << "  " << label << ": 加载 " << load_ms << " ms, 加载+读取 " << total_ms << " ms"
+                          << ", 常驻内存增量 " << (rss_loaded - std::min(rss_loaded, rss_before)) / 1024 << " KB"
+                          << " (读取后 " << (rss_touched - std::min(rss_touched, rss_before)) / 1024 << " KB)"
+                          << std::defaultfloat << " [校验 " << checksum << "]" << std::endl;
+            };
+
+            run("按块读入+复制", sprt_path, false);
+            run("映射+零拷贝网格", sprt_path, true);
+            run("压缩+并行解压", compressed_path, true);
+
+            // 按需加载：打开只读索引和小块，网格在首次访问时才解压
+            auto lazy_start = std::chrono::high_resolution_clock::now();
+            ProcessedAsset resident;
+            AssetPackReader reader;
+            if (!reader.Open(compressed_path.c_str(), resident)) {
+                std::cerr << "  按需加载: 打开失败: " << reader.GetLastError() << std::endl;
+                return;
+            }
+            double open_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - lazy_start).count();
+            size_t loaded = 0;
+            for (MeshHandle handle : reader.GetMeshHandles()) {
+                loaded += reader.AcquireMesh(handle) ? 1 : 0;
+            }
+            double lazy_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - lazy_start).count();
+            std::cout << std::fixed << std::setprecision(2)
+                      << "  按需加载: 打开 " << open_ms << " ms, 加载全部 " << loaded << " 个网格 " << lazy_ms << " ms"
+                      << ", 常驻估算 " << reader.GetResidentBytes() / 1024 << " KB" << std::defaultfloat << std::endl;
+
+            // 存储回退往返检查：不可压缩的顶点配合少量可差分的索引，索引会选用过滤器，
+            // 但整块压缩后不更小而原样存储，映射和按需加载都必须能还原出原始数据
+            ProcessedAsset stored_source;
+            {
+                MeshData mesh;
+                mesh.format.attributes = VertexFormat::POSITION;
+                mesh.format.stride = 3 * sizeof(float);
+                mesh.format.attribute_map[VertexFormat::POSITION] = {0, 3, GL_FLOAT, false};
+                mesh.vertex_count = 64 * 1024 / mesh.format.stride;
+                mesh.vertex_buffer.resize(static_cast<size_t>(mesh.vertex_count) * mesh.format.stride);
+                std::mt19937 rng(11);
+                for (auto& byte : mesh.vertex_buffer) byte = static_cast<uint8_t>(rng());
+                for (uint32_t i = 0; i < 12; ++i) mesh.index_buffer.push_back(i);
+                MeshData::SubMesh submesh;
+                submesh.index_count = static_cast<uint32_t>(mesh.index_buffer.size());
+                mesh.submeshes.push_back(submesh);
+                stored_source.meshes.emplace(stored_source.handle_generator.Generate<MeshTag>(), std::move(mesh));
+            }
+            const MeshData& expected = stored_source.meshes.begin()->second;
+            auto same_mesh = [&](const MeshData& mesh) {
+                if (mesh.GetVertexDataSize() != expected.vertex_buffer.size() ||
+                    mesh.GetIndexCount() != expected.index_buffer.size() ||
+                    std::memcmp(mesh.GetVertexData(), expected.vertex_buffer.data(), expected.vertex_buffer.size()) != 0) {
+                    return false;
+                }
+                for (uint32_t i = 0; i < mesh.GetIndexCount(); ++i) {
+                    if (mesh.GetIndex(i) != expected.index_buffer[i]) return false;
+                }
+                return true;
+            };
+
+            writer.SetCompressionEnabled(true);
+            bool stored_ok = writer.SerializeToFile(stored_source, stored_path.c_str());
+            if (stored_ok) {
+                ProcessedAsset mapped;
+                AssetSerializer serializer;
+                serializer.SetMemoryMappingEnabled(true);
+                serializer.SetZeroCopyMeshesEnabled(true);
+                stored_ok = serializer.DeserializeFromFile(mapped, stored_path.c_str()) &&
+                            mapped.meshes.size() == 1 && same_mesh(mapped.meshes.begin()->second);
+            }
+            if (stored_ok) {
+                ProcessedAsset stored_resident;
+                AssetPackReader stored_reader;
+                stored_ok = stored_reader.Open(stored_path.c_str(), stored_resident) &&
+                            stored_reader.GetMeshHandles().size() == 1;
+                if (stored_ok) {
+                    auto mesh = stored_reader.AcquireMesh(stored_reader.GetMeshHandles()[0]);
+                    stored_ok = mesh && same_mesh(*mesh);
+                }
+            }
+            std::cout << "  存储回退往返: " << (stored_ok ? "一致" : "[往返不一致]") << std::endl;
+        }
+
     } // namespace asset
 } // namespace spartan
\ No newline at end of file
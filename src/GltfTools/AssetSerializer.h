@@ -1,10 +1,14 @@
 #pragma once
 
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 #include <fstream>
 #include "AssetTypes.h"
+#include "BlockCodec.h"
+#include "StreamFilter.h"
 #include "GltfTools.h"
+#include "MappedFile.h"
 
 namespace spartan {
     namespace asset {
@@ -12,7 +16,9 @@ namespace spartan {
 // 序列化文件格式定义
         struct AssetFileHeader {
             static constexpr uint32_t MAGIC = 0x54525053; // 'SPRT'
-            static constexpr uint32_t VERSION = 1;
+            static constexpr uint32_t VERSION = 9; // v2: 顶点量化和位置反量化变换; v3: 16位索引; v4: 纹理像素和mip链; v5: 对齐的块和数据段; v6: 分块压缩; v7: 流过滤器; v8: 条目索引; v9: 句柄生成器和根运动关节
+            static constexpr uint32_t BLOB_ALIGNMENT = 16; // 块起始和顶点/索引/像素数据段按此对齐，映射后可直接使用
+            static constexpr uint32_t FLAG_COMPRESSED = 1; // 至少一个块被压缩
 
             uint32_t magic;
             uint32_t version;
@@ -32,6 +38,7 @@ namespace spartan {
             ANIMATIONS,
             SCENE_NODES,
             STRING_TABLE,
+            ITEM_INDEX,
             CHUNK_COUNT
         };
 
@@ -41,7 +48,26 @@ namespace spartan {
             uint32_t item_count;
             uint64_t offset;
             uint64_t size;
-            uint64_t uncompressed_size; // 如果压缩的话
+            uint64_t uncompressed_size; // 解压后的大小，未压缩时等于size
+            ChunkCodec codec;
+            uint32_t block_size; // 压缩块按此大小切分成独立压缩的子块，可并行解压
+        };
+
+        /**
+         * 压缩块的数据布局：
+         * uint32 子块数量 | uint32 每个子块的压缩大小（最高位为1表示该子块原样存储） | 子块数据依次排列
+         */
+        constexpr uint32_t COMPRESSED_BLOCK_SIZE = 256 * 1024;
+        constexpr uint32_t STORED_BLOCK_BIT = 0x80000000u;
+
+// 条目索引：网格/动画在（解压后的）块内的位置，按需加载时只读取和解压覆盖该范围的子块
+        struct ItemIndexEntry {
+            ChunkType chunk;
+            uint32_t handle_id;
+            uint32_t handle_generation;
+            uint32_t reserved;
+            uint64_t offset;
+            uint64_t size;
         };
 
 // 字符串表（避免重复存储字符串）
@@ -63,6 +89,8 @@ namespace spartan {
 
 // 序列化器主类
         class AssetSerializer {
+            friend class AssetPackReader;
+
         public:
             AssetSerializer() = default;
             ~AssetSerializer() = default;
@@ -73,21 +101,40 @@ namespace spartan {
             // 从文件反序列化
             bool DeserializeFromFile(ProcessedAsset& asset, const char* filepath);
 
+            // 读取方式：默认映射整个文件；关闭时按块读入临时缓冲（旧路径，用于对比）
+            void SetMemoryMappingEnabled(bool enabled) { enable_memory_mapping_ = enabled; }
+
+            // 零拷贝网格：网格顶点/索引直接指向映射内存（需要开启映射），上传GPU后由网格释放
+            void SetZeroCopyMeshesEnabled(bool enabled) { enable_zero_copy_meshes_ = enabled; }
+
             // 获取错误信息
             const std::string& GetLastError() const { return last_error_; }
 
-            // 设置压缩选项
-            void SetCompressionEnabled(bool enabled) { enable_compression_ = enabled; }
+            // 设置压缩选项：开启后网格/纹理/动画用LZ_HIGH（移动端闪存带宽比CPU更紧张，解压速度与LZ_FAST相同），
+            // 其余小块用LZ_FAST；关闭后所有块原样存储
+            void SetCompressionEnabled(bool enabled);
+
+            // 单独指定某个块的编码方式
+            void SetChunkCodec(ChunkType type, ChunkCodec codec) { chunk_codecs_[static_cast<size_t>(type)] = codec; }
+            ChunkCodec GetChunkCodec(ChunkType type) const { return chunk_codecs_[static_cast<size_t>(type)]; }
+
+            // 压缩/解压子块使用的线程数，0 = 硬件线程数
+            void SetWorkerThreadCount(uint32_t count) { worker_thread_count_ = count; }
+
+            // 流过滤器：压缩的块中顶点按字节平面、索引按差分+zigzag、节点关键帧按异或差分存储，
+            // 顶点/索引只在试压缩更小时使用；原样存储的块不过滤，保持可零拷贝
+            void SetStreamFiltersEnabled(bool enabled) { enable_stream_filters_ = enabled; }
 
         private:
             // 序列化各种资源
-            void SerializeMeshes(const ProcessedAsset& asset, std::vector<uint8_t>& buffer);
+            void SerializeMeshes(const ProcessedAsset& asset, std::vector<uint8_t>& buffer, bool filter_streams);
             void SerializeMaterials(const ProcessedAsset& asset, std::vector<uint8_t>& buffer);
             void SerializeTextures(const ProcessedAsset& asset, std::vector<uint8_t>& buffer);
             void SerializeSkeletons(const ProcessedAsset& asset, std::vector<uint8_t>& buffer);
             void SerializeAnimations(const ProcessedAsset& asset, std::vector<uint8_t>& buffer);
             void SerializeSceneNodes(const ProcessedAsset& asset, std::vector<uint8_t>& buffer);
             void SerializeMetadata(const ProcessedAsset& asset, std::vector<uint8_t>& buffer);
+            void SerializeItemIndex(std::vector<uint8_t>& buffer);
 
             // 反序列化各种资源
             bool DeserializeMeshes(ProcessedAsset& asset, const uint8_t* data, size_t size);
@@ -97,11 +144,40 @@ namespace spartan {
             bool DeserializeAnimations(ProcessedAsset& asset, const uint8_t* data, size_t size);
             bool DeserializeSceneNodes(ProcessedAsset& asset, const uint8_t* data, size_t size);
             bool DeserializeMetadata(ProcessedAsset& asset, const uint8_t* data, size_t size);
+            bool DeserializeItemIndex(const uint8_t* data, size_t size, std::vector<ItemIndexEntry>& entries);
+
+            // 单个网格/动画（整体加载和按需加载共用）
+            bool DeserializeMesh(const uint8_t*& ptr, size_t& remaining, MeshHandle& handle, MeshData& mesh);
+            bool DeserializeAnimation(const uint8_t*& ptr, size_t& remaining, AnimationHandle& handle, AnimationData& anim);
+
+            // 文件头/块表校验
+            bool ValidateFileHeader(const AssetFileHeader& file_header, size_t file_size);
+            bool ValidateChunkHeaders(const std::vector<ChunkHeader>& chunk_headers, size_t file_size);
+
+            // 解压（如需要）并反序列化一个块；writable_data非空表示原始块数据在可写的缓冲中
+            bool DeserializeChunk(ProcessedAsset& asset, const ChunkHeader& header, const uint8_t* chunk_data,
+                                  uint8_t* writable_data, const std::shared_ptr<const void>& mapping);
+
+            // 当前可读的块窗口：data对应块内偏移origin，长度size；owner供零拷贝网格持有
+            void BeginChunkWindow(const uint8_t* data, uint8_t* writable_data, uint64_t origin, size_t size,
+                                  std::shared_ptr<const void> owner);
+            void EndChunkWindow();
+
+            // 按各块中大块数据（顶点、索引、像素、关键帧、OZZ对象）的大小预留容量，写入期间不再重新分配
+            void ReserveChunks(const ProcessedAsset& asset, std::vector<std::vector<uint8_t>>& chunks) const;
 
             // 工具函数
             template<typename T>
             void Write(std::vector<uint8_t>& buffer, const T& value);
 
+            // 连续数组整体写入
+            template<typename T>
+            void WriteArray(std::vector<uint8_t>& buffer, const T* values, size_t count);
+
+            // OZZ对象：uint32大小 + 对象数据，直接序列化到块缓冲
+            template<typename T>
+            void WriteOzzObject(std::vector<uint8_t>& buffer, const T& object);
+
             template<typename T>
             bool Read(const uint8_t*& data, size_t& remaining, T& value);
 
@@ -109,10 +185,32 @@ namespace spartan {
             void WriteString(std::vector<uint8_t>& buffer, const ozz::string& str);
             bool ReadString(const uint8_t*& data, size_t& remaining, std::string& str);
 
-            // 压缩/解压（可选）
-            bool CompressChunk(const std::vector<uint8_t>& input, std::vector<uint8_t>& output);
-            bool DecompressChunk(const uint8_t* input, size_t input_size,
-                                 std::vector<uint8_t>& output, size_t output_size);
+            // 对齐的数据段：记录大小和相对块起始的偏移，数据按BLOB_ALIGNMENT对齐紧随其后
+            void WriteBlob(std::vector<uint8_t>& buffer, const void* data, uint32_t size);
+            bool ReadBlob(const uint8_t*& data, size_t& remaining, const uint8_t*& blob, uint32_t& size);
+
+            // 过滤后的数据段：写入时选择过滤器并记录；读取时在可写的块缓冲内原地解码
+            void WriteVertexBlob(std::vector<uint8_t>& buffer, const MeshData& mesh, bool filter);
+            void WriteIndexBlob(std::vector<uint8_t>& buffer, const void* data, uint32_t count, uint32_t index_size, bool filter);
+            bool UnfilterBlob(StreamFilter filter, const uint8_t* blob, size_t count, size_t element_size);
+
+            // 关键帧数组（count个关键帧，每个components个float）
+            void WriteKeyframes(std::vector<uint8_t>& buffer, const float* values, size_t count, size_t components, bool filter);
+            bool ReadKeyframes(const uint8_t*& data, size_t& remaining, float* values, size_t count, size_t components, bool filter);
+
+            // 压缩/解压（按子块并行）
+            struct BlockTable {
+                size_t block_size = 0;
+                size_t output_size = 0;
+                const uint8_t* data = nullptr;    // 第一个子块的数据
+                std::vector<uint32_t> entries;
+                std::vector<size_t> offsets;      // 各子块相对data的偏移
+            };
+            bool CompressChunk(const std::vector<uint8_t>& input, ChunkCodec codec, std::vector<uint8_t>& output);
+            bool DecompressChunk(const uint8_t* input, const ChunkHeader& header, std::vector<uint8_t>& output);
+            bool ParseBlockTable(const uint8_t* input, const ChunkHeader& header, BlockTable& table);
+            // 把子块[first, last)依次解压到output
+            bool DecompressBlocks(const BlockTable& table, size_t first, size_t last, uint8_t* output);
 
             // 错误处理
             void SetError(const std::string& error);
@@ -120,18 +218,51 @@ namespace spartan {
         private:
             StringTable string_table_;
             std::string last_error_;
-            bool enable_compression_ = false;
+            ChunkCodec chunk_codecs_[static_cast<size_t>(ChunkType::CHUNK_COUNT)] = {};
+            uint32_t worker_thread_count_ = 0;
+            bool enable_memory_mapping_ = true;
+            bool enable_zero_copy_meshes_ = false;
+            bool enable_stream_filters_ = true;
+
+            // 反序列化当前块的窗口：chunk_base_对应块内偏移chunk_origin_（数据段偏移相对于整个块）；
+            // 块在自有缓冲中时可写，用于原地解码过滤器
+            const uint8_t* chunk_base_ = nullptr;
+            uint8_t* chunk_writable_base_ = nullptr;
+            uint64_t chunk_origin_ = 0;
+            uint64_t chunk_end_ = 0;
+            // 零拷贝时网格共享的存储：未压缩块为文件映射，压缩块为解压缓冲
+            std::shared_ptr<const void> blob_owner_;
+
+            // 序列化时记录的条目位置
+            std::vector<ItemIndexEntry> item_index_;
 
             // 临时缓冲区，避免频繁分配
             std::vector<uint8_t> temp_buffer_;
+            std::vector<uint32_t> keyframe_buffer_;
         };
 
+        /**
+         * 加载基准：把glTF处理后写成未压缩和压缩两份.sprt，分别用按块读入+复制、映射+零拷贝网格、
+         * 压缩+并行解压三种方式加载，输出文件大小、耗时和加载后常驻内存的增量；
+         * 最后用AssetPackReader按需打开压缩文件，输出打开耗时；
+         * 另外用不可压缩的网格检查压缩回退为原样存储的块能否往返
+         */
+        void RunAssetLoadBenchmark(const char* gltf_path);
+
 // 内联实现
         template<typename T>
         inline void AssetSerializer::Write(std::vector<uint8_t>& buffer, const T& value) {
-            size_t offset = buffer.size();
-            buffer.resize(offset + sizeof(T));
-            std::memcpy(buffer.data() + offset, &value, sizeof(T));
+            static_assert(std::is_trivially_copyable<T>::value, "Write requires a trivially copyable type");
+            const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+        }
+
+        template<typename T>
+        inline void AssetSerializer::WriteArray(std::vector<uint8_t>& buffer, const T* values, size_t count) {
+            static_assert(std::is_trivially_copyable<T>::value, "WriteArray requires a trivially copyable type");
+            if (count == 0) return;
+            const auto* bytes = reinterpret_cast<const uint8_t*>(values);
+            buffer.insert(buffer.end(), bytes, bytes + count * sizeof(T));
         }
 
         template<typename T>
@@ -34,6 +34,9 @@
 #define GL_UNSIGNED_BYTE 0x1401
 #define GL_UNSIGNED_SHORT 0x1403
 #define GL_UNSIGNED_INT 0x1405
+#define GL_BYTE 0x1400
+#define GL_SHORT 0x1402
+#define GL_HALF_FLOAT 0x140B
 #endif
 
 namespace spartan {
@@ -83,6 +86,7 @@ namespace spartan {
         using SkeletonHandle = Handle<struct SkeletonTag>;
         using AnimationHandle = Handle<struct AnimationTag>;
         using ShaderHandle = Handle<struct ShaderTag>;
+        using PackHandle = Handle<struct PackTag>;      // 运行时资源包（见ResourceManager）
 
 // =========================================================================
 // 基础数学类型转换
@@ -0,0 +1,311 @@
+#include "BlockCodec.h"
+
+#include <cstring>
+#include <vector>
+
+namespace spartan {
+    namespace asset {
+
+        namespace {
+
+            constexpr size_t MIN_MATCH = 4;
+            constexpr size_t LAST_LITERALS = 5;     // 末尾至少保留的字面量
+            constexpr size_t MATCH_SEARCH_END = 12; // 距末尾不足该长度时不再查找匹配
+            constexpr size_t MAX_DISTANCE = 65535;
+
+            constexpr uint32_t FAST_HASH_LOG = 14;
+            constexpr uint32_t HIGH_HASH_LOG = 16;
+            constexpr uint32_t HIGH_MAX_CHAIN = 64;
+            constexpr uint32_t WINDOW_MASK = 0xFFFF;
+
+            inline uint32_t Read32(const uint8_t* p) {
+                uint32_t value;
+                std::memcpy(&value, p, sizeof(value));
+                return value;
+            }
+
+            inline uint32_t Hash4(uint32_t sequence, uint32_t hash_log) {
+                return (sequence * 2654435761u) >> (32 - hash_log);
+            }
+
+            // 输出序列，空间不足时返回false
+            class SequenceWriter {
+            public:
+                SequenceWriter(uint8_t* dst, size_t capacity) : op_(dst), begin_(dst), end_(dst + capacity) {}
+
+                bool Emit(const uint8_t* literals, size_t literal_count, size_t offset, size_t match_length) {
+                    const size_t match_code = match_length - MIN_MATCH;
+                    if (!Reserve(1 + literal_count / 255 + 1 + literal_count + 2 + match_code / 255 + 1)) {
+                        return false;
+                    }
+                    uint8_t* token = op_++;
+                    *token = static_cast<uint8_t>((literal_count >= 15 ? 15 : literal_count) << 4);
+                    WriteLength(literal_count);
+                    std::memcpy(op_, literals, literal_count);
+                    op_ += literal_count;
+
+                    op_[0] = static_cast<uint8_t>(offset & 0xFF);
+                    op_[1] = static_cast<uint8_t>(offset >> 8);
+                    op_ += 2;
+
+                    *token |= static_cast<uint8_t>(match_code >= 15 ? 15 : match_code);
+                    WriteLength(match_code);
+                    return true;
+                }
+
+                bool EmitLast(const uint8_t* literals, size_t literal_count) {
+                    if (!Reserve(1 + literal_count / 255 + 1 + literal_count)) {
+                        return false;
+                    }
+                    *op_++ = static_cast<uint8_t>((literal_count >= 15 ? 15 : literal_count) << 4);
+                    WriteLength(literal_count);
+                    std::memcpy(op_, literals, literal_count);
+                    op_ += literal_count;
+                    return true;
+                }
+
+                size_t Size() const { return static_cast<size_t>(op_ - begin_); }
+
+            private:
+                bool Reserve(size_t bytes) const { return static_cast<size_t>(end_ - op_) >= bytes; }
+
+                void WriteLength(size_t length) {
+                    if (length < 15) return;
+                    length -= 15;
+                    while (length >= 255) {
+                        *op_++ = 255;
+                        length -= 255;
+                    }
+                    *op_++ = static_cast<uint8_t>(length);
+                }
+
+                uint8_t* op_;
+                uint8_t* begin_;
+                uint8_t* end_;
+            };
+
+            size_t CountMatch(const uint8_t* a, const uint8_t* b, const uint8_t* b_limit) {
+                const uint8_t* start = b;
+                while (b < b_limit && *a == *b) {
+                    ++a;
+                    ++b;
+                }
+                return static_cast<size_t>(b - start);
+            }
+
+            size_t CompressFast(const uint8_t* src, size_t size, SequenceWriter& writer) {
+                std::vector<uint32_t> table(size_t(1) << FAST_HASH_LOG, 0);
+                const uint8_t* match_limit = src + size - LAST_LITERALS;
+                const size_t search_end = size - MATCH_SEARCH_END;
+
+                size_t anchor = 0;
+                size_t ip = 0;
+                while (ip < search_end) {
+                    const uint32_t sequence = Read32(src + ip);
+                    const uint32_t h = Hash4(sequence, FAST_HASH_LOG);
+                    size_t ref = table[h];
+                    table[h] = static_cast<uint32_t>(ip);
+
+                    if (ref >= ip || ip - ref > MAX_DISTANCE || Read32(src + ref) != sequence) {
+                        // 连续未命中时加大步长，跳过不可压缩的数据
+                        ip += 1 + ((ip - anchor) >> 6);
+                        continue;
+                    }
+
+                    // 向前扩展
+                    while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+                        --ip;
+                        --ref;
+                    }
+
+                    size_t length = MIN_MATCH + CountMatch(src + ref + MIN_MATCH, src + ip + MIN_MATCH, match_limit);
+                    if (!writer.Emit(src + anchor, ip - anchor, ip - ref, length)) {
+                        return 0;
+                    }
+                    ip += length;
+                    anchor = ip;
+
+                    if (ip - 2 < search_end) {
+                        table[Hash4(Read32(src + ip - 2), FAST_HASH_LOG)] = static_cast<uint32_t>(ip - 2);
+                    }
+                }
+
+                if (!writer.EmitLast(src + anchor, size - anchor)) {
+                    return 0;
+                }
+                return writer.Size();
+            }
+
+            class HashChain {
+            public:
+                HashChain(const uint8_t* src, size_t size)
+                        : src_(src), size_(size), head_(size_t(1) << HIGH_HASH_LOG, -1), chain_(WINDOW_MASK + 1, -1) {}
+
+                // 把next_到pos之前的位置加入链表
+                void InsertUntil(size_t pos) {
+                    for (; next_ < pos && next_ + MIN_MATCH <= size_; ++next_) {
+                        const uint32_t h = Hash4(Read32(src_ + next_), HIGH_HASH_LOG);
+                        chain_[next_ & WINDOW_MASK] = head_[h];
+                        head_[h] = static_cast<int64_t>(next_);
+                    }
+                }
+
+                // 查找ip处的最长匹配
+                size_t FindBest(size_t ip, const uint8_t* match_limit, size_t& best_ref) {
+                    InsertUntil(ip);
+                    size_t best_length = 0;
+                    int64_t candidate = head_[Hash4(Read32(src_ + ip), HIGH_HASH_LOG)];
+                    for (uint32_t depth = 0; candidate >= 0 && depth < HIGH_MAX_CHAIN; ++depth) {
+                        const size_t ref = static_cast<size_t>(candidate);
+                        if (ip - ref > MAX_DISTANCE) break;
+
+                        // 先比较当前最优长度处的字节，快速排除
+                        if (src_[ref + best_length] == src_[ip + best_length] && Read32(src_ + ref) == Read32(src_ + ip)) {
+                            size_t length = MIN_MATCH + CountMatch(src_ + ref + MIN_MATCH, src_ + ip + MIN_MATCH, match_limit);
+                            if (length > best_length) {
+                                best_length = length;
+                                best_ref = ref;
+                                if (src_ + ip + length >= match_limit) break;
+                            }
+                        }
+
+                        int64_t next = chain_[ref & WINDOW_MASK];
+                        if (next >= candidate) break;  // 环形缓冲已被覆盖
+                        candidate = next;
+                    }
+                    return best_length >= MIN_MATCH ? best_length : 0;
+                }
+
+            private:
+                const uint8_t* src_;
+                size_t size_;
+                size_t next_ = 0;
+                std::vector<int64_t> head_;
+                std::vector<int64_t> chain_;
+            };
+
+            size_t CompressHigh(const uint8_t* src, size_t size, SequenceWriter& writer) {
+                HashChain chain(src, size);
+                const uint8_t* match_limit = src + size - LAST_LITERALS;
+                const size_t search_end = size - MATCH_SEARCH_END;
+
+                size_t anchor = 0;
+                size_t ip = 0;
+                while (ip < search_end) {
+                    size_t ref = 0;
+                    size_t length = chain.FindBest(ip, match_limit, ref);
+                    if (length == 0) {
+                        ++ip;
+                        continue;
+                    }
+
+                    // 惰性匹配：下一个位置的匹配明显更长时先输出一个字面量
+                    while (ip + 1 < search_end) {
+                        size_t next_ref = 0;
+                        size_t next_length = chain.FindBest(ip + 1, match_limit, next_ref);
+                        if (next_length <= length + 1) break;
+                        ++ip;
+                        ref = next_ref;
+                        length = next_length;
+                    }
+
+                    if (!writer.Emit(src + anchor, ip - anchor, ip - ref, length)) {
+                        return 0;
+                    }
+                    ip += length;
+                    anchor = ip;
+                }
+
+                if (!writer.EmitLast(src + anchor, size - anchor)) {
+                    return 0;
+                }
+                return writer.Size();
+            }
+
+        } // namespace
+
+        const char* GetChunkCodecName(ChunkCodec codec) {
+            switch (codec) {
+                case ChunkCodec::STORE: return "store";
+                case ChunkCodec::LZ_FAST: return "lz-fast";
+                case ChunkCodec::LZ_HIGH: return "lz-high";
+            }
+            return "unknown";
+        }
+
+        size_t LzCompressBound(size_t size) {
+            return size + size / 255 + 16;
+        }
+
+        size_t LzCompress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity, bool high_ratio) {
+            if (size == 0) {
+                return 0;
+            }
+
+            SequenceWriter writer(dst, capacity);
+            if (size < MATCH_SEARCH_END + 1) {
+                return writer.EmitLast(src, size) ? writer.Size() : 0;
+            }
+            return high_ratio ? CompressHigh(src, size, writer) : CompressFast(src, size, writer);
+        }
+
+        bool LzDecompress(const uint8_t* src, size_t size, uint8_t* dst, size_t decompressed_size) {
+            const uint8_t* ip = src;
+            const uint8_t* const iend = src + size;
+            uint8_t* op = dst;
+            uint8_t* const oend = dst + decompressed_size;
+
+            auto read_length = [&](size_t& length) {
+                if (length != 15) return true;
+                uint8_t byte;
+                do {
+                    if (ip >= iend) return false;
+                    byte = *ip++;
+                    length += byte;
+                } while (byte == 255);
+                return true;
+            };
+
+            while (ip < iend) {
+                const uint8_t token = *ip++;
+
+                size_t literal_count = token >> 4;
+                if (!read_length(literal_count)) return false;
+                if (literal_count > static_cast<size_t>(iend - ip) ||
+                    literal_count > static_cast<size_t>(oend - op)) {
+                    return false;
+                }
+                std::memcpy(op, ip, literal_count);
+                ip += literal_count;
+                op += literal_count;
+
+                // 最后一个序列只有字面量
+                if (ip == iend) break;
+
+                if (iend - ip < 2) return false;
+                const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+                ip += 2;
+                if (offset == 0 || offset > static_cast<size_t>(op - dst)) return false;
+
+                size_t match_length = token & 0x0F;
+                if (!read_length(match_length)) return false;
+                match_length += MIN_MATCH;
+                if (match_length > static_cast<size_t>(oend - op)) return false;
+
+                const uint8_t* match = op - offset;
+                if (offset >= match_length) {
+                    std::memcpy(op, match, match_length);
+                    op += match_length;
+                } else {
+                    // 重叠复制（重复模式），必须逐字节
+                    for (size_t i = 0; i < match_length; ++i) {
+                        *op++ = *match++;
+                    }
+                }
+            }
+
+            return op == oend;
+        }
+
+    } // namespace asset
+} // namespace spartan
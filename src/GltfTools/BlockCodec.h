@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace spartan {
+    namespace asset {
+
+// 块编码方式（按数据块选择）
+        enum class ChunkCodec : uint32_t {
+            STORE = 0,     // 不压缩
+            LZ_FAST = 1,   // 单候选哈希匹配，压缩快
+            LZ_HIGH = 2,   // 哈希链 + 惰性匹配，压缩慢但比率更高；解压速度与LZ_FAST相同
+        };
+
+        const char* GetChunkCodecName(ChunkCodec codec);
+
+        /**
+         * LZ块格式（与LZ4块格式同构）：
+         * 每个序列为 token(高4位字面量长度, 低4位匹配长度-4) [扩展字面量长度] 字面量 偏移(u16) [扩展匹配长度]，
+         * 长度为15时后续每个255字节累加直到遇到小于255的字节；最后一个序列只有字面量。
+         */
+        size_t LzCompressBound(size_t size);
+
+        /**
+         * @return 压缩后的字节数；dst空间不足或输入为空时返回0
+         */
+        size_t LzCompress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity, bool high_ratio);
+
+        /**
+         * 安全解压：所有读写都做边界检查
+         * @return 输出恰好为decompressed_size字节时返回true
+         */
+        bool LzDecompress(const uint8_t* src, size_t size, uint8_t* dst, size_t decompressed_size);
+
+    } // namespace asset
+} // namespace spartan
@@ -1,4 +1,6 @@
 #include "GltfTools.h"
+#include "MeshOptimizer.h"
+#include "ParallelFor.h"
 #include <set>
 
 // 禁用tiny_gltf中json.hpp的警告
@@ -16,6 +18,9 @@
 #pragma clang diagnostic pop
 #endif
 
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include "stb_image_resize2.h"
+
 #include "ozz/animation/offline/animation_builder.h"
 #include "ozz/animation/offline/raw_animation.h"
 #include "ozz/animation/offline/skeleton_builder.h"
@@ -29,6 +34,7 @@
 #include <chrono>
 #include <fstream>
 #include <cfloat>
+#include <type_traits>
 
 // GLM额外头文件
 #include <glm/gtc/type_ptr.hpp>
@@ -36,46 +42,6 @@
 
 namespace spartan {
     namespace asset {
-// VertexKey实现
-        size_t GltfProcessor::Impl::ProcessingContext::VertexKey::Hash() const {
-            size_t hash = 0;
-
-            // FNV-1a hash
-            auto hash_combine = [&hash](const void* data, size_t size) {
-                const uint8_t* bytes = static_cast<const uint8_t*>(data);
-                for (size_t i = 0; i < size; ++i) {
-                    hash ^= bytes[i];
-                    hash *= 0x100000001b3;
-                }
-            };
-
-            hash_combine(&position, sizeof(position));
-            hash_combine(&normal, sizeof(normal));
-            hash_combine(&uv0, sizeof(uv0));
-            hash_combine(joints, sizeof(joints));
-            hash_combine(&weights, sizeof(weights));
-
-            return hash;
-        }
-
-        bool GltfProcessor::Impl::ProcessingContext::VertexKey::operator==(const VertexKey& other) const {
-            const float eps = 1e-6f;
-            return
-                    std::abs(position.x - other.position.x) < eps &&
-                    std::abs(position.y - other.position.y) < eps &&
-                    std::abs(position.z - other.position.z) < eps &&
-                    std::abs(normal.x - other.normal.x) < eps &&
-                    std::abs(normal.y - other.normal.y) < eps &&
-                    std::abs(normal.z - other.normal.z) < eps &&
-                    std::abs(uv0.x - other.uv0.x) < eps &&
-                    std::abs(uv0.y - other.uv0.y) < eps &&
-                    std::memcmp(joints, other.joints, sizeof(joints)) == 0 &&
-                    std::abs(weights.x - other.weights.x) < eps &&
-                    std::abs(weights.y - other.weights.y) < eps &&
-                    std::abs(weights.z - other.weights.z) < eps &&
-                    std::abs(weights.w - other.weights.w) < eps;
-        }
-
 // GltfProcessor实现
         GltfProcessor::GltfProcessor(const ProcessConfig& config)
                 : impl_(std::make_unique<Impl>()), config_(config) {}
@@ -88,9 +54,17 @@ namespace spartan {
             tinygltf::TinyGLTF loader;
             std::string err, warn;
 
-            // 设置自定义图像加载器（避免加载图像数据到内存）
-            loader.SetImageLoader([](tinygltf::Image*, int, std::string*, std::string*,
-                                     int, int, const unsigned char*, int, void*) {
+            // 自定义图像加载器：只保存编码后的字节，解码在ProcessTextures中并行进行
+            encoded_images.clear();
+            loader.SetImageLoader([this](tinygltf::Image*, int image_index, std::string*, std::string*,
+                                         int, int, const unsigned char* bytes, int size, void*) {
+                if (image_index < 0) {
+                    return true;
+                }
+                if (static_cast<size_t>(image_index) >= encoded_images.size()) {
+                    encoded_images.resize(image_index + 1);
+                }
+                encoded_images[image_index].assign(bytes, bytes + size);
                 return true;
             }, nullptr);
 
@@ -116,7 +90,147 @@ namespace spartan {
         }
 
 // 处理纹理
+        namespace {
+
+            // 解码后的图像，pixels按TextureData::pixels的布局保存全部mip级别
+            struct DecodedImage {
+                uint32_t width = 0;
+                uint32_t height = 0;
+                uint32_t channels = 0;
+                uint32_t mip_levels = 0;
+                std::vector<uint8_t> pixels;
+                std::string error;
+            };
+
+            stbir_pixel_layout GetPixelLayout(uint32_t channels) {
+                switch (channels) {
+                    case 1: return STBIR_1CHANNEL;
+                    case 2: return STBIR_2CHANNEL;
+                    case 3: return STBIR_RGB;
+                    default: return STBIR_RGBA;
+                }
+            }
+
+            bool ResizePixels(const uint8_t* src, uint32_t src_w, uint32_t src_h,
+                              uint8_t* dst, uint32_t dst_w, uint32_t dst_h,
+                              uint32_t channels, bool srgb) {
+                const stbir_pixel_layout layout = GetPixelLayout(channels);
+                const int src_stride = static_cast<int>(src_w * channels);
+                const int dst_stride = static_cast<int>(dst_w * channels);
+                if (srgb) {
+                    return stbir_resize_uint8_srgb(src, src_w, src_h, src_stride,
+                                                   dst, dst_w, dst_h, dst_stride, layout) != nullptr;
+                }
+                return stbir_resize_uint8_linear(src, src_w, src_h, src_stride,
+                                                 dst, dst_w, dst_h, dst_stride, layout) != nullptr;
+            }
+
+            // 解码、按max_size缩小并（可选）生成mip链，只访问自己的输入和输出，可在工作线程上执行
+            void DecodeImage(const std::vector<uint8_t>& encoded, uint32_t max_size, bool generate_mips,
+                             bool srgb, DecodedImage& out) {
+                if (encoded.empty()) {
+                    out.error = "no image data";
+                    return;
+                }
+
+                int w = 0, h = 0, comp = 0;
+                stbi_uc* decoded = stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()),
+                                                         &w, &h, &comp, 0);
+                if (!decoded) {
+                    const char* reason = stbi_failure_reason();
+                    out.error = reason ? reason : "decode failed";
+                    return;
+                }
+
+                out.channels = static_cast<uint32_t>(comp);
+                out.width = static_cast<uint32_t>(w);
+                out.height = static_cast<uint32_t>(h);
+
+                // 长边超过max_size时按比例缩小
+                if (max_size > 0 && std::max(out.width, out.height) > max_size) {
+                    float scale = static_cast<float>(max_size) / static_cast<float>(std::max(out.width, out.height));
+                    out.width = std::max(1u, static_cast<uint32_t>(out.width * scale));
+                    out.height = std::max(1u, static_cast<uint32_t>(out.height * scale));
+                }
+
+                out.mip_levels = 1;
+                if (generate_mips) {
+                    for (uint32_t size = std::max(out.width, out.height); size > 1; size >>= 1) {
+                        out.mip_levels++;
+                    }
+                }
+
+                // 先按mip链总大小一次分配
+                TextureData layout;
+                layout.width = out.width;
+                layout.height = out.height;
+                layout.channels = out.channels;
+                out.pixels.resize(layout.GetMipOffset(out.mip_levels));
+
+                bool ok = true;
+                if (out.width == static_cast<uint32_t>(w) && out.height == static_cast<uint32_t>(h)) {
+                    std::memcpy(out.pixels.data(), decoded, layout.GetMipSize(0));
+                } else {
+                    ok = ResizePixels(decoded, w, h, out.pixels.data(), out.width, out.height, out.channels, srgb);
+                }
+                stbi_image_free(decoded);
+
+                // 每一级从上一级缩小得到
+                size_t prev_offset = 0;
+                for (uint32_t level = 1; ok && level < out.mip_levels; ++level) {
+                    size_t offset = prev_offset + layout.GetMipSize(level - 1);
+                    ok = ResizePixels(out.pixels.data() + prev_offset,
+                                      layout.GetMipWidth(level - 1), layout.GetMipHeight(level - 1),
+                                      out.pixels.data() + offset,
+                                      layout.GetMipWidth(level), layout.GetMipHeight(level),
+                                      out.channels, srgb);
+                    prev_offset = offset;
+                }
+
+                if (!ok) {
+                    out.pixels.clear();
+                    out.mip_levels = 0;
+                    out.error = "resize failed";
+                }
+            }
+
+        } // namespace
+
         bool GltfProcessor::Impl::ProcessTextures() {
+            // 基础色和自发光贴图按sRGB缩放
+            std::vector<uint8_t> image_is_srgb(model.images.size(), 0);
+            auto mark_srgb = [&](int texture_index) {
+                if (texture_index >= 0 && texture_index < static_cast<int>(model.textures.size())) {
+                    int source = model.textures[texture_index].source;
+                    if (source >= 0 && source < static_cast<int>(image_is_srgb.size())) {
+                        image_is_srgb[source] = 1;
+                    }
+                }
+            };
+            for (const auto& material : model.materials) {
+                mark_srgb(material.pbrMetallicRoughness.baseColorTexture.index);
+                mark_srgb(material.emissiveTexture.index);
+            }
+
+            // 按图像并行解码（多个纹理可以引用同一图像）
+            std::vector<DecodedImage> decoded(model.images.size());
+            ParallelFor(model.images.size(), [&](size_t i) {
+                static const std::vector<uint8_t> empty;
+                const auto& encoded = i < encoded_images.size() ? encoded_images[i] : empty;
+                DecodeImage(encoded, config->max_texture_size, config->generate_mipmaps,
+                            image_is_srgb[i] != 0, decoded[i]);
+            });
+            encoded_images.clear();
+            encoded_images.shrink_to_fit();
+
+            // 引用计数：最后一个引用者直接接管像素，避免复制
+            std::vector<uint32_t> image_refs(model.images.size(), 0);
+            for (const auto& gltf_texture : model.textures) {
+                if (gltf_texture.source >= 0 && gltf_texture.source < static_cast<int>(model.images.size())) {
+                    image_refs[gltf_texture.source]++;
+                }
+            }
+
             for (size_t i = 0; i < model.textures.size(); ++i) {
                 const auto& gltf_texture = model.textures[i];
 
@@ -127,21 +241,35 @@ namespace spartan {
 
                 if (gltf_texture.source >= 0 && gltf_texture.source < static_cast<int>(model.images.size())) {
                     const auto& image = model.images[gltf_texture.source];
+                    DecodedImage& source = decoded[gltf_texture.source];
                     texture.uri = image.uri.c_str();
-                    texture.width = image.width;
-                    texture.height = image.height;
-                    texture.channels = image.component;
+                    texture.is_srgb = image_is_srgb[gltf_texture.source] != 0;
+
+                    // 设置生成mipmap
+                    texture.generate_mipmaps = config->generate_mipmaps;
+
+                    if (source.pixels.empty()) {
+                        ReportWarning("Texture " + std::to_string(i) + " (" + image.uri + "): " + source.error);
+                        continue;
+                    }
+
+                    texture.width = source.width;
+                    texture.height = source.height;
+                    texture.channels = source.channels;
+                    texture.mip_levels = source.mip_levels;
+                    if (--image_refs[gltf_texture.source] == 0) {
+                        texture.pixels = std::move(source.pixels);
+                    } else {
+                        texture.pixels = source.pixels;
+                    }
 
                     // 确定格式
-                    switch (image.component) {
+                    switch (texture.channels) {
                         case 1: texture.format = TextureData::R8; break;
                         case 2: texture.format = TextureData::RG8; break;
                         case 3: texture.format = TextureData::RGB8; break;
                         case 4: texture.format = TextureData::RGBA8; break;
                     }
-
-                    // 设置生成mipmap
-                    texture.generate_mipmaps = config->generate_mipmaps;
                 }
             }
 
@@ -221,16 +349,33 @@ namespace spartan {
 
 // 处理网格
         bool GltfProcessor::Impl::ProcessMeshes() {
-            for (size_t i = 0; i < model.meshes.size(); ++i) {
-                if (!ProcessMesh(static_cast<int>(i))) {
+            // 句柄和输出槽按网格顺序预先分配，工作线程只写各自的MeshData，串行和并行模式结果一致
+            const size_t mesh_count = model.meshes.size();
+            std::vector<MeshData*> slots(mesh_count);
+            for (size_t i = 0; i < mesh_count; ++i) {
+                MeshHandle handle = output->handle_generator.Generate<MeshTag>();
+                mesh_handle_map[static_cast<int>(i)] = handle;
+                slots[i] = &output->meshes[handle];
+            }
+
+            std::vector<uint8_t> succeeded(mesh_count, 0);
+            ParallelFor(mesh_count, [&](size_t i) {
+                succeeded[i] = ProcessMesh(static_cast<int>(i), *slots[i]) ? 1 : 0;
+            });
+
+            for (size_t i = 0; i < mesh_count; ++i) {
+                if (!succeeded[i]) {
                     return false;
                 }
+                // 更新统计信息
+                output->metadata.stats.total_vertices += slots[i]->vertex_count;
+                output->metadata.stats.total_triangles += static_cast<uint32_t>(slots[i]->index_buffer.size() / 3);
             }
             return true;
         }
 
-// 处理单个网格
-        bool GltfProcessor::Impl::ProcessMesh(int mesh_index) {
+// 处理单个网格（只写mesh_data，可在工作线程上执行）
+        bool GltfProcessor::Impl::ProcessMesh(int mesh_index, MeshData& mesh_data) {
             const auto& gltf_mesh = model.meshes[mesh_index];
 
             // 查找使用此网格的节点
@@ -242,10 +387,6 @@ namespace spartan {
                 }
             }
 
-            MeshHandle handle = output->handle_generator.Generate<MeshTag>();
-            mesh_handle_map[mesh_index] = handle;
-
-            MeshData& mesh_data = output->meshes[handle];
             mesh_data.vertex_count = 0;  // 初始化顶点计数
 
             // 首先确定整个网格的统一顶点格式
@@ -290,6 +431,9 @@ namespace spartan {
             if (config->optimize_vertex_cache) {
                 OptimizeVertexCache(mesh_data);
             }
+            if (config->optimize_overdraw) {
+                OptimizeOverdraw(mesh_data);
+            }
 
             // 生成切线
             if (config->generate_tangents &&
@@ -297,9 +441,21 @@ namespace spartan {
                 GenerateTangents(mesh_data);
             }
 
-            // 更新统计信息
-            output->metadata.stats.total_vertices += mesh_data.vertex_count;
-            output->metadata.stats.total_triangles += static_cast<uint32_t>(mesh_data.index_buffer.size() / 3);
+            // 顶点重排放在切线生成之后，此时步长已经确定
+            if (config->optimize_vertex_fetch) {
+                OptimizeVertexFetch(mesh_data);
+            }
+
+            // 顶点数已经确定，选择索引宽度
+            if (config->use_16bit_indices && mesh_data.vertex_count <= MeshData::MAX_16BIT_VERTEX_COUNT) {
+                mesh_data.index_type = GL_UNSIGNED_SHORT;
+            } else {
+                mesh_data.index_type = GL_UNSIGNED_INT;
+                if (config->use_16bit_indices) {
+                    ReportWarning("Mesh " + std::to_string(mesh_index) + " has " +
+                                  std::to_string(mesh_data.vertex_count) + " vertices, keeping 32-bit indices.");
+                }
+            }
 
             return true;
         }
@@ -375,7 +531,7 @@ namespace spartan {
             uint64_t total_memory = 0;
             for (const auto& [handle, mesh] : output->meshes) {
                 total_memory += mesh.vertex_buffer.size();
-                total_memory += mesh.index_buffer.size() * sizeof(uint32_t);
+                total_memory += mesh.index_buffer.size() * mesh.GetIndexSize();
             }
 
             output->metadata.stats.total_memory_bytes = total_memory;
@@ -430,122 +586,152 @@ namespace spartan {
 
             return true;
         }
-// 获取访问器数据
-        template<typename T>
-        std::vector<T> GltfProcessor::Impl::GetAccessorData(int accessor_index) const {
-            const uint8_t* data;
-            size_t stride, count;
+// 访问器元素类型描述：分量数、零拷贝要求的分量类型、转换时使用的标量类型
+        namespace {
+            template<typename T>
+            struct AccessorTraits;
+
+            template<>
+            struct AccessorTraits<float> {
+                using Scalar = float;
+                static constexpr int components = 1;
+                static constexpr int component_type = TINYGLTF_COMPONENT_TYPE_FLOAT;
+            };
 
-            if (!ValidateAccessor(accessor_index, sizeof(T), &data, &stride, &count)) {
-                return {};
-            }
+            template<>
+            struct AccessorTraits<glm::vec2> {
+                using Scalar = float;
+                static constexpr int components = 2;
+                static constexpr int component_type = TINYGLTF_COMPONENT_TYPE_FLOAT;
+            };
 
-            std::vector<T> result(count);
-            for (size_t i = 0; i < count; ++i) {
-                std::memcpy(&result[i], data + i * stride, sizeof(T));
-            }
+            template<>
+            struct AccessorTraits<glm::vec3> {
+                using Scalar = float;
+                static constexpr int components = 3;
+                static constexpr int component_type = TINYGLTF_COMPONENT_TYPE_FLOAT;
+            };
 
-            return result;
-        }
-// 模板特化实现
-        template<>
-        std::vector<float> GltfProcessor::Impl::GetAccessorData<float>(int accessor_index) const {
-            const uint8_t* data;
-            size_t stride, count;
+            template<>
+            struct AccessorTraits<glm::vec4> {
+                using Scalar = float;
+                static constexpr int components = 4;
+                static constexpr int component_type = TINYGLTF_COMPONENT_TYPE_FLOAT;
+            };
 
-            if (!ValidateAccessor(accessor_index, sizeof(float), &data, &stride, &count)) {
-                return {};
-            }
+            template<>
+            struct AccessorTraits<glm::u16vec4> {
+                using Scalar = uint16_t;
+                static constexpr int components = 4;
+                static constexpr int component_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT;
+            };
 
-            std::vector<float> result(count);
-            for (size_t i = 0; i < count; ++i) {
-                std::memcpy(&result[i], data + i * stride, sizeof(float));
+            // 读取一个分量，normalized整数按glTF规范映射到[0,1]或[-1,1]
+            double ReadAccessorComponent(const uint8_t* src, int component_type, bool normalized) {
+                switch (component_type) {
+                    case TINYGLTF_COMPONENT_TYPE_BYTE: {
+                        int8_t value;
+                        std::memcpy(&value, src, sizeof(value));
+                        return normalized ? std::max(value / 127.0, -1.0) : value;
+                    }
+                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+                        uint8_t value = *src;
+                        return normalized ? value / 255.0 : value;
+                    }
+                    case TINYGLTF_COMPONENT_TYPE_SHORT: {
+                        int16_t value;
+                        std::memcpy(&value, src, sizeof(value));
+                        return normalized ? std::max(value / 32767.0, -1.0) : value;
+                    }
+                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+                        uint16_t value;
+                        std::memcpy(&value, src, sizeof(value));
+                        return normalized ? value / 65535.0 : value;
+                    }
+                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
+                        uint32_t value;
+                        std::memcpy(&value, src, sizeof(value));
+                        return value;
+                    }
+                    case TINYGLTF_COMPONENT_TYPE_FLOAT: {
+                        float value;
+                        std::memcpy(&value, src, sizeof(value));
+                        return value;
+                    }
+                    default:
+                        return 0.0;
+                }
             }
-
-            return result;
         }
 
-        template<>
-        std::vector<glm::vec2> GltfProcessor::Impl::GetAccessorData<glm::vec2>(int accessor_index) const {
-            const uint8_t* data;
-            size_t stride, count;
+// 获取访问器视图
+        template<typename T>
+        AccessorView<T> GltfProcessor::Impl::GetAccessorView(int accessor_index, std::vector<T>& scratch) const {
+            using Traits = AccessorTraits<T>;
+            using Scalar = typename Traits::Scalar;
 
-            if (!ValidateAccessor(accessor_index, sizeof(glm::vec2), &data, &stride, &count)) {
+            if (accessor_index < 0 || accessor_index >= static_cast<int>(model.accessors.size())) {
                 return {};
             }
 
-            std::vector<glm::vec2> result(count);
-            for (size_t i = 0; i < count; ++i) {
-                std::memcpy(&result[i], data + i * stride, sizeof(glm::vec2));
+            const auto& accessor = model.accessors[accessor_index];
+            const int components = tinygltf::GetNumComponentsInType(accessor.type);
+            const int component_size = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+            if (components <= 0 || component_size <= 0) {
+                return {};
             }
 
-            return result;
-        }
-
-        template<>
-        std::vector<glm::vec3> GltfProcessor::Impl::GetAccessorData<glm::vec3>(int accessor_index) const {
             const uint8_t* data;
             size_t stride, count;
-
-            if (!ValidateAccessor(accessor_index, sizeof(glm::vec3), &data, &stride, &count)) {
+            if (!ValidateAccessor(accessor_index, static_cast<size_t>(components) * component_size, &data, &stride, &count)) {
                 return {};
             }
 
-            std::vector<glm::vec3> result(count);
-            for (size_t i = 0; i < count; ++i) {
-                std::memcpy(&result[i], data + i * stride, sizeof(glm::vec3));
-            }
-
-            return result;
-        }
-
-        template<>
-        std::vector<glm::vec4> GltfProcessor::Impl::GetAccessorData<glm::vec4>(int accessor_index) const {
-            const uint8_t* data;
-            size_t stride, count;
-
-            if (!ValidateAccessor(accessor_index, sizeof(glm::vec4), &data, &stride, &count)) {
-                return {};
+            // 布局一致：直接引用缓冲内存
+            if (components == Traits::components && accessor.componentType == Traits::component_type) {
+                return {data, stride, count};
             }
 
-            std::vector<glm::vec4> result(count);
+            // 分量类型或数量不同：逐元素转换，缺失的第四个分量补1（RGB颜色），其余补0
+            scratch.resize(count);
+            const int copy_components = std::min(components, Traits::components);
             for (size_t i = 0; i < count; ++i) {
-                std::memcpy(&result[i], data + i * stride, sizeof(glm::vec4));
+                Scalar values[4] = {Scalar(0), Scalar(0), Scalar(0), std::is_floating_point<Scalar>::value ? Scalar(1) : Scalar(0)};
+                const uint8_t* element = data + i * stride;
+                for (int c = 0; c < copy_components; ++c) {
+                    values[c] = static_cast<Scalar>(ReadAccessorComponent(element + c * component_size,
+                                                                          accessor.componentType, accessor.normalized));
+                }
+                std::memcpy(&scratch[i], values, sizeof(T));
             }
 
-            return result;
+            return {reinterpret_cast<const uint8_t*>(scratch.data()), sizeof(T), count};
         }
 
-        template<>
-        std::vector<glm::u16vec4> GltfProcessor::Impl::GetAccessorData<glm::u16vec4>(int accessor_index) const {
-            if (accessor_index < 0 || accessor_index >= static_cast<int>(model.accessors.size())) {
-                return {};
+// 获取访问器数据（拷贝到独立数组，需要持有数据时使用）
+        template<typename T>
+        std::vector<T> GltfProcessor::Impl::GetAccessorData(int accessor_index) const {
+            std::vector<T> scratch;
+            auto view = GetAccessorView<T>(accessor_index, scratch);
+            if (!scratch.empty()) {
+                return scratch;
             }
+            return view.ToVector();
+        }
 
-            const auto& accessor = model.accessors[accessor_index];
-            const uint8_t* data;
-            size_t stride, count;
-
-            // 对于joints数据，可能是uint8或uint16
-            size_t component_size = (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
-                                    ? sizeof(glm::u16vec4) : sizeof(uint8_t) * 4;
-
-            if (!ValidateAccessor(accessor_index, component_size, &data, &stride, &count)) {
-                return {};
+// 动画时间数组（按访问器索引备忘）
+        const GltfProcessor::Impl::ProcessingContext::TimeArray& GltfProcessor::Impl::GetTimeArray(int accessor_index) const {
+            auto it = context.time_arrays.find(accessor_index);
+            if (it != context.time_arrays.end()) {
+                return it->second;
             }
 
-            std::vector<glm::u16vec4> result(count);
-            for (size_t i = 0; i < count; ++i) {
-                if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
-                    std::memcpy(&result[i], data + i * stride, sizeof(glm::u16vec4));
-                } else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
-                    // 转换 uint8 到 uint16
-                    const uint8_t* joints8 = data + i * stride;
-                    result[i] = glm::u16vec4(joints8[0], joints8[1], joints8[2], joints8[3]);
-                }
+            auto& entry = context.time_arrays[accessor_index];
+            entry.times = GetAccessorView<float>(accessor_index, entry.storage);
+            for (float time : entry.times) {
+                entry.max_time = std::max(entry.max_time, time);
             }
-
-            return result;
+            return entry;
         }
 
         template<>
@@ -567,6 +753,11 @@ namespace spartan {
             return result;
         }
 
+// 其他翻译单元（动画处理）使用的实例
+        template AccessorView<float> GltfProcessor::Impl::GetAccessorView<float>(int, std::vector<float>&) const;
+        template AccessorView<glm::vec3> GltfProcessor::Impl::GetAccessorView<glm::vec3>(int, std::vector<glm::vec3>&) const;
+        template AccessorView<glm::vec4> GltfProcessor::Impl::GetAccessorView<glm::vec4>(int, std::vector<glm::vec4>&) const;
+
 
 // 获取节点变换
         ozz::math::Transform GltfProcessor::Impl::GetNodeTransform(const tinygltf::Node& node) const {
@@ -636,6 +827,7 @@ namespace spartan {
 
 // 错误报告
         void GltfProcessor::Impl::ReportError(const std::string& error) {
+            std::lock_guard<std::mutex> lock(report_mutex);
             if (last_error) {
                 *last_error = error;
             }
@@ -643,15 +835,21 @@ namespace spartan {
         }
 
         void GltfProcessor::Impl::ReportWarning(const std::string& warning) {
+            std::lock_guard<std::mutex> lock(report_mutex);
             context.warnings.push_back(warning);
         }
 
-        void GltfProcessor::Impl::ReportProgress(float progress, const char* stage) {
+        void GltfProcessor::Impl::ReportProgress(float progress, const char* stage, double stage_ms) {
             if (progress_callback && *progress_callback) {
-                (*progress_callback)(progress, stage);
+                (*progress_callback)(progress, stage, stage_ms);
             }
         }
 
+        void GltfProcessor::Impl::ParallelFor(size_t count, const std::function<void(size_t)>& job) const {
+            const uint32_t thread_count = config->parallel_import ? config->import_thread_count : 1;
+            asset::ParallelFor(count, thread_count, job);
+        }
+
 // ProcessedAsset验证
         bool ProcessedAsset::Validate() const {
             // 验证网格
@@ -698,89 +896,16 @@ namespace spartan {
             // 确保格式包含网格统一格式的所有属性
             raw_format.attributes = mesh_data.format.attributes;
 
-            // 清空当前primitive的顶点缓存
-            context.vertex_cache.clear();
-
-            // 构建去重后的顶点数据和索引映射
+            // 按原始字节去重（覆盖全部属性），开放寻址表按顶点数一次性分配；每个primitive独立，多个网格可以并行处理
             std::vector<uint32_t> index_remap(raw_vertex_count);
-            std::vector<uint8_t> deduplicated_vertices;
-            uint32_t deduplicated_count = 0;
+            uint32_t deduplicated_count = GenerateVertexRemap(raw_vertex_buffer.data(), raw_vertex_count,
+                                                              raw_format.stride, index_remap.data());
 
+            std::vector<uint8_t> deduplicated_vertices(static_cast<size_t>(deduplicated_count) * raw_format.stride);
             for (uint32_t i = 0; i < raw_vertex_count; ++i) {
-                const uint8_t* vertex_data = raw_vertex_buffer.data() + i * raw_format.stride;
-
-                // 构建顶点键
-                ProcessingContext::VertexKey key;
-
-                // 提取位置
-                if (raw_format.attributes & VertexFormat::POSITION) {
-                    const auto& info = raw_format.attribute_map.at(VertexFormat::POSITION);
-                    glm::vec3 pos;
-                    std::memcpy(&pos, vertex_data + info.offset, sizeof(glm::vec3));
-                    key.position = ToOZZ(pos);
-                } else {
-                    key.position = ozz::math::Float3(0.0f, 0.0f, 0.0f);
-                }
-
-                // 提取法线
-                if (raw_format.attributes & VertexFormat::NORMAL) {
-                    const auto& info = raw_format.attribute_map.at(VertexFormat::NORMAL);
-                    glm::vec3 normal;
-                    std::memcpy(&normal, vertex_data + info.offset, sizeof(glm::vec3));
-                    key.normal = ToOZZ(normal);
-                } else {
-                    key.normal = ozz::math::Float3(0.0f, 1.0f, 0.0f);
-                }
-
-                // 提取UV
-                if (raw_format.attributes & VertexFormat::UV0) {
-                    const auto& info = raw_format.attribute_map.at(VertexFormat::UV0);
-                    glm::vec2 uv;
-                    std::memcpy(&uv, vertex_data + info.offset, sizeof(glm::vec2));
-                    key.uv0 = uv;
-                } else {
-                    key.uv0 = glm::vec2(0.0f, 0.0f);
-                }
-
-                // 提取蒙皮数据
-                if (raw_format.attributes & VertexFormat::JOINTS0) {
-                    const auto& info = raw_format.attribute_map.at(VertexFormat::JOINTS0);
-                    glm::u16vec4 joints;
-                    std::memcpy(&joints, vertex_data + info.offset, sizeof(glm::u16vec4));
-                    key.joints[0] = joints.x;
-                    key.joints[1] = joints.y;
-                    key.joints[2] = joints.z;
-                    key.joints[3] = joints.w;
-                } else {
-                    key.joints[0] = key.joints[1] = key.joints[2] = key.joints[3] = 0;
-                }
-
-                if (raw_format.attributes & VertexFormat::WEIGHTS0) {
-                    const auto& info = raw_format.attribute_map.at(VertexFormat::WEIGHTS0);
-                    glm::vec4 weights;
-                    std::memcpy(&weights, vertex_data + info.offset, sizeof(glm::vec4));
-                    key.weights = ozz::math::Float4(weights.x, weights.y, weights.z, weights.w);
-                } else {
-                    key.weights = ozz::math::Float4(1.0f, 0.0f, 0.0f, 0.0f);
-                }
-
-                // 查找或插入顶点
-                auto it = context.vertex_cache.find(key);
-                if (it != context.vertex_cache.end()) {
-                    // 找到重复顶点
-                    index_remap[i] = it->second;
-                } else {
-                    // 新顶点
-                    index_remap[i] = deduplicated_count;
-                    context.vertex_cache[key] = deduplicated_count;
-
-                    // 添加到去重后的缓冲区
-                    size_t current_size = deduplicated_vertices.size();
-                    deduplicated_vertices.resize(current_size + raw_format.stride);
-                    std::memcpy(deduplicated_vertices.data() + current_size, vertex_data, raw_format.stride);
-
-                    deduplicated_count++;
-                }
+                std::memcpy(deduplicated_vertices.data() + static_cast<size_t>(index_remap[i]) * raw_format.stride,
+                            raw_vertex_buffer.data() + static_cast<size_t>(i) * raw_format.stride,
+                            raw_format.stride);
             }
 
             // 更新网格顶点缓冲区
@@ -974,43 +1099,38 @@ namespace spartan {
             vertex_buffer.resize(vertex_count * vertex_size);
             uint8_t* vertex_data = vertex_buffer.data();
 
-            // 提取各个属性数据
-            auto positions = GetAccessorData<glm::vec3>(pos_it->second);
+            // 提取各个属性数据：float属性直接引用glTF缓冲，只有需要类型转换的属性才会写入暂存数组
+            std::vector<glm::vec3> position_scratch;
+            auto positions = GetAccessorView<glm::vec3>(pos_it->second, position_scratch);
 
-            std::vector<glm::vec3> normals;
-            if (auto it = primitive.attributes.find("NORMAL"); it != primitive.attributes.end()) {
-                normals = GetAccessorData<glm::vec3>(it->second);
-            }
+            auto view_attribute = [&](const char* name, auto& scratch) {
+                using Element = typename std::decay_t<decltype(scratch)>::value_type;
+                if (auto it = primitive.attributes.find(name); it != primitive.attributes.end()) {
+                    return GetAccessorView<Element>(it->second, scratch);
+                }
+                return AccessorView<Element>{};
+            };
 
-            std::vector<glm::vec4> tangents;
-            if (auto it = primitive.attributes.find("TANGENT"); it != primitive.attributes.end()) {
-                tangents = GetAccessorData<glm::vec4>(it->second);
-            }
+            std::vector<glm::vec3> normal_scratch;
+            auto normals = view_attribute("NORMAL", normal_scratch);
 
-            std::vector<glm::vec2> uvs0;
-            if (auto it = primitive.attributes.find("TEXCOORD_0"); it != primitive.attributes.end()) {
-                uvs0 = GetAccessorData<glm::vec2>(it->second);
-            }
+            std::vector<glm::vec4> tangent_scratch;
+            auto tangents = view_attribute("TANGENT", tangent_scratch);
 
-            std::vector<glm::vec2> uvs1;
-            if (auto it = primitive.attributes.find("TEXCOORD_1"); it != primitive.attributes.end()) {
-                uvs1 = GetAccessorData<glm::vec2>(it->second);
-            }
+            std::vector<glm::vec2> uv0_scratch;
+            auto uvs0 = view_attribute("TEXCOORD_0", uv0_scratch);
 
-            std::vector<glm::vec4> colors;
-            if (auto it = primitive.attributes.find("COLOR_0"); it != primitive.attributes.end()) {
-                colors = GetAccessorData<glm::vec4>(it->second);
-            }
+            std::vector<glm::vec2> uv1_scratch;
+            auto uvs1 = view_attribute("TEXCOORD_1", uv1_scratch);
 
-            std::vector<glm::u16vec4> joints;
-            if (auto it = primitive.attributes.find("JOINTS_0"); it != primitive.attributes.end()) {
-                joints = GetAccessorData<glm::u16vec4>(it->second);
-            }
+            std::vector<glm::vec4> color_scratch;
+            auto colors = view_attribute("COLOR_0", color_scratch);
 
-            std::vector<glm::vec4> weights;
-            if (auto it = primitive.attributes.find("WEIGHTS_0"); it != primitive.attributes.end()) {
-                weights = GetAccessorData<glm::vec4>(it->second);
-            }
+            std::vector<glm::u16vec4> joint_scratch;
+            auto joints = view_attribute("JOINTS_0", joint_scratch);
+
+            std::vector<glm::vec4> weight_scratch;
+            auto weights = view_attribute("WEIGHTS_0", weight_scratch);
 
             // 交错存储顶点数据
             for (uint32_t i = 0; i < vertex_count; ++i) {
@@ -1018,13 +1138,15 @@ namespace spartan {
                 uint32_t offset = 0;
 
                 if (format.attributes & VertexFormat::POSITION) {
-                    std::memcpy(vertex + offset, &positions[i], sizeof(glm::vec3));
+                    glm::vec3 position = i < positions.size() ? positions[i] : glm::vec3(0.0f);
+                    std::memcpy(vertex + offset, &position, sizeof(glm::vec3));
                     offset += sizeof(glm::vec3);
                 }
 
                 if (format.attributes & VertexFormat::NORMAL) {
                     if (i < normals.size()) {
-                        std::memcpy(vertex + offset, &normals[i], sizeof(glm::vec3));
+                        glm::vec3 value = normals[i];
+                        std::memcpy(vertex + offset, &value, sizeof(glm::vec3));
                     } else {
                         glm::vec3 default_normal(0, 1, 0);
                         std::memcpy(vertex + offset, &default_normal, sizeof(glm::vec3));
@@ -1034,7 +1156,8 @@ namespace spartan {
 
                 if (format.attributes & VertexFormat::TANGENT) {
                     if (i < tangents.size()) {
-                        std::memcpy(vertex + offset, &tangents[i], sizeof(glm::vec4));
+                        glm::vec4 value = tangents[i];
+                        std::memcpy(vertex + offset, &value, sizeof(glm::vec4));
                     } else {
                         glm::vec4 default_tangent(1, 0, 0, 1);
                         std::memcpy(vertex + offset, &default_tangent, sizeof(glm::vec4));
@@ -1044,7 +1167,8 @@ namespace spartan {
 
                 if (format.attributes & VertexFormat::UV0) {
                     if (i < uvs0.size()) {
-                        std::memcpy(vertex + offset, &uvs0[i], sizeof(glm::vec2));
+                        glm::vec2 value = uvs0[i];
+                        std::memcpy(vertex + offset, &value, sizeof(glm::vec2));
                     } else {
                         glm::vec2 default_uv(0, 0);
                         std::memcpy(vertex + offset, &default_uv, sizeof(glm::vec2));
@@ -1054,7 +1178,8 @@ namespace spartan {
 
                 if (format.attributes & VertexFormat::UV1) {
                     if (i < uvs1.size()) {
-                        std::memcpy(vertex + offset, &uvs1[i], sizeof(glm::vec2));
+                        glm::vec2 value = uvs1[i];
+                        std::memcpy(vertex + offset, &value, sizeof(glm::vec2));
                     } else {
                         glm::vec2 default_uv(0, 0);
                         std::memcpy(vertex + offset, &default_uv, sizeof(glm::vec2));
@@ -1064,7 +1189,8 @@ namespace spartan {
 
                 if (format.attributes & VertexFormat::COLOR0) {
                     if (i < colors.size()) {
-                        std::memcpy(vertex + offset, &colors[i], sizeof(glm::vec4));
+                        glm::vec4 value = colors[i];
+                        std::memcpy(vertex + offset, &value, sizeof(glm::vec4));
                     } else {
                         glm::vec4 default_color(1, 1, 1, 1);
                         std::memcpy(vertex + offset, &default_color, sizeof(glm::vec4));
@@ -1074,7 +1200,8 @@ namespace spartan {
 
                 if (format.attributes & VertexFormat::JOINTS0) {
                     if (i < joints.size()) {
-                        std::memcpy(vertex + offset, &joints[i], sizeof(glm::u16vec4));
+                        glm::u16vec4 value = joints[i];
+                        std::memcpy(vertex + offset, &value, sizeof(glm::u16vec4));
                     } else {
                         glm::u16vec4 default_joints(0, 0, 0, 0);
                         std::memcpy(vertex + offset, &default_joints, sizeof(glm::u16vec4));
@@ -1147,155 +1274,395 @@ namespace spartan {
                 return;
             }
 
-            // Forsyth算法优化顶点缓存
-            struct VertexScore {
-                int cache_position = -1;
-                float score = 0.0f;
-                uint32_t not_added_triangles = 0;
-            };
-
-            std::vector<VertexScore> vertex_scores(mesh_data.vertex_count);
-            std::vector<uint32_t> optimized_indices;
-            optimized_indices.reserve(mesh_data.index_buffer.size());
+            const size_t index_count = mesh_data.index_buffer.size();
+            VertexCacheStats before = AnalyzeVertexCache(mesh_data.index_buffer.data(), index_count,
+                                                         mesh_data.vertex_count);
+            auto start = std::chrono::high_resolution_clock::now();
 
-            // 统计每个顶点被多少三角形使用
-            for (size_t i = 0; i < mesh_data.index_buffer.size(); i += 3) {
-                for (int j = 0; j < 3; ++j) {
-                    vertex_scores[mesh_data.index_buffer[i + j]].not_added_triangles++;
+            // 按子网格分别优化，三角形不能跨越子网格的索引范围
+            if (mesh_data.submeshes.empty()) {
+                OptimizeVertexCacheForsyth(mesh_data.index_buffer.data(), index_count, mesh_data.vertex_count);
+            } else {
+                for (const auto& submesh : mesh_data.submeshes) {
+                    if (static_cast<size_t>(submesh.index_offset) + submesh.index_count > index_count) {
+                        ReportWarning("Submesh index range out of bounds, skipping vertex cache optimization.");
+                        continue;
+                    }
+                    OptimizeVertexCacheForsyth(mesh_data.index_buffer.data() + submesh.index_offset,
+                                               submesh.index_count, mesh_data.vertex_count);
                 }
             }
 
-            // LRU缓存模拟
-            const int CACHE_SIZE = 32;
-            std::vector<int> cache_timestamps(mesh_data.vertex_count, -1);
-            int timestamp = 0;
+            double elapsed_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - start).count();
+            VertexCacheStats after = AnalyzeVertexCache(mesh_data.index_buffer.data(), index_count,
+                                                        mesh_data.vertex_count);
 
-            // 计算顶点分数
-            auto calculate_vertex_score = [&](uint32_t vertex) -> float {
-                const float CACHE_DECAY_POWER = 1.5f;
-                const float LAST_TRI_SCORE = 0.75f;
-                const float VALENCE_BOOST_SCALE = 2.0f;
-                const float VALENCE_BOOST_POWER = 0.5f;
+            std::cout << "顶点缓存优化: 三角形 " << after.triangle_count
+                      << ", ACMR " << before.acmr << " -> " << after.acmr
+                      << ", ATVR " << before.atvr << " -> " << after.atvr
+                      << ", 耗时 " << elapsed_ms << " ms" << std::endl;
+        }
 
-                auto& vs = vertex_scores[vertex];
+        void GltfProcessor::Impl::OptimizeOverdraw(MeshData& mesh_data) {
+            auto pos_it = mesh_data.format.attribute_map.find(VertexFormat::POSITION);
+            if (mesh_data.index_buffer.empty() || pos_it == mesh_data.format.attribute_map.end()) {
+                return;
+            }
 
-                if (vs.not_added_triangles == 0) {
-                    return -1.0f;
-                }
+            const uint8_t* positions = mesh_data.vertex_buffer.data() + pos_it->second.offset;
+            const size_t stride = mesh_data.format.stride;
+            const size_t index_count = mesh_data.index_buffer.size();
 
-                float score = 0.0f;
-                int cache_position = vs.cache_position;
+            OverdrawStats overdraw_before = AnalyzeOverdraw(mesh_data.index_buffer.data(), index_count,
+                                                            positions, stride, mesh_data.vertex_count);
+            VertexCacheStats cache_before = AnalyzeVertexCache(mesh_data.index_buffer.data(), index_count,
+                                                               mesh_data.vertex_count);
 
-                if (cache_position >= 0) {
-                    if (cache_position < 3) {
-                        score = LAST_TRI_SCORE;
-                    } else {
-                        const float scale = 1.0f / (CACHE_SIZE - 3);
-                        score = 1.0f - (cache_position - 3) * scale;
-                        score = std::pow(score, CACHE_DECAY_POWER);
+            // 与缓存优化一样按子网格处理
+            if (mesh_data.submeshes.empty()) {
+                asset::OptimizeOverdraw(mesh_data.index_buffer.data(), index_count, positions, stride,
+                                        mesh_data.vertex_count, config->overdraw_acmr_threshold);
+            } else {
+                for (const auto& submesh : mesh_data.submeshes) {
+                    if (static_cast<size_t>(submesh.index_offset) + submesh.index_count > index_count) {
+                        continue;
                     }
+                    asset::OptimizeOverdraw(mesh_data.index_buffer.data() + submesh.index_offset,
+                                            submesh.index_count, positions, stride,
+                                            mesh_data.vertex_count, config->overdraw_acmr_threshold);
                 }
+            }
 
-                float valence_boost = std::pow(vs.not_added_triangles, -VALENCE_BOOST_POWER);
-                score += VALENCE_BOOST_SCALE * valence_boost;
+            OverdrawStats overdraw_after = AnalyzeOverdraw(mesh_data.index_buffer.data(), index_count,
+                                                           positions, stride, mesh_data.vertex_count);
+            VertexCacheStats cache_after = AnalyzeVertexCache(mesh_data.index_buffer.data(), index_count,
+                                                              mesh_data.vertex_count);
 
-                return score;
-            };
+            std::cout << "过度绘制优化: overdraw " << overdraw_before.overdraw << " -> " << overdraw_after.overdraw
+                      << ", ACMR " << cache_before.acmr << " -> " << cache_after.acmr
+                      << " (预算 x" << config->overdraw_acmr_threshold << ")" << std::endl;
+        }
+
+        void GltfProcessor::Impl::OptimizeVertexFetch(MeshData& mesh_data) {
+            if (mesh_data.index_buffer.empty() || mesh_data.format.stride == 0) {
+                return;
+            }
+
+            const uint32_t stride = mesh_data.format.stride;
+            const size_t index_count = mesh_data.index_buffer.size();
+            const uint32_t vertex_count_before = mesh_data.vertex_count;
+            VertexFetchStats before = AnalyzeVertexFetch(mesh_data.index_buffer.data(), index_count,
+                                                         mesh_data.vertex_count, stride);
+
+            mesh_data.vertex_count = asset::OptimizeVertexFetch(mesh_data.vertex_buffer, stride, mesh_data.vertex_count,
+                                                                mesh_data.index_buffer.data(), index_count);
+
+            // 重排后按实际引用的顶点重新确定base_vertex：只有子网格独占一段连续顶点时才记录起点，
+            // 与其它子网格共享或不连续时记为0（索引本身是绝对的）
+            constexpr uint32_t NO_OWNER = UINT32_MAX;
+            constexpr uint32_t SHARED = UINT32_MAX - 1;
+            std::vector<uint32_t> owner(mesh_data.vertex_count, NO_OWNER);
+            for (uint32_t s = 0; s < mesh_data.submeshes.size(); ++s) {
+                const auto& submesh = mesh_data.submeshes[s];
+                if (static_cast<size_t>(submesh.index_offset) + submesh.index_count > index_count) {
+                    continue;
+                }
+                for (uint32_t i = 0; i < submesh.index_count; ++i) {
+                    uint32_t& o = owner[mesh_data.index_buffer[submesh.index_offset + i]];
+                    o = (o == NO_OWNER || o == s) ? s : SHARED;
+                }
+            }
+            for (uint32_t s = 0; s < mesh_data.submeshes.size(); ++s) {
+                auto& submesh = mesh_data.submeshes[s];
+                submesh.base_vertex = 0;
+                if (submesh.index_count == 0 ||
+                    static_cast<size_t>(submesh.index_offset) + submesh.index_count > index_count) {
+                    continue;
+                }
+                const uint32_t* begin = mesh_data.index_buffer.data() + submesh.index_offset;
+                const auto [min_it, max_it] = std::minmax_element(begin, begin + submesh.index_count);
+                const bool contiguous = std::all_of(owner.begin() + *min_it, owner.begin() + *max_it + 1,
+                                                    [s](uint32_t o) { return o == s; });
+                if (contiguous) {
+                    submesh.base_vertex = *min_it;
+                }
+            }
 
-            // 优化主循环
-            std::vector<bool> triangle_added(mesh_data.index_buffer.size() / 3, false);
+            VertexFetchStats after = AnalyzeVertexFetch(mesh_data.index_buffer.data(), index_count,
+                                                        mesh_data.vertex_count, stride);
 
-            // 找到起始三角形（选择顶点分数最低的）
-            uint32_t best_triangle = 0;
-            float best_score = FLT_MAX;
+            std::cout << "顶点读取优化: 读取 " << before.bytes_fetched / 1024 << " KB -> " << after.bytes_fetched / 1024
+                      << " KB, overfetch " << before.overfetch << " -> " << after.overfetch
+                      << ", 顶点 " << vertex_count_before << " -> " << mesh_data.vertex_count << std::endl;
+        }
 
-            for (size_t i = 0; i < mesh_data.index_buffer.size(); i += 3) {
-                float score = 0.0f;
-                for (int j = 0; j < 3; ++j) {
-                    score += calculate_vertex_score(mesh_data.index_buffer[i + j]);
+        void GltfProcessor::Impl::QuantizeMeshes() {
+            // 按句柄排序，保证并行模式下日志和警告的来源顺序稳定
+            std::vector<std::pair<MeshHandle, MeshData*>> meshes;
+            meshes.reserve(output->meshes.size());
+            for (auto& [handle, mesh] : output->meshes) {
+                meshes.emplace_back(handle, &mesh);
+            }
+            std::sort(meshes.begin(), meshes.end(),
+                      [](const auto& a, const auto& b) { return a.first.id < b.first.id; });
+
+            ParallelFor(meshes.size(), [&](size_t i) {
+                QuantizeVertices(*meshes[i].second);
+            });
+        }
+
+        void GltfProcessor::Impl::QuantizeVertices(MeshData& mesh_data) {
+            const VertexFormat old_format = mesh_data.format;
+            const uint32_t vertex_count = mesh_data.vertex_count;
+            if (old_format.quantized || vertex_count == 0 ||
+                old_format.attribute_map.count(VertexFormat::POSITION) == 0 ||
+                mesh_data.vertex_buffer.size() < static_cast<size_t>(vertex_count) * old_format.stride) {
+                return;
+            }
+
+            // 源数据必须是ProcessMesh输出的float布局（JOINTS0为u16）
+            for (const auto& [attr, info] : old_format.attribute_map) {
+                uint32_t expected_type = attr == VertexFormat::JOINTS0 ? GL_UNSIGNED_SHORT : GL_FLOAT;
+                if (info.type != expected_type) {
+                    ReportWarning("Unexpected vertex attribute type, skipping vertex quantization.");
+                    return;
+                }
+            }
+
+            auto source = [&](VertexFormat::Attribute attr, uint32_t v) -> const uint8_t* {
+                auto it = old_format.attribute_map.find(attr);
+                if (it == old_format.attribute_map.end()) {
+                    return nullptr;
                 }
+                return mesh_data.vertex_buffer.data() + static_cast<size_t>(v) * old_format.stride + it->second.offset;
+            };
 
-                if (score < best_score) {
-                    best_score = score;
-                    best_triangle = static_cast<uint32_t>(i / 3);
+            // 骨骼索引全部小于256时才能压到8位
+            bool joints_fit_u8 = true;
+            if (old_format.attribute_map.count(VertexFormat::JOINTS0) > 0) {
+                for (uint32_t v = 0; v < vertex_count && joints_fit_u8; ++v) {
+                    glm::u16vec4 joints;
+                    std::memcpy(&joints, source(VertexFormat::JOINTS0, v), sizeof(joints));
+                    joints_fit_u8 = joints.x < 256 && joints.y < 256 && joints.z < 256 && joints.w < 256;
+                }
+                if (!joints_fit_u8) {
+                    ReportWarning("Joint indices exceed 255, JOINTS0 kept as u16.");
                 }
             }
 
-            // 处理所有三角形
-            std::vector<int> cache;
+            // 压缩后的顶点格式，所有偏移保持4字节对齐
+            VertexFormat format;
+            format.attributes = old_format.attributes;
+            format.quantized = true;
+            uint32_t current_offset = 0;
+
+            auto add_attribute = [&](VertexFormat::Attribute attr, uint32_t size, uint32_t type, uint32_t components, bool normalized) {
+                if (format.attributes & attr) {
+                    format.attribute_map[attr] = {current_offset, components, type, normalized};
+                    current_offset += size;
+                }
+            };
+
+            add_attribute(VertexFormat::POSITION, sizeof(int16_t) * 4, GL_SHORT, 4, true);
+            add_attribute(VertexFormat::NORMAL,   sizeof(int16_t) * 2, GL_SHORT, 2, true);
+            add_attribute(VertexFormat::TANGENT,  sizeof(int8_t) * 4, GL_BYTE, 4, true);
+            add_attribute(VertexFormat::UV0,      sizeof(uint16_t) * 2, GL_HALF_FLOAT, 2, false);
+            add_attribute(VertexFormat::UV1,      sizeof(uint16_t) * 2, GL_HALF_FLOAT, 2, false);
+            add_attribute(VertexFormat::COLOR0,   sizeof(uint8_t) * 4, GL_UNSIGNED_BYTE, 4, true);
+            if (joints_fit_u8) {
+                add_attribute(VertexFormat::JOINTS0, sizeof(uint8_t) * 4, GL_UNSIGNED_BYTE, 4, false);
+            } else {
+                add_attribute(VertexFormat::JOINTS0, sizeof(uint16_t) * 4, GL_UNSIGNED_SHORT, 4, false);
+            }
+            add_attribute(VertexFormat::WEIGHTS0, sizeof(uint8_t) * 4, GL_UNSIGNED_BYTE, 4, true);
 
-            while (optimized_indices.size() < mesh_data.index_buffer.size()) {
-                // 添加当前最佳三角形
-                uint32_t tri_idx = best_triangle * 3;
-                for (int i = 0; i < 3; ++i) {
-                    uint32_t idx = mesh_data.index_buffer[tri_idx + i];
-                    optimized_indices.push_back(idx);
+            format.stride = current_offset;
 
-                    // 更新缓存
-                    auto it = std::find(cache.begin(), cache.end(), idx);
-                    if (it != cache.end()) {
-                        cache.erase(it);
+            // 每个子网格使用自己的包围盒作为位置量化范围；
+            // 顶点被多个子网格共享时退化为整个网格共用一个范围
+            bool shared_vertices = mesh_data.submeshes.empty();
+            std::vector<uint32_t> owner(vertex_count, UINT32_MAX);
+            for (uint32_t s = 0; s < mesh_data.submeshes.size() && !shared_vertices; ++s) {
+                const auto& submesh = mesh_data.submeshes[s];
+                if (static_cast<size_t>(submesh.index_offset) + submesh.index_count > mesh_data.index_buffer.size()) {
+                    shared_vertices = true;
+                    break;
+                }
+                for (uint32_t i = 0; i < submesh.index_count; ++i) {
+                    uint32_t v = mesh_data.index_buffer[submesh.index_offset + i];
+                    if (v >= vertex_count) {
+                        continue;
                     }
-                    cache.insert(cache.begin(), idx);
-                    if (cache.size() > CACHE_SIZE) {
-                        cache.resize(CACHE_SIZE);
+                    if (owner[v] == UINT32_MAX) {
+                        owner[v] = s;
+                    } else if (owner[v] != s) {
+                        shared_vertices = true;
+                        break;
                     }
+                }
+            }
 
-                    // 更新缓存位置
-                    for (size_t j = 0; j < cache.size(); ++j) {
-                        vertex_scores[cache[j]].cache_position = static_cast<int>(j);
-                    }
+            const size_t range_count = shared_vertices ? 1 : mesh_data.submeshes.size();
+            auto range_of = [&](uint32_t v) -> size_t {
+                // 未被引用的顶点不会被绘制，归到第一个范围即可
+                return shared_vertices || owner[v] == UINT32_MAX ? 0 : owner[v];
+            };
 
-                    vertex_scores[idx].not_added_triangles--;
+            std::vector<glm::vec3> bounds_min(range_count, glm::vec3(FLT_MAX));
+            std::vector<glm::vec3> bounds_max(range_count, glm::vec3(-FLT_MAX));
+            glm::vec3 mesh_min(FLT_MAX);
+            glm::vec3 mesh_max(-FLT_MAX);
+            for (uint32_t v = 0; v < vertex_count; ++v) {
+                glm::vec3 position;
+                std::memcpy(&position, source(VertexFormat::POSITION, v), sizeof(position));
+                size_t range = range_of(v);
+                bounds_min[range] = glm::min(bounds_min[range], position);
+                bounds_max[range] = glm::max(bounds_max[range], position);
+                mesh_min = glm::min(mesh_min, position);
+                mesh_max = glm::max(mesh_max, position);
+            }
+
+            std::vector<glm::vec3> offsets(range_count, glm::vec3(0.0f));
+            std::vector<glm::vec3> scales(range_count, glm::vec3(1.0f));
+            for (size_t r = 0; r < range_count; ++r) {
+                if (bounds_min[r].x > bounds_max[r].x) {
+                    continue;  // 空范围
                 }
+                offsets[r] = (bounds_min[r] + bounds_max[r]) * 0.5f;
+                scales[r] = (bounds_max[r] - bounds_min[r]) * 0.5f;
+            }
 
-                triangle_added[best_triangle] = true;
+            for (size_t s = 0; s < mesh_data.submeshes.size(); ++s) {
+                size_t range = shared_vertices ? 0 : s;
+                mesh_data.submeshes[s].dequant_offset = offsets[range];
+                mesh_data.submeshes[s].dequant_scale = scales[range];
+            }
 
-                // 找下一个最佳三角形
-                best_triangle = UINT32_MAX;
-                best_score = -1.0f;
+            // 编码并统计误差
+            std::vector<uint8_t> buffer(static_cast<size_t>(vertex_count) * format.stride, 0);
+            float max_position_error = 0.0f;
+            float max_normal_error = 0.0f;   // 度
+            float max_tangent_error = 0.0f;  // 度
+            float max_uv_error = 0.0f;
+            float max_weight_error = 0.0f;
 
-                // 检查缓存中顶点相邻的三角形
-                for (int idx : cache) {
-                    // 查找使用此顶点的三角形
-                    for (size_t i = 0; i < mesh_data.index_buffer.size(); i += 3) {
-                        if (triangle_added[i / 3]) continue;
+            auto angle_between = [](const glm::vec3& a, const glm::vec3& b) {
+                return glm::degrees(std::acos(glm::clamp(glm::dot(a, b), -1.0f, 1.0f)));
+            };
 
-                        bool uses_vertex = false;
-                        for (int j = 0; j < 3; ++j) {
-                            if (mesh_data.index_buffer[i + j] == static_cast<uint32_t>(idx)) {
-                                uses_vertex = true;
-                                break;
-                            }
-                        }
+            for (uint32_t v = 0; v < vertex_count; ++v) {
+                uint8_t* dst = buffer.data() + static_cast<size_t>(v) * format.stride;
+                auto target = [&](VertexFormat::Attribute attr) {
+                    return dst + format.attribute_map[attr].offset;
+                };
+
+                {
+                    glm::vec3 position;
+                    std::memcpy(&position, source(VertexFormat::POSITION, v), sizeof(position));
+                    size_t range = range_of(v);
+
+                    int16_t encoded[4] = {0, 0, 0, 32767};
+                    glm::vec3 decoded;
+                    for (int c = 0; c < 3; ++c) {
+                        float scale = scales[range][c];
+                        encoded[c] = QuantizeSnorm16(scale > 0.0f ? (position[c] - offsets[range][c]) / scale : 0.0f);
+                        decoded[c] = DequantizeSnorm16(encoded[c]) * scale + offsets[range][c];
+                    }
+                    std::memcpy(target(VertexFormat::POSITION), encoded, sizeof(encoded));
+                    max_position_error = std::max(max_position_error, glm::length(decoded - position));
+                }
 
-                        if (uses_vertex) {
-                            float score = 0.0f;
-                            for (int j = 0; j < 3; ++j) {
-                                score += calculate_vertex_score(mesh_data.index_buffer[i + j]);
-                            }
+                if (const uint8_t* src = source(VertexFormat::NORMAL, v)) {
+                    glm::vec3 normal;
+                    std::memcpy(&normal, src, sizeof(normal));
+                    float length = glm::length(normal);
+                    normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
 
-                            if (score > best_score) {
-                                best_score = score;
-                                best_triangle = static_cast<uint32_t>(i / 3);
-                            }
-                        }
+                    glm::vec2 oct = EncodeOctahedral(normal);
+                    int16_t encoded[2] = {QuantizeSnorm16(oct.x), QuantizeSnorm16(oct.y)};
+                    std::memcpy(target(VertexFormat::NORMAL), encoded, sizeof(encoded));
+
+                    glm::vec3 decoded = DecodeOctahedral(glm::vec2(DequantizeSnorm16(encoded[0]), DequantizeSnorm16(encoded[1])));
+                    max_normal_error = std::max(max_normal_error, angle_between(normal, decoded));
+                }
+
+                if (const uint8_t* src = source(VertexFormat::TANGENT, v)) {
+                    glm::vec4 tangent;
+                    std::memcpy(&tangent, src, sizeof(tangent));
+                    glm::vec3 direction(tangent);
+                    float length = glm::length(direction);
+                    direction = length > 0.0f ? direction / length : glm::vec3(1.0f, 0.0f, 0.0f);
+
+                    // w保存副切线方向
+                    glm::vec2 oct = EncodeOctahedral(direction);
+                    int8_t encoded[4] = {QuantizeSnorm8(oct.x), QuantizeSnorm8(oct.y), 0,
+                                         static_cast<int8_t>(tangent.w < 0.0f ? -127 : 127)};
+                    std::memcpy(target(VertexFormat::TANGENT), encoded, sizeof(encoded));
+
+                    glm::vec3 decoded = DecodeOctahedral(glm::vec2(DequantizeSnorm8(encoded[0]), DequantizeSnorm8(encoded[1])));
+                    max_tangent_error = std::max(max_tangent_error, angle_between(direction, decoded));
+                }
+
+                for (VertexFormat::Attribute attr : {VertexFormat::UV0, VertexFormat::UV1}) {
+                    if (const uint8_t* src = source(attr, v)) {
+                        glm::vec2 uv;
+                        std::memcpy(&uv, src, sizeof(uv));
+                        uint16_t encoded[2] = {FloatToHalf(uv.x), FloatToHalf(uv.y)};
+                        std::memcpy(target(attr), encoded, sizeof(encoded));
+
+                        max_uv_error = std::max({max_uv_error,
+                                                 std::abs(HalfToFloat(encoded[0]) - uv.x),
+                                                 std::abs(HalfToFloat(encoded[1]) - uv.y)});
                     }
                 }
 
-                // 如果没找到，选择任意未处理的三角形
-                if (best_triangle == UINT32_MAX) {
-                    for (size_t i = 0; i < triangle_added.size(); ++i) {
-                        if (!triangle_added[i]) {
-                            best_triangle = static_cast<uint32_t>(i);
-                            break;
-                        }
+                if (const uint8_t* src = source(VertexFormat::COLOR0, v)) {
+                    glm::vec4 color;
+                    std::memcpy(&color, src, sizeof(color));
+                    uint8_t encoded[4] = {QuantizeUnorm8(color.r), QuantizeUnorm8(color.g),
+                                          QuantizeUnorm8(color.b), QuantizeUnorm8(color.a)};
+                    std::memcpy(target(VertexFormat::COLOR0), encoded, sizeof(encoded));
+                }
+
+                if (const uint8_t* src = source(VertexFormat::JOINTS0, v)) {
+                    if (joints_fit_u8) {
+                        glm::u16vec4 joints;
+                        std::memcpy(&joints, src, sizeof(joints));
+                        uint8_t encoded[4] = {static_cast<uint8_t>(joints.x), static_cast<uint8_t>(joints.y),
+                                              static_cast<uint8_t>(joints.z), static_cast<uint8_t>(joints.w)};
+                        std::memcpy(target(VertexFormat::JOINTS0), encoded, sizeof(encoded));
+                    } else {
+                        std::memcpy(target(VertexFormat::JOINTS0), src, sizeof(glm::u16vec4));
+                    }
+                }
+
+                if (const uint8_t* src = source(VertexFormat::WEIGHTS0, v)) {
+                    glm::vec4 weights;
+                    std::memcpy(&weights, src, sizeof(weights));
+                    uint8_t encoded[4];
+                    QuantizeWeights(weights, encoded);
+                    std::memcpy(target(VertexFormat::WEIGHTS0), encoded, sizeof(encoded));
+
+                    for (int c = 0; c < 4; ++c) {
+                        max_weight_error = std::max(max_weight_error, std::abs(encoded[c] / 255.0f - weights[c]));
                     }
                 }
             }
 
-            // 替换原索引缓冲区
-            mesh_data.index_buffer = std::move(optimized_indices);
+            float mesh_extent = std::max(glm::length(mesh_max - mesh_min), FLT_MIN);
+            std::cout << "顶点量化: 步长 " << old_format.stride << " -> " << format.stride
+                      << " B, 顶点数据 " << mesh_data.vertex_buffer.size() / 1024 << " KB -> " << buffer.size() / 1024
+                      << " KB, 量化范围 " << range_count << std::endl;
+            std::cout << "  最大误差: 位置 " << max_position_error
+                      << " (对角线的 " << max_position_error / mesh_extent * 100.0f << "%)"
+                      << ", 法线 " << max_normal_error << " 度"
+                      << ", 切线 " << max_tangent_error << " 度"
+                      << ", UV " << max_uv_error
+                      << ", 权重 " << max_weight_error << std::endl;
+
+            mesh_data.format = std::move(format);
+            mesh_data.vertex_buffer.swap(buffer);
         }
 
         void GltfProcessor::Impl::GenerateTangents(MeshData& mesh_data) {
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <memory>
 #include <unordered_map>
 #include <optional>
 #include <vector>
 #include <string>
 #include <functional>
+#include <mutex>
 #include "AssetTypes.h"
+#include "SlotMap.h"
 #include "ozz/base/containers/string.h"
 #include "ozz/base/memory/unique_ptr.h"
 #include "ozz/animation/offline/raw_skeleton.h"
@@ -52,6 +56,7 @@ namespace spartan {
 
             uint32_t attributes = 0;
             uint32_t stride = 0;
+            bool quantized = false;  // 压缩格式：位置snorm16、法线/切线八面体编码、UV半精度、权重/索引unorm8
 
             struct AttributeInfo {
                 uint32_t offset;
@@ -86,15 +91,67 @@ namespace spartan {
             VertexFormat format;
             uint32_t vertex_count = 0;
 
-            // 索引数据
+            // 索引数据：CPU侧统一用uint32处理，index_type决定GPU缓冲和文件中的存储宽度
             std::vector<uint32_t> index_buffer;
+            uint32_t index_type = GL_UNSIGNED_INT;  // GL_UNSIGNED_SHORT或GL_UNSIGNED_INT
+
+            // 16位索引可容纳的最大顶点数（0xFFFF在WebGL2中固定为图元重启索引）
+            static constexpr uint32_t MAX_16BIT_VERTEX_COUNT = 65535;
+
+            uint32_t GetIndexSize() const {
+                return index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+            }
+
+            // 零拷贝加载：顶点和索引直接指向映射的.sprt文件（索引按index_type宽度存储），
+            // 此时vertex_buffer/index_buffer为空；上传GPU后调用ReleaseMappedData，最后一个引用释放时解除映射
+            std::shared_ptr<const void> mapped_storage;
+            const uint8_t* mapped_vertices = nullptr;
+            const uint8_t* mapped_indices = nullptr;
+            uint32_t mapped_index_count = 0;
+
+            bool HasMappedData() const { return mapped_vertices != nullptr; }
+
+            const uint8_t* GetVertexData() const {
+                return mapped_vertices ? mapped_vertices : vertex_buffer.data();
+            }
+            size_t GetVertexDataSize() const {
+                return mapped_vertices ? static_cast<size_t>(vertex_count) * format.stride : vertex_buffer.size();
+            }
+            uint32_t GetIndexCount() const {
+                return mapped_indices ? mapped_index_count : static_cast<uint32_t>(index_buffer.size());
+            }
+            uint32_t GetIndex(size_t i) const {
+                if (!mapped_indices) {
+                    return index_buffer[i];
+                }
+                if (index_type == GL_UNSIGNED_SHORT) {
+                    uint16_t narrow;
+                    std::memcpy(&narrow, mapped_indices + i * sizeof(uint16_t), sizeof(narrow));
+                    return narrow;
+                }
+                uint32_t index;
+                std::memcpy(&index, mapped_indices + i * sizeof(uint32_t), sizeof(index));
+                return index;
+            }
+
+            void ReleaseMappedData() {
+                mapped_vertices = nullptr;
+                mapped_indices = nullptr;
+                mapped_index_count = 0;
+                mapped_storage.reset();
+            }
 
             // 子网格（按材质分组）
             struct SubMesh {
                 uint32_t index_offset;
                 uint32_t index_count;
-                uint32_t base_vertex = 0;
+                uint32_t base_vertex = 0;     // 索引是网格内的绝对索引；子网格独占一段连续顶点时为其起点，否则为0
                 MaterialHandle material;
+                uint32_t material_index = 0;  // 运行时稠密材质索引，加载时由Renderer编译材质后填写
+
+                // 位置反量化：position = quantized * dequant_scale + dequant_offset（未量化时为恒等变换）
+                glm::vec3 dequant_offset{0.0f};
+                glm::vec3 dequant_scale{1.0f};
 
                 // 边界信息
                 ozz::math::Float3 aabb_min;
@@ -112,6 +169,13 @@ namespace spartan {
             uint32_t ibo = 0;
             uint32_t vao = 0;
 
+            // 几何池：vao/vbo/ibo属于共享页，基础顶点已烘焙进GPU索引，绘制时索引偏移需加上gpu_first_index
+            bool gpu_pooled = false;
+            uint32_t gpu_pool_page = 0;
+            uint32_t gpu_base_vertex = 0;
+            uint32_t gpu_first_index = 0;
+            uint32_t gpu_index_count = 0;   // 池中占用的索引数（CPU数据释放后仍可归还）
+
             // 实例化数据
             uint32_t instance_buffer = 0;
             uint32_t max_instance_count = 0;
@@ -127,6 +191,7 @@ namespace spartan {
             // 释放CPU数据（在上传到GPU后节省内存）
             void ReleaseCPUData() {
                 if (data_state == SYNCED || data_state == GPU_ONLY) {
+                    ReleaseMappedData();
                     vertex_buffer.clear();
                     vertex_buffer.shrink_to_fit();
                     index_buffer.clear();
@@ -217,7 +282,7 @@ namespace spartan {
             std::optional<uint32_t> root_motion_joint_index;
 
             // 动画数据
-            std::unique_ptr<ozz::animation::Animation> skeletal_animation;
+            ozz::unique_ptr<ozz::animation::Animation> skeletal_animation;  // 由ozz分配器创建和释放
 
             std::unordered_map<uint32_t, NodeTransformData> node_animations;
 
@@ -251,6 +316,23 @@ namespace spartan {
             // Mipmap信息
             uint32_t mip_levels = 1;
             bool generate_mipmaps = true;
+
+            // 解码后的像素（R8/RG8/RGB8/RGBA8），所有mip级别从0级开始紧密排列，
+            // 第i级尺寸为max(1, width>>i) x max(1, height>>i)；解码失败时为空，上传GPU后也会被释放
+            std::vector<uint8_t> pixels;
+
+            uint32_t GetMipWidth(uint32_t level) const { return std::max(1u, width >> level); }
+            uint32_t GetMipHeight(uint32_t level) const { return std::max(1u, height >> level); }
+            size_t GetMipSize(uint32_t level) const {
+                return static_cast<size_t>(GetMipWidth(level)) * GetMipHeight(level) * channels;
+            }
+            size_t GetMipOffset(uint32_t level) const {
+                size_t offset = 0;
+                for (uint32_t i = 0; i < level; ++i) {
+                    offset += GetMipSize(i);
+                }
+                return offset;
+            }
         };
 
 // 场景节点
@@ -273,30 +355,43 @@ namespace spartan {
         };
 
 // 处理配置
+        // 新增影响处理结果的字段时需同时加入AssetCache的缓存键
         struct ProcessConfig {
             // 网格处理
             bool merge_meshes_by_material = true;
             bool generate_tangents = true;
             bool optimize_vertex_cache = true;
+            bool optimize_overdraw = false;             // 在缓存优化结果上按簇重排以减少过度绘制
+            float overdraw_acmr_threshold = 1.05f;      // 过度绘制优化允许的ACMR放大倍数
+            bool optimize_vertex_fetch = false;         // 按首次使用顺序重排顶点，提高读取局部性
+            bool quantize_vertices = false;             // 生成压缩顶点格式（见VertexFormat::quantized）
+            bool use_16bit_indices = true;              // 顶点数不超过MAX_16BIT_VERTEX_COUNT时使用16位索引
             float vertex_position_epsilon = 1e-6f;
             float vertex_normal_epsilon = 1e-3f;
 
             // 纹理处理
             bool compress_textures = true;
-            bool generate_mipmaps = true;
-            uint32_t max_texture_size = 4096;
+            bool generate_mipmaps = true;               // 在CPU上生成完整mip链，存入TextureData::pixels
+            uint32_t max_texture_size = 4096;           // 超过时按比例缩小，长边不超过该值
 
-            // 动画处理
+            // 动画处理（压缩方式见AnimationCompression.h）
             bool compress_animations = true;
-            float animation_position_tolerance = 0.001f;
-            float animation_rotation_tolerance = 0.001f;
+            float animation_position_tolerance = 0.001f;   // 米
+            float animation_rotation_tolerance = 0.001f;   // 弧度
             float animation_scale_tolerance = 0.001f;
+            float animation_error_distance = 0.1f;         // 骨骼动画误差的测量距离（米），模拟对蒙皮顶点的影响
+            std::unordered_map<std::string, float> animation_joint_tolerances;  // 按关节名覆盖位置容差（如手指、根运动关节）
 
             // 性能选项
             uint32_t max_bones_per_vertex = 4;
             uint32_t max_morph_targets = 8;
             bool enable_gpu_skinning = true;
             bool enable_instancing = true;
+
+            // 并行导入：图像解码、网格、顶点量化和动画片段在工作线程上处理，句柄预先按顺序分配，输出与串行一致
+            // （各阶段内的控制台日志可能交错）
+            bool parallel_import = false;
+            uint32_t import_thread_count = 0;           // 0 = 硬件线程数
         };
 
 // GLTF处理器
@@ -315,10 +410,17 @@ namespace spartan {
             // 获取错误信息
             const std::string& GetLastError() const { return last_error_; }
 
-            // 进度回调
-            using ProgressCallback = std::function<void(float progress, const char* stage)>;
+            // 进度回调：每个阶段完成时调用，stage_ms为该阶段耗时（"Complete"时为总耗时）
+            using ProgressCallback = std::function<void(float progress, const char* stage, double stage_ms)>;
             void SetProgressCallback(ProgressCallback callback) { progress_callback_ = callback; }
 
+            // 最近一次ProcessFile的各阶段耗时
+            struct StageTiming {
+                std::string stage;
+                double milliseconds = 0.0;
+            };
+            const std::vector<StageTiming>& GetStageTimings() const { return stage_timings_; }
+
         private:
             struct Impl;
             std::unique_ptr<Impl> impl_;
@@ -326,17 +428,18 @@ namespace spartan {
             ProcessConfig config_;
             std::string last_error_;
             ProgressCallback progress_callback_;
+            std::vector<StageTiming> stage_timings_;
         };
 
 // 处理后的资产包
         struct ProcessedAsset {
 
-            // 资源存储
-            std::unordered_map<MeshHandle, MeshData, HandleHash<MeshTag>> meshes;
-            std::unordered_map<MaterialHandle, MaterialData, HandleHash<MaterialTag>> materials;
-            std::unordered_map<TextureHandle, TextureData, HandleHash<TextureTag>> textures;
-            std::unordered_map<SkeletonHandle, ozz::unique_ptr<ozz::animation::Skeleton>, HandleHash<SkeletonTag>> skeletons;
-            std::unordered_map<AnimationHandle, AnimationData, HandleHash<AnimationTag>> animations;
+            // 资源存储：句柄id直接索引槽位（见SlotMap.h）
+            SlotMap<MeshTag, MeshData> meshes;
+            SlotMap<MaterialTag, MaterialData> materials;
+            SlotMap<TextureTag, TextureData> textures;
+            SlotMap<SkeletonTag, ozz::unique_ptr<ozz::animation::Skeleton>> skeletons;
+            SlotMap<AnimationTag, AnimationData> animations;
 
             // 场景数据
             std::vector<SceneNode> nodes;
@@ -408,6 +511,53 @@ namespace spartan {
             }
         };
 
+// glTF访问器的类型化跨步视图：直接指向tinygltf缓冲内存（或转换后的暂存数组），不拥有数据
+// 元素按memcpy读取，不要求源数据对齐
+        template<typename T>
+        struct AccessorView {
+            const uint8_t *data = nullptr;
+            size_t stride = 0;
+            size_t count = 0;
+
+            struct Iterator {
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = T;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const T *;
+                using reference = T;
+
+                const uint8_t *ptr;
+                size_t stride;
+
+                T operator*() const {
+                    T value;
+                    std::memcpy(&value, ptr, sizeof(T));
+                    return value;
+                }
+                Iterator &operator++() {
+                    ptr += stride;
+                    return *this;
+                }
+                bool operator==(const Iterator &other) const { return ptr == other.ptr; }
+                bool operator!=(const Iterator &other) const { return ptr != other.ptr; }
+            };
+
+            size_t size() const { return count; }
+            bool empty() const { return count == 0; }
+
+            T operator[](size_t index) const {
+                T value;
+                std::memcpy(&value, data + index * stride, sizeof(T));
+                return value;
+            }
+            T back() const { return (*this)[count - 1]; }
+
+            Iterator begin() const { return {data, stride}; }
+            Iterator end() const { return {data + count * stride, stride}; }
+
+            std::vector<T> ToVector() const { return std::vector<T>(begin(), end()); }
+        };
+
 // 实现细节
         struct GltfProcessor::Impl {
             tinygltf::Model model;
@@ -416,6 +566,7 @@ namespace spartan {
             ProgressCallback *progress_callback = nullptr;
             std::string *last_error = nullptr;
             std::set<int> unified_skeleton_nodes;  // 记录哪些节点在统一骨架中
+            std::vector<std::vector<uint8_t>> encoded_images;  // 加载时收集的编码图像（按image索引），解码后释放
 
             // 资源映射表
             std::unordered_map<int, MeshHandle> mesh_handle_map;
@@ -426,25 +577,6 @@ namespace spartan {
 
             // 处理状态
             struct ProcessingContext {
-                // 顶点去重
-                struct VertexKey {
-                    ozz::math::Float3 position;
-                    ozz::math::Float3 normal;
-                    glm::vec2 uv0;  // 使用glm::vec2代替ozz::math::Float2
-                    uint32_t joints[4];
-                    ozz::math::Float4 weights;
-
-                    size_t Hash() const;
-
-                    bool operator==(const VertexKey &other) const;
-                };
-
-                struct VertexKeyHasher {
-                    size_t operator()(const VertexKey &key) const { return key.Hash(); }
-                };
-
-                std::unordered_map<VertexKey, uint32_t, VertexKeyHasher> vertex_cache;
-
                 // 骨骼映射
                 std::unordered_map<std::string, int> bone_name_to_index;
                 std::vector<std::string> bone_names;
@@ -452,14 +584,25 @@ namespace spartan {
                 // 错误收集
                 std::vector<std::string> warnings;
 
+                // 动画时间数组备忘：同一个sampler.input在导入过程中会被反复读取，只验证和统计一次
+                struct TimeArray {
+                    AccessorView<float> times;
+                    std::vector<float> storage;  // 仅在需要类型转换时持有数据
+                    float max_time = 0.0f;
+                };
+                mutable std::unordered_map<int, TimeArray> time_arrays;
+
                 void Clear() {
-                    vertex_cache.clear();
                     bone_name_to_index.clear();
                     bone_names.clear();
                     warnings.clear();
+                    time_arrays.clear();
                 }
             } context;
 
+            // 保护并行阶段中的warnings和last_error
+            std::mutex report_mutex;
+
             // 主要处理函数
             bool LoadGltfFile(const char *path);
 
@@ -478,7 +621,7 @@ namespace spartan {
             bool ValidateAndFinalize();
 
             // 网格处理
-            bool ProcessMesh(int mesh_index);
+            bool ProcessMesh(int mesh_index, MeshData &mesh_data);
 
             bool ProcessPrimitive(MeshData &mesh_data, const tinygltf::Mesh &gltf_mesh,
                                   const tinygltf::Primitive &primitive, int node_index);
@@ -498,6 +641,12 @@ namespace spartan {
             template<typename T>
             std::vector<T> GetAccessorData(int accessor_index) const;
 
+            // 布局与T一致时零拷贝返回缓冲视图，否则转换到scratch并返回指向它的视图
+            template<typename T>
+            AccessorView<T> GetAccessorView(int accessor_index, std::vector<T> &scratch) const;
+
+            const ProcessingContext::TimeArray &GetTimeArray(int accessor_index) const;
+
             ozz::math::Transform GetNodeTransform(const tinygltf::Node &node) const;
 
             VertexFormat DetermineVertexFormat(const tinygltf::Primitive &primitive) const;
@@ -505,6 +654,15 @@ namespace spartan {
             // 优化函数
             void OptimizeVertexCache(MeshData &mesh_data);
 
+            void OptimizeOverdraw(MeshData &mesh_data);
+
+            void OptimizeVertexFetch(MeshData &mesh_data);
+
+            // 顶点量化（在蒙皮索引重映射之后执行）
+            void QuantizeMeshes();
+
+            void QuantizeVertices(MeshData &mesh_data);
+
             void GenerateTangents(MeshData &mesh_data);
 
             // 骨骼处理
@@ -517,7 +675,10 @@ namespace spartan {
 
             void ReportWarning(const std::string &warning);
 
-            void ReportProgress(float progress, const char *stage);
+            void ReportProgress(float progress, const char *stage, double stage_ms);
+
+            // config->parallel_import关闭或任务少于2个时在调用线程上顺序执行
+            void ParallelFor(size_t count, const std::function<void(size_t)> &job) const;
 
             void CollectUnifiedJoints(UnifiedSkeletonData &data);
 
@@ -533,6 +694,12 @@ namespace spartan {
 
             void ProcessAnimationsForUnifiedSkeleton(UnifiedSkeletonData &data);
 
+            // 构建单个动画片段，只写anim_data，可在工作线程上执行
+            bool BuildUnifiedSkeletonAnimation(const tinygltf::Animation &gltf_anim,
+                                               const ozz::animation::Skeleton *skeleton,
+                                               const UnifiedSkeletonData &data,
+                                               AnimationData &anim_data) const;
+
             void ProcessPureNodeAnimations();
 
             glm::mat4 GetNodeLocalMatrix(const tinygltf::Node &node) const;
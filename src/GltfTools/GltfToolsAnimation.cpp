@@ -16,6 +16,7 @@
 #include <set>
 #include <stack>
 #include "GltfTools.h"
+#include "AnimationCompression.h"
 #include "ozz/animation/offline/animation_builder.h"
 #include "ozz/animation/offline/raw_animation.h"
 #include "ozz/animation/offline/skeleton_builder.h"
@@ -515,159 +516,199 @@ namespace spartan {
 
             const auto& skeleton = skeleton_it->second;
 
-            for (size_t anim_idx = 0; anim_idx < model.animations.size(); ++anim_idx) {
+            // 句柄按剪辑顺序预先分配，构建失败的剪辑在汇总时移除，串行和并行模式得到相同的句柄
+            const size_t clip_count = model.animations.size();
+            std::vector<AnimationHandle> handles(clip_count);
+            std::vector<AnimationData*> slots(clip_count);
+            for (size_t anim_idx = 0; anim_idx < clip_count; ++anim_idx) {
                 const auto& gltf_anim = model.animations[anim_idx];
+                handles[anim_idx] = output->handle_generator.Generate<AnimationTag>();
+                slots[anim_idx] = &output->animations[handles[anim_idx]];
 
-                std::cout << "处理动画: '" << gltf_anim.name << "'" << std::endl;
-
-                // 所有动画都通过骨骼动画处理
-                ozz::animation::offline::RawAnimation raw_animation;
-                raw_animation.name = gltf_anim.name.c_str();
-                raw_animation.tracks.resize(skeleton->num_joints());
-
-                // 收集时间点
-                std::set<float> all_times;
+                // 预热时间数组备忘，工作线程只做只读查询
                 for (const auto& channel : gltf_anim.channels) {
-                    if (channel.sampler < 0 || channel.sampler >= static_cast<int>(gltf_anim.samplers.size()))
-                        continue;
-
-                    const auto& sampler = gltf_anim.samplers[channel.sampler];
-                    auto times = GetAccessorData<float>(sampler.input);
-                    all_times.insert(times.begin(), times.end());
+                    if (channel.sampler >= 0 && channel.sampler < static_cast<int>(gltf_anim.samplers.size())) {
+                        GetTimeArray(gltf_anim.samplers[channel.sampler].input);
+                    }
                 }
+            }
 
-                if (!all_times.empty()) {
-                    raw_animation.duration = *all_times.rbegin();
+            std::vector<uint8_t> built(clip_count, 0);
+            ParallelFor(clip_count, [&](size_t anim_idx) {
+                built[anim_idx] = BuildUnifiedSkeletonAnimation(model.animations[anim_idx], skeleton.get(),
+                                                                data, *slots[anim_idx]) ? 1 : 0;
+            });
+
+            for (size_t anim_idx = 0; anim_idx < clip_count; ++anim_idx) {
+                if (built[anim_idx]) {
+                    output->metadata.stats.total_animations++;
                 } else {
-                    raw_animation.duration = 1.0f;
+                    output->animations.erase(handles[anim_idx]);
                 }
+            }
+        }
 
-                // 填充动画轨道
-                for (const auto& channel : gltf_anim.channels) {
-                    if (channel.sampler < 0 || channel.sampler >= static_cast<int>(gltf_anim.samplers.size()))
-                        continue;
+// 构建单个剪辑（只读访问共享状态，可在工作线程上执行）
+        bool GltfProcessor::Impl::BuildUnifiedSkeletonAnimation(const tinygltf::Animation& gltf_anim,
+                                                                const ozz::animation::Skeleton* skeleton,
+                                                                const UnifiedSkeletonData& data,
+                                                                AnimationData& anim_data) const {
+            std::cout << "处理动画: '" << gltf_anim.name << "'" << std::endl;
 
-                    // 查找OZZ关节索引
-                    auto joint_it = data.gltf_node_to_ozz_joint.find(channel.target_node);
-                    if (joint_it == data.gltf_node_to_ozz_joint.end()) {
-                        std::cout << "  警告: 节点 " << channel.target_node
-                                  << " 没有对应的OZZ关节映射" << std::endl;
-                        continue;
-                    }
+            // 所有动画都通过骨骼动画处理
+            ozz::animation::offline::RawAnimation raw_animation;
+            raw_animation.name = gltf_anim.name.c_str();
+            raw_animation.tracks.resize(skeleton->num_joints());
 
-                    int ozz_joint_idx = joint_it->second;
-                    if (ozz_joint_idx < 0 || ozz_joint_idx >= skeleton->num_joints()) {
-                        std::cout << "  警告: OZZ关节索引 " << ozz_joint_idx << " 超出范围" << std::endl;
-                        continue;
-                    }
+            // 时长取所有通道的最大时间点
+            bool has_times = false;
+            float max_time = 0.0f;
+            for (const auto& channel : gltf_anim.channels) {
+                if (channel.sampler < 0 || channel.sampler >= static_cast<int>(gltf_anim.samplers.size()))
+                    continue;
 
-                    const auto& sampler = gltf_anim.samplers[channel.sampler];
-                    auto& track = raw_animation.tracks[ozz_joint_idx];
-                    auto times = GetAccessorData<float>(sampler.input);
+                const auto& time_array = GetTimeArray(gltf_anim.samplers[channel.sampler].input);
+                if (time_array.times.empty()) continue;
+                max_time = has_times ? std::max(max_time, time_array.max_time) : time_array.max_time;
+                has_times = true;
+            }
 
-                    if (times.empty()) continue;
+            raw_animation.duration = has_times ? max_time : 1.0f;
 
-                    std::cout << "  处理通道: " << channel.target_path
-                              << " 对于节点 " << channel.target_node
-                              << " -> OZZ关节 " << ozz_joint_idx << std::endl;
+            // 填充动画轨道
+            for (const auto& channel : gltf_anim.channels) {
+                if (channel.sampler < 0 || channel.sampler >= static_cast<int>(gltf_anim.samplers.size()))
+                    continue;
+
+                // 查找OZZ关节索引
+                auto joint_it = data.gltf_node_to_ozz_joint.find(channel.target_node);
+                if (joint_it == data.gltf_node_to_ozz_joint.end()) {
+                    std::cout << "  警告: 节点 " << channel.target_node
+                              << " 没有对应的OZZ关节映射" << std::endl;
+                    continue;
+                }
 
-                    if (channel.target_path == "translation") {
-                        auto translations = GetAccessorData<glm::vec3>(sampler.output);
-                        if (translations.size() == times.size()) {
-                            track.translations.resize(times.size());
-                            for (size_t i = 0; i < times.size(); ++i) {
-                                track.translations[i] = {times[i], ToOZZ(translations[i])};
-                            }
+                int ozz_joint_idx = joint_it->second;
+                if (ozz_joint_idx < 0 || ozz_joint_idx >= skeleton->num_joints()) {
+                    std::cout << "  警告: OZZ关节索引 " << ozz_joint_idx << " 超出范围" << std::endl;
+                    continue;
+                }
+
+                const auto& sampler = gltf_anim.samplers[channel.sampler];
+                auto& track = raw_animation.tracks[ozz_joint_idx];
+                const auto& times = GetTimeArray(sampler.input).times;
+
+                if (times.empty()) continue;
+
+                std::cout << "  处理通道: " << channel.target_path
+                          << " 对于节点 " << channel.target_node
+                          << " -> OZZ关节 " << ozz_joint_idx << std::endl;
+
+                if (channel.target_path == "translation") {
+                    std::vector<glm::vec3> scratch;
+                    auto translations = GetAccessorView<glm::vec3>(sampler.output, scratch);
+                    if (translations.size() == times.size()) {
+                        track.translations.resize(times.size());
+                        for (size_t i = 0; i < times.size(); ++i) {
+                            track.translations[i] = {times[i], ToOZZ(translations[i])};
                         }
-                    } else if (channel.target_path == "rotation") {
-                        auto rotations = GetAccessorData<glm::vec4>(sampler.output);
-                        if (rotations.size() == times.size()) {
-                            track.rotations.resize(times.size());
-                            for (size_t i = 0; i < times.size(); ++i) {
-                                glm::quat q(rotations[i].w, rotations[i].x, rotations[i].y, rotations[i].z);
-                                q = glm::normalize(q);
-                                track.rotations[i] = {times[i], ozz::math::Quaternion(q.x, q.y, q.z, q.w)};
-                            }
+                    }
+                } else if (channel.target_path == "rotation") {
+                    std::vector<glm::vec4> scratch;
+                    auto rotations = GetAccessorView<glm::vec4>(sampler.output, scratch);
+                    if (rotations.size() == times.size()) {
+                        track.rotations.resize(times.size());
+                        for (size_t i = 0; i < times.size(); ++i) {
+                            glm::vec4 r = rotations[i];
+                            glm::quat q(r.w, r.x, r.y, r.z);
+                            q = glm::normalize(q);
+                            track.rotations[i] = {times[i], ozz::math::Quaternion(q.x, q.y, q.z, q.w)};
                         }
-                    } else if (channel.target_path == "scale") {
-                        auto scales = GetAccessorData<glm::vec3>(sampler.output);
-                        if (scales.size() == times.size()) {
-                            track.scales.resize(times.size());
-                            for (size_t i = 0; i < times.size(); ++i) {
-                                track.scales[i] = {times[i], ToOZZ(scales[i])};
-                            }
+                    }
+                } else if (channel.target_path == "scale") {
+                    std::vector<glm::vec3> scratch;
+                    auto scales = GetAccessorView<glm::vec3>(sampler.output, scratch);
+                    if (scales.size() == times.size()) {
+                        track.scales.resize(times.size());
+                        for (size_t i = 0; i < times.size(); ++i) {
+                            track.scales[i] = {times[i], ToOZZ(scales[i])};
                         }
                     }
                 }
+            }
 
-                // 为没有动画的轨道填充静态数据
-                for (int j = 0; j < skeleton->num_joints(); ++j) {
-                    auto& track = raw_animation.tracks[j];
-
-                    if (track.translations.empty() || track.rotations.empty() || track.scales.empty()) {
-                        // 获取绑定姿势
-                        ozz::math::Transform bind_pose;
-                        bind_pose.translation = ozz::math::Float3(0.0f, 0.0f, 0.0f);
-                        bind_pose.rotation = ozz::math::Quaternion(0.0f, 0.0f, 0.0f, 1.0f);
-                        bind_pose.scale = ozz::math::Float3(1.0f, 1.0f, 1.0f);
-
-                        // 从GLTF节点获取绑定姿势
-                        for (const auto& [gltf_idx, ozz_idx] : data.gltf_node_to_ozz_joint) {
-                            if (ozz_idx == j && gltf_idx < static_cast<int>(model.nodes.size())) {
-                                bind_pose = GetNodeTransform(model.nodes[gltf_idx]);
-                                break;
-                            }
-                        }
+            // 为没有动画的轨道填充静态数据
+            for (int j = 0; j < skeleton->num_joints(); ++j) {
+                auto& track = raw_animation.tracks[j];
 
-                        if (track.translations.empty()) {
-                            track.translations.push_back({0.0f, bind_pose.translation});
-                        }
-                        if (track.rotations.empty()) {
-                            track.rotations.push_back({0.0f, bind_pose.rotation});
-                        }
-                        if (track.scales.empty()) {
-                            track.scales.push_back({0.0f, bind_pose.scale});
+                if (track.translations.empty() || track.rotations.empty() || track.scales.empty()) {
+                    // 获取绑定姿势
+                    ozz::math::Transform bind_pose;
+                    bind_pose.translation = ozz::math::Float3(0.0f, 0.0f, 0.0f);
+                    bind_pose.rotation = ozz::math::Quaternion(0.0f, 0.0f, 0.0f, 1.0f);
+                    bind_pose.scale = ozz::math::Float3(1.0f, 1.0f, 1.0f);
+
+                    // 从GLTF节点获取绑定姿势
+                    for (const auto& [gltf_idx, ozz_idx] : data.gltf_node_to_ozz_joint) {
+                        if (ozz_idx == j && gltf_idx < static_cast<int>(model.nodes.size())) {
+                            bind_pose = GetNodeTransform(model.nodes[gltf_idx]);
+                            break;
                         }
                     }
+
+                    if (track.translations.empty()) {
+                        track.translations.push_back({0.0f, bind_pose.translation});
+                    }
+                    if (track.rotations.empty()) {
+                        track.rotations.push_back({0.0f, bind_pose.rotation});
+                    }
+                    if (track.scales.empty()) {
+                        track.scales.push_back({0.0f, bind_pose.scale});
+                    }
                 }
+            }
 
-                // 构建最终动画
-                if (raw_animation.Validate()) {
-                    ozz::animation::offline::AnimationBuilder builder;
-                    auto animation = builder(raw_animation);
-
-                    if (animation) {
-                        AnimationHandle handle = output->handle_generator.Generate<AnimationTag>();
-                        AnimationData& anim_data = output->animations[handle];
-
-                        anim_data.name = gltf_anim.name.c_str();
-                        anim_data.duration = raw_animation.duration;
-                        anim_data.target_skeleton = data.skeleton_handle;
-                        anim_data.skeletal_animation.reset(animation.release());
-
-                        // +++ 新增：自动检测并存储根运动骨骼索引 +++
-                        for (const auto& channel : gltf_anim.channels) {
-                            if (channel.target_path == "translation") {
-                                auto it = data.gltf_node_to_ozz_joint.find(channel.target_node);
-                                if (it != data.gltf_node_to_ozz_joint.end()) {
-                                    // 找到了第一个带位移动画的关节，标记它
-                                    anim_data.root_motion_joint_index = it->second;
-                                    std::cout << "  动画 '" << anim_data.name.c_str()
-                                              << "' 的根运动关节被识别为: OZZ关节 "
-                                              << it->second << std::endl;
-                                    break; // 找到第一个就停止
-                                }
-                            }
-                        }
+            // 构建最终动画
+            if (raw_animation.Validate()) {
+                // 先按容差删除冗余关键帧，剪辑越小采样时缓存越友好，资源包也越小
+                AnimationCompressionStats compression;
+                CompressRawAnimation(raw_animation, *skeleton, *config, compression);
 
-                        output->metadata.stats.total_animations++;
+                ozz::animation::offline::AnimationBuilder builder;
+                auto animation = builder(raw_animation);
+
+                if (animation) {
+                    compression.runtime_bytes = animation->size();
+                    std::cout << "  动画 '" << gltf_anim.name << "' 压缩: "
+                              << FormatAnimationCompressionStats(compression) << std::endl;
 
-                        std::cout << "  成功创建动画，时长: " << anim_data.duration << "秒" << std::endl;
+                    anim_data.name = gltf_anim.name.c_str();
+                    anim_data.duration = raw_animation.duration;
+                    anim_data.target_skeleton = data.skeleton_handle;
+                    anim_data.skeletal_animation = std::move(animation);
+
+                    // +++ 新增：自动检测并存储根运动骨骼索引 +++
+                    for (const auto& channel : gltf_anim.channels) {
+                        if (channel.target_path == "translation") {
+                            auto it = data.gltf_node_to_ozz_joint.find(channel.target_node);
+                            if (it != data.gltf_node_to_ozz_joint.end()) {
+                                // 找到了第一个带位移动画的关节，标记它
+                                anim_data.root_motion_joint_index = it->second;
+                                std::cout << "  动画 '" << anim_data.name.c_str()
+                                          << "' 的根运动关节被识别为: OZZ关节 "
+                                          << it->second << std::endl;
+                                break; // 找到第一个就停止
+                            }
+                        }
                     }
-                } else {
-                    std::cout << "  警告: 动画验证失败" << std::endl;
+
+                    std::cout << "  成功创建动画，时长: " << anim_data.duration << "秒" << std::endl;
+                    return true;
                 }
+            } else {
+                std::cout << "  警告: 动画验证失败" << std::endl;
             }
+            return false;
         }
 
         void GltfProcessor::Impl::ProcessPureNodeAnimations() {
@@ -685,10 +726,9 @@ namespace spartan {
                 float max_time = 0.0f;
                 for (const auto& channel : gltf_anim.channels) {
                     if (channel.sampler >= 0 && channel.sampler < static_cast<int>(gltf_anim.samplers.size())) {
-                        const auto& sampler = gltf_anim.samplers[channel.sampler];
-                        auto times = GetAccessorData<float>(sampler.input);
-                        if (!times.empty()) {
-                            max_time = std::max(max_time, times.back());
+                        const auto& time_array = GetTimeArray(gltf_anim.samplers[channel.sampler].input);
+                        if (!time_array.times.empty()) {
+                            max_time = std::max(max_time, time_array.max_time);
                         }
                     }
                 }
@@ -703,7 +743,7 @@ namespace spartan {
                     int target_node = channel.target_node;
                     const auto& sampler = gltf_anim.samplers[channel.sampler];
 
-                    auto times = GetAccessorData<float>(sampler.input);
+                    const auto& times = GetTimeArray(sampler.input).times;
                     if (times.empty()) continue;
 
                     // 获取或创建节点变换数据
@@ -712,9 +752,10 @@ namespace spartan {
                     std::cout << "  处理节点 " << target_node << " 的 " << channel.target_path << " 动画" << std::endl;
 
                     if (channel.target_path == "translation") {
-                        auto translations = GetAccessorData<glm::vec3>(sampler.output);
+                        std::vector<glm::vec3> scratch;
+                        auto translations = GetAccessorView<glm::vec3>(sampler.output, scratch);
                         if (translations.size() == times.size()) {
-                            node_data.position_times = times;
+                            node_data.position_times = times.ToVector();
                             node_data.position_values.clear();
                             node_data.position_values.reserve(translations.size());
                             for (const auto& trans : translations) {
@@ -723,9 +764,10 @@ namespace spartan {
                         }
                     }
                     else if (channel.target_path == "rotation") {
-                        auto rotations = GetAccessorData<glm::vec4>(sampler.output);
+                        std::vector<glm::vec4> scratch;
+                        auto rotations = GetAccessorView<glm::vec4>(sampler.output, scratch);
                         if (rotations.size() == times.size()) {
-                            node_data.rotation_times = times;
+                            node_data.rotation_times = times.ToVector();
                             node_data.rotation_values.clear();
                             node_data.rotation_values.reserve(rotations.size());
                             for (const auto& rot : rotations) {
@@ -736,9 +778,10 @@ namespace spartan {
                         }
                     }
                     else if (channel.target_path == "scale") {
-                        auto scales = GetAccessorData<glm::vec3>(sampler.output);
+                        std::vector<glm::vec3> scratch;
+                        auto scales = GetAccessorView<glm::vec3>(sampler.output, scratch);
                         if (scales.size() == times.size()) {
-                            node_data.scale_times = times;
+                            node_data.scale_times = times.ToVector();
                             node_data.scale_values.clear();
                             node_data.scale_values.reserve(scales.size());
                             for (const auto& scale : scales) {
@@ -771,52 +814,63 @@ namespace spartan {
             impl_->progress_callback = &progress_callback_;
             impl_->last_error = &last_error_;
             impl_->context.Clear();
+            stage_timings_.clear();
+
+            // 执行一个阶段并记录耗时，阶段完成后回调进度
+            auto run_stage = [this](float progress, const char* stage, auto&& fn) {
+                auto stage_start = std::chrono::high_resolution_clock::now();
+                bool ok = fn();
+                double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::high_resolution_clock::now() - stage_start).count();
+                stage_timings_.push_back({stage, ms});
+                if (ok) {
+                    impl_->ReportProgress(progress, stage, ms);
+                }
+                return ok;
+            };
 
             // 加载GLTF文件
-            impl_->ReportProgress(0.1f, "Loading GLTF file");
-            if (!impl_->LoadGltfFile(input_path)) {
+            if (!run_stage(0.1f, "Loading GLTF file", [&] { return impl_->LoadGltfFile(input_path); })) {
                 return false;
             }
 
             // 处理纹理
-            impl_->ReportProgress(0.2f, "Processing textures");
-            if (!impl_->ProcessTextures()) {
+            if (!run_stage(0.2f, "Processing textures", [&] { return impl_->ProcessTextures(); })) {
                 return false;
             }
 
             // 处理材质
-            impl_->ReportProgress(0.3f, "Processing materials");
-            if (!impl_->ProcessMaterials()) {
+            if (!run_stage(0.3f, "Processing materials", [&] { return impl_->ProcessMaterials(); })) {
                 return false;
             }
 
             // 处理骨骼
-            impl_->ReportProgress(0.6f, "Processing skeletons");
-            if (!impl_->ProcessSkeletons()) {
+            if (!run_stage(0.35f, "Processing skeletons", [&] { return impl_->ProcessSkeletons(); })) {
                 return false;
             }
 
             // 处理网格
-            impl_->ReportProgress(0.4f, "Processing meshes");
-            if (!impl_->ProcessMeshes()) {
+            if (!run_stage(0.6f, "Processing meshes", [&] { return impl_->ProcessMeshes(); })) {
                 return false;
             }
 
             // 处理动画
-            impl_->ReportProgress(0.7f, "Processing animations");
-            if (!impl_->ProcessAnimations()) {
+            if (!run_stage(0.7f, "Processing animations", [&] { return impl_->ProcessAnimations(); })) {
                 return false;
             }
 
+            // 顶点量化：动画阶段会按float/u16布局改写蒙皮属性，必须放在它之后
+            if (config_.quantize_vertices) {
+                run_stage(0.75f, "Quantizing vertices", [&] { impl_->QuantizeMeshes(); return true; });
+            }
+
             // 处理场景节点
-            impl_->ReportProgress(0.8f, "Processing scene nodes");
-            if (!impl_->ProcessSceneNodes()) {
+            if (!run_stage(0.8f, "Processing scene nodes", [&] { return impl_->ProcessSceneNodes(); })) {
                 return false;
             }
 
             // 验证和完成
-            impl_->ReportProgress(0.9f, "Validating and finalizing");
-            if (!impl_->ValidateAndFinalize()) {
+            if (!run_stage(0.9f, "Validating and finalizing", [&] { return impl_->ValidateAndFinalize(); })) {
                 return false;
             }
 
@@ -827,13 +881,17 @@ namespace spartan {
             auto end_time = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-            ozz::log::Out() << "GLTF processing completed in " << duration.count() << "ms" << std::endl;
+            ozz::log::Out() << "GLTF processing completed in " << duration.count() << "ms"
+                            << (config_.parallel_import ? " (parallel)" : "") << std::endl;
+            for (const auto& timing : stage_timings_) {
+                ozz::log::Out() << "  " << timing.stage << ": " << timing.milliseconds << "ms" << std::endl;
+            }
             ozz::log::Out() << "Stats: " << output.metadata.stats.total_vertices << " vertices, "
                             << output.metadata.stats.total_triangles << " triangles, "
                             << output.metadata.stats.total_bones << " bones, "
                             << output.metadata.stats.total_animations << " animations" << std::endl;
 
-            impl_->ReportProgress(1.0f, "Complete");
+            impl_->ReportProgress(1.0f, "Complete", std::chrono::duration<double, std::milli>(end_time - start_time).count());
 
             return true;
         }
@@ -1138,28 +1196,36 @@ namespace spartan {
                 if (channel.sampler < 0 || channel.sampler >= static_cast<int>(anim.samplers.size())) continue;
 
                 const auto& sampler = anim.samplers[channel.sampler];
-                auto times = GetAccessorData<float>(sampler.input);
+                const auto& times = GetTimeArray(sampler.input).times;
 
                 if (times.empty()) continue;
 
-                // 查找时间点
+                // 二分查找time所在的关键帧区间，区间外夹到首尾关键帧
                 size_t idx = 0;
-                for (size_t i = 0; i < times.size() - 1; ++i) {
-                    if (time >= times[i] && time <= times[i + 1]) {
-                        idx = i;
-                        break;
+                size_t low = 0;
+                size_t high = times.size();
+                while (low < high) {
+                    size_t mid = (low + high) / 2;
+                    if (times[mid] <= time) {
+                        low = mid + 1;
+                    } else {
+                        high = mid;
                     }
                 }
+                if (low > 0) {
+                    idx = std::min(low - 1, times.size() > 1 ? times.size() - 2 : size_t(0));
+                }
 
                 // 计算插值因子
                 float t = 0.0f;
                 if (idx < times.size() - 1 && times[idx + 1] > times[idx]) {
-                    t = (time - times[idx]) / (times[idx + 1] - times[idx]);
+                    t = glm::clamp((time - times[idx]) / (times[idx + 1] - times[idx]), 0.0f, 1.0f);
                 }
 
-                // 应用动画值
+                // 应用动画值（输出数组直接引用glTF缓冲）
                 if (channel.target_path == "translation") {
-                    auto translations = GetAccessorData<glm::vec3>(sampler.output);
+                    std::vector<glm::vec3> scratch;
+                    auto translations = GetAccessorView<glm::vec3>(sampler.output, scratch);
                     if (idx < translations.size()) {
                         if (idx < translations.size() - 1) {
                             translation = glm::mix(translations[idx], translations[idx + 1], t);
@@ -1168,18 +1234,22 @@ namespace spartan {
                         }
                     }
                 } else if (channel.target_path == "rotation") {
-                    auto rotations = GetAccessorData<glm::vec4>(sampler.output);
+                    std::vector<glm::vec4> scratch;
+                    auto rotations = GetAccessorView<glm::vec4>(sampler.output, scratch);
                     if (idx < rotations.size()) {
-                        glm::quat q0(rotations[idx].w, rotations[idx].x, rotations[idx].y, rotations[idx].z);
+                        glm::vec4 r0 = rotations[idx];
+                        glm::quat q0(r0.w, r0.x, r0.y, r0.z);
                         if (idx < rotations.size() - 1) {
-                            glm::quat q1(rotations[idx + 1].w, rotations[idx + 1].x, rotations[idx + 1].y, rotations[idx + 1].z);
+                            glm::vec4 r1 = rotations[idx + 1];
+                            glm::quat q1(r1.w, r1.x, r1.y, r1.z);
                             rotation = glm::slerp(q0, q1, t);
                         } else {
                             rotation = q0;
                         }
                     }
                 } else if (channel.target_path == "scale") {
-                    auto scales = GetAccessorData<glm::vec3>(sampler.output);
+                    std::vector<glm::vec3> scratch;
+                    auto scales = GetAccessorView<glm::vec3>(sampler.output, scratch);
                     if (idx < scales.size()) {
                         if (idx < scales.size() - 1) {
                             scale = glm::mix(scales[idx], scales[idx + 1], t);
@@ -1265,17 +1335,19 @@ namespace spartan {
 
             const auto& skeleton = skeleton_it->second;
 
-            // 1. 收集所有时间点
-            std::set<float> all_times;
+            // 1. 时长取所有通道的最大时间点
+            bool has_times = false;
+            float max_time = 0.0f;
             for (const auto& channel : gltf_anim.channels) {
                 if (channel.sampler < 0 || channel.sampler >= static_cast<int>(gltf_anim.samplers.size())) continue;
 
-                const auto& sampler = gltf_anim.samplers[channel.sampler];
-                auto times = GetAccessorData<float>(sampler.input);
-                all_times.insert(times.begin(), times.end());
+                const auto& time_array = GetTimeArray(gltf_anim.samplers[channel.sampler].input);
+                if (time_array.times.empty()) continue;
+                max_time = has_times ? std::max(max_time, time_array.max_time) : time_array.max_time;
+                has_times = true;
             }
 
-            float duration = all_times.empty() ? 1.0f : *all_times.rbegin();
+            float duration = has_times ? max_time : 1.0f;
             float fps = 30.0f; // 采样率
             float time_step = 1.0f / fps;
 
@@ -1365,17 +1437,24 @@ namespace spartan {
 
             // 5. 构建最终动画
             if (raw_animation.Validate()) {
+                AnimationCompressionStats compression;
+                CompressRawAnimation(raw_animation, *skeleton, *config, compression);
+
                 ozz::animation::offline::AnimationBuilder builder;
                 auto animation = builder(raw_animation);
 
                 if (animation) {
+                    compression.runtime_bytes = animation->size();
+                    std::cout << "动画 '" << gltf_anim.name << "' 压缩: "
+                              << FormatAnimationCompressionStats(compression) << std::endl;
+
                     out_handle = output->handle_generator.Generate<AnimationTag>();
                     AnimationData& anim_data = output->animations[out_handle];
 
                     anim_data.name = gltf_anim.name.c_str();
                     anim_data.duration = raw_animation.duration;
                     anim_data.target_skeleton = unified_data.skeleton_handle;
-                    anim_data.skeletal_animation.reset(animation.release());
+                    anim_data.skeletal_animation = std::move(animation);
 
                     output->metadata.stats.total_animations++;
 
@@ -0,0 +1,100 @@
+#include "MappedFile.h"
+
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SPARTAN_HAS_MMAP 1
+#endif
+
+namespace spartan {
+    namespace asset {
+
+        MappedFile::~MappedFile() {
+            Close();
+        }
+
+        bool MappedFile::Open(const char* path) {
+            Close();
+
+#ifdef SPARTAN_HAS_MMAP
+            int fd = ::open(path, O_RDONLY);
+            if (fd < 0) {
+                last_error_ = std::string("Failed to open file: ") + path;
+                return false;
+            }
+
+            struct stat st;
+            if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+                ::close(fd);
+                last_error_ = std::string("Failed to stat file or file is empty: ") + path;
+                return false;
+            }
+
+            void* address = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            // 映射建立后即可关闭描述符
+            ::close(fd);
+            if (address != MAP_FAILED) {
+                data_ = static_cast<const uint8_t*>(address);
+                size_ = static_cast<size_t>(st.st_size);
+                mapped_ = true;
+                return true;
+            }
+            // mmap失败（例如某些虚拟文件系统）时走读入内存的路径
+#endif
+
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file.is_open()) {
+                last_error_ = std::string("Failed to open file: ") + path;
+                return false;
+            }
+
+            std::streamsize file_size = file.tellg();
+            if (file_size <= 0) {
+                last_error_ = std::string("File is empty: ") + path;
+                return false;
+            }
+
+            fallback_.resize(static_cast<size_t>(file_size));
+            file.seekg(0, std::ios::beg);
+            if (!file.read(reinterpret_cast<char*>(fallback_.data()), file_size)) {
+                fallback_.clear();
+                last_error_ = std::string("Failed to read file: ") + path;
+                return false;
+            }
+
+            data_ = fallback_.data();
+            size_ = fallback_.size();
+            mapped_ = false;
+            return true;
+        }
+
+        void MappedFile::Close() {
+#ifdef SPARTAN_HAS_MMAP
+            if (mapped_ && data_) {
+                ::munmap(const_cast<uint8_t*>(data_), size_);
+            }
+#endif
+            fallback_.clear();
+            fallback_.shrink_to_fit();
+            data_ = nullptr;
+            size_ = 0;
+            mapped_ = false;
+        }
+
+        std::shared_ptr<MappedFile> MappedFile::OpenShared(const char* path, std::string* error) {
+            auto file = std::make_shared<MappedFile>();
+            if (!file->Open(path)) {
+                if (error) {
+                    *error = file->GetLastError();
+                }
+                return nullptr;
+            }
+            return file;
+        }
+
+    } // namespace asset
+} // namespace spartan
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spartan {
+    namespace asset {
+
+// 只读文件映射：POSIX下使用mmap，其他平台退化为一次性读入内存
+        class MappedFile {
+        public:
+            MappedFile() = default;
+            ~MappedFile();
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            // 打开并映射整个文件，失败时返回false并可通过GetLastError获取原因
+            bool Open(const char* path);
+            void Close();
+
+            const uint8_t* Data() const { return data_; }
+            size_t Size() const { return size_; }
+            bool IsOpen() const { return data_ != nullptr; }
+            bool IsMapped() const { return mapped_; }  // false表示使用了读入内存的回退路径
+
+            const std::string& GetLastError() const { return last_error_; }
+
+            // 打开文件并返回共享所有权的映射，供零拷贝加载的网格持有
+            static std::shared_ptr<MappedFile> OpenShared(const char* path, std::string* error = nullptr);
+
+        private:
+            const uint8_t* data_ = nullptr;
+            size_t size_ = 0;
+            bool mapped_ = false;
+            std::vector<uint8_t> fallback_;
+            std::string last_error_;
+        };
+
+    } // namespace asset
+} // namespace spartan
@@ -0,0 +1,878 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <limits>
+#include <vector>
+#include <unordered_map>
+
+#include <glm/gtc/packing.hpp>
+
+namespace spartan {
+    namespace asset {
+
+        namespace {
+
+            // Forsyth算法参数（与原实现保持一致）
+            constexpr int FORSYTH_CACHE_SIZE = 32;
+            constexpr float CACHE_DECAY_POWER = 1.5f;
+            constexpr float LAST_TRI_SCORE = 0.75f;
+            constexpr float VALENCE_BOOST_SCALE = 2.0f;
+            constexpr float VALENCE_BOOST_POWER = 0.5f;
+            constexpr uint32_t VALENCE_TABLE_SIZE = 64;
+            constexpr uint32_t INVALID_TRIANGLE = UINT32_MAX;
+
+            // 顶点读取模拟：64字节缓存行，16KB容量
+            constexpr uint32_t FETCH_CACHE_LINE_SIZE = 64;
+            constexpr uint32_t FETCH_CACHE_LINE_COUNT = 256;
+
+            // 过度绘制统计使用的光栅网格分辨率
+            constexpr int OVERDRAW_GRID_SIZE = 256;
+
+            // 预先计算的分数表，避免在内循环里调用pow
+            struct ForsythScoreTables {
+                float cache[FORSYTH_CACHE_SIZE];
+                float valence[VALENCE_TABLE_SIZE];
+
+                ForsythScoreTables() {
+                    for (int i = 0; i < FORSYTH_CACHE_SIZE; ++i) {
+                        if (i < 3) {
+                            cache[i] = LAST_TRI_SCORE;
+                        } else {
+                            const float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+                            cache[i] = std::pow(1.0f - (i - 3) * scale, CACHE_DECAY_POWER);
+                        }
+                    }
+                    valence[0] = 0.0f;
+                    for (uint32_t i = 1; i < VALENCE_TABLE_SIZE; ++i) {
+                        valence[i] = VALENCE_BOOST_SCALE * std::pow(static_cast<float>(i), -VALENCE_BOOST_POWER);
+                    }
+                }
+
+                float Score(int cache_position, uint32_t remaining_triangles) const {
+                    // 没有剩余三角形的顶点不会再参与任何三角形的评分
+                    if (remaining_triangles == 0) {
+                        return 0.0f;
+                    }
+
+                    float score = cache_position >= 0 ? cache[cache_position] : 0.0f;
+                    if (remaining_triangles < VALENCE_TABLE_SIZE) {
+                        score += valence[remaining_triangles];
+                    } else {
+                        score += VALENCE_BOOST_SCALE *
+                                 std::pow(static_cast<float>(remaining_triangles), -VALENCE_BOOST_POWER);
+                    }
+                    return score;
+                }
+            };
+
+            const ForsythScoreTables& GetScoreTables() {
+                static const ForsythScoreTables tables;
+                return tables;
+            }
+
+            /**
+             * 用时间戳模拟FIFO缓存处理一个三角形
+             * @return 本三角形的未命中数
+             */
+            uint32_t UpdateFifoCache(const uint32_t* tri, uint32_t cache_size,
+                                     uint32_t* timestamps, uint32_t& time) {
+                uint32_t misses = 0;
+                for (int k = 0; k < 3; ++k) {
+                    if (time - timestamps[tri[k]] > cache_size) {
+                        timestamps[tri[k]] = time++;
+                        misses++;
+                    }
+                }
+                return misses;
+            }
+
+            bool IndicesInRange(const uint32_t* indices, size_t index_count, uint32_t vertex_count) {
+                for (size_t i = 0; i < index_count; ++i) {
+                    if (indices[i] >= vertex_count) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            glm::vec3 LoadPosition(const uint8_t* positions, size_t stride, uint32_t vertex) {
+                glm::vec3 position;
+                std::memcpy(&position, positions + vertex * stride, sizeof(position));
+                return position;
+            }
+
+            // 三角形簇：[begin, end)为三角形序号范围
+            struct TriangleCluster {
+                uint32_t begin = 0;
+                uint32_t end = 0;
+                float sort_key = 0.0f;
+            };
+
+            /**
+             * 按轴向正交投影光栅化整个网格，累加过度绘制统计
+             * @param axis 观察轴
+             * @param sign 相机位于轴正方向为1，负方向为-1
+             */
+            void RasterizeOverdrawView(const std::vector<glm::vec3>& grid_positions, const uint32_t* indices,
+                                       size_t triangle_count, int axis, float sign,
+                                       std::vector<float>& depth_buffer, OverdrawStats& stats) {
+                const int u = (axis + 1) % 3;
+                const int v = (axis + 2) % 3;
+                std::fill(depth_buffer.begin(), depth_buffer.end(), std::numeric_limits<float>::max());
+
+                for (size_t t = 0; t < triangle_count; ++t) {
+                    const glm::vec3& a = grid_positions[indices[t * 3 + 0]];
+                    const glm::vec3& b = grid_positions[indices[t * 3 + 1]];
+                    const glm::vec3& c = grid_positions[indices[t * 3 + 2]];
+
+                    // 面积即法线在观察轴上的分量，朝向相机才绘制
+                    float area = (b[u] - a[u]) * (c[v] - a[v]) - (b[v] - a[v]) * (c[u] - a[u]);
+                    if (area * sign <= 0.0f) {
+                        continue;
+                    }
+
+                    int min_x = std::max(0, static_cast<int>(std::floor(std::min({a[u], b[u], c[u]}))));
+                    int max_x = std::min(OVERDRAW_GRID_SIZE - 1, static_cast<int>(std::ceil(std::max({a[u], b[u], c[u]}))));
+                    int min_y = std::max(0, static_cast<int>(std::floor(std::min({a[v], b[v], c[v]}))));
+                    int max_y = std::min(OVERDRAW_GRID_SIZE - 1, static_cast<int>(std::ceil(std::max({a[v], b[v], c[v]}))));
+
+                    // 深度越小越靠近相机
+                    const float za = -sign * a[axis];
+                    const float zb = -sign * b[axis];
+                    const float zc = -sign * c[axis];
+                    const float inv_area = 1.0f / area;
+
+                    for (int y = min_y; y <= max_y; ++y) {
+                        for (int x = min_x; x <= max_x; ++x) {
+                            const float px = x + 0.5f;
+                            const float py = y + 0.5f;
+                            float l0 = ((c[u] - b[u]) * (py - b[v]) - (c[v] - b[v]) * (px - b[u])) * inv_area;
+                            float l1 = ((a[u] - c[u]) * (py - c[v]) - (a[v] - c[v]) * (px - c[u])) * inv_area;
+                            float l2 = 1.0f - l0 - l1;
+                            if (l0 < 0.0f || l1 < 0.0f || l2 < 0.0f) {
+                                continue;
+                            }
+
+                            float z = l0 * za + l1 * zb + l2 * zc;
+                            float& stored = depth_buffer[static_cast<size_t>(y) * OVERDRAW_GRID_SIZE + x];
+                            if (z < stored) {
+                                if (stored == std::numeric_limits<float>::max()) {
+                                    stats.pixels_covered++;
+                                }
+                                stored = z;
+                                stats.pixels_shaded++;
+                            }
+                        }
+                    }
+                }
+            }
+
+            void PrintCacheStats(const char* label, const VertexCacheStats& stats) {
+                std::cout << "  " << label << ": ACMR " << std::fixed << std::setprecision(3) << stats.acmr
+                          << ", ATVR " << stats.atvr << std::defaultfloat << std::endl;
+            }
+
+            // 生成grid_size x grid_size个四边形的规则网格
+            std::vector<uint32_t> GenerateGridIndices(uint32_t grid_size) {
+                std::vector<uint32_t> indices;
+                indices.reserve(static_cast<size_t>(grid_size) * grid_size * 6);
+
+                const uint32_t row = grid_size + 1;
+                for (uint32_t y = 0; y < grid_size; ++y) {
+                    for (uint32_t x = 0; x < grid_size; ++x) {
+                        uint32_t v0 = y * row + x;
+                        uint32_t v1 = v0 + 1;
+                        uint32_t v2 = v0 + row;
+                        uint32_t v3 = v2 + 1;
+                        indices.insert(indices.end(), {v0, v2, v1, v1, v2, v3});
+                    }
+                }
+                return indices;
+            }
+
+            // 生成未焊接的网格：每个三角形独立写出三个顶点（位置+法线+UV，32字节），与glTF导出器的常见输出一致
+            std::vector<uint8_t> GenerateUnweldedGrid(uint32_t grid_size, uint32_t* out_vertex_count) {
+                constexpr uint32_t STRIDE = 32;
+                std::vector<uint32_t> indices = GenerateGridIndices(grid_size);
+                std::vector<uint8_t> vertices(indices.size() * STRIDE);
+
+                const uint32_t row = grid_size + 1;
+                for (size_t i = 0; i < indices.size(); ++i) {
+                    uint32_t x = indices[i] % row;
+                    uint32_t y = indices[i] / row;
+                    float attributes[8] = {
+                            static_cast<float>(x), 0.0f, static_cast<float>(y),
+                            0.0f, 1.0f, 0.0f,
+                            static_cast<float>(x) / grid_size, static_cast<float>(y) / grid_size};
+                    std::memcpy(vertices.data() + i * STRIDE, attributes, STRIDE);
+                }
+
+                *out_vertex_count = static_cast<uint32_t>(indices.size());
+                return vertices;
+            }
+
+            constexpr uint32_t DEDUP_EMPTY_SLOT = UINT32_MAX;
+
+        } // namespace
+
+// =========================================================================
+// 顶点缓存优化
+// =========================================================================
+
+        void OptimizeVertexCacheForsyth(uint32_t* indices, size_t index_count, uint32_t vertex_count) {
+            const size_t triangle_count = index_count / 3;
+            if (triangle_count < 2 || vertex_count == 0 ||
+                !IndicesInRange(indices, triangle_count * 3, vertex_count)) {
+                return;
+            }
+
+            const ForsythScoreTables& tables = GetScoreTables();
+
+            // 构建顶点->三角形邻接表（CSR布局）
+            // 每个顶点列表的前remaining[v]项是尚未输出的三角形，输出后与末尾交换移除
+            std::vector<uint32_t> adjacency_offset(static_cast<size_t>(vertex_count) + 1, 0);
+            for (size_t i = 0; i < triangle_count * 3; ++i) {
+                adjacency_offset[indices[i] + 1]++;
+            }
+            for (uint32_t v = 0; v < vertex_count; ++v) {
+                adjacency_offset[v + 1] += adjacency_offset[v];
+            }
+
+            std::vector<uint32_t> adjacency(triangle_count * 3);
+            std::vector<uint32_t> remaining(vertex_count, 0);
+            for (size_t t = 0; t < triangle_count; ++t) {
+                for (int k = 0; k < 3; ++k) {
+                    uint32_t v = indices[t * 3 + k];
+                    adjacency[adjacency_offset[v] + remaining[v]++] = static_cast<uint32_t>(t);
+                }
+            }
+
+            // 初始分数
+            std::vector<int> cache_position(vertex_count, -1);
+            std::vector<float> vertex_score(vertex_count);
+            for (uint32_t v = 0; v < vertex_count; ++v) {
+                vertex_score[v] = tables.Score(-1, remaining[v]);
+            }
+
+            std::vector<float> triangle_score(triangle_count);
+            std::vector<uint8_t> emitted(triangle_count, 0);
+            uint32_t best_triangle = 0;
+            float best_score = -1.0f;
+            for (size_t t = 0; t < triangle_count; ++t) {
+                const uint32_t* tri = indices + t * 3;
+                triangle_score[t] = vertex_score[tri[0]] + vertex_score[tri[1]] + vertex_score[tri[2]];
+                if (triangle_score[t] > best_score) {
+                    best_score = triangle_score[t];
+                    best_triangle = static_cast<uint32_t>(t);
+                }
+            }
+
+            std::vector<uint32_t> optimized_indices(triangle_count * 3);
+            uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+            uint32_t new_cache[FORSYTH_CACHE_SIZE + 3];
+            size_t cache_count = 0;
+            size_t scan_cursor = 0;
+
+            for (size_t output = 0; output < triangle_count; ++output) {
+                // 缓存邻域里没有剩余三角形时，按游标取下一个未输出的三角形
+                // 游标只前进不后退，整体扫描代价为O(T)
+                if (best_triangle == INVALID_TRIANGLE) {
+                    while (emitted[scan_cursor]) {
+                        ++scan_cursor;
+                    }
+                    best_triangle = static_cast<uint32_t>(scan_cursor);
+                }
+
+                const uint32_t* tri = indices + static_cast<size_t>(best_triangle) * 3;
+                std::memcpy(&optimized_indices[output * 3], tri, sizeof(uint32_t) * 3);
+                emitted[best_triangle] = 1;
+
+                // 从三个顶点的邻接表中移除该三角形
+                for (int k = 0; k < 3; ++k) {
+                    uint32_t v = tri[k];
+                    uint32_t* list = &adjacency[adjacency_offset[v]];
+                    uint32_t count = remaining[v];
+                    for (uint32_t j = 0; j < count; ++j) {
+                        if (list[j] == best_triangle) {
+                            list[j] = list[count - 1];
+                            remaining[v]--;
+                            break;
+                        }
+                    }
+                }
+
+                // 新缓存：刚输出的顶点放在最前，其余旧条目依次后移
+                size_t new_count = 0;
+                for (int k = 0; k < 3; ++k) {
+                    uint32_t v = tri[k];
+                    if (std::find(new_cache, new_cache + new_count, v) == new_cache + new_count) {
+                        new_cache[new_count++] = v;
+                    }
+                }
+                for (size_t i = 0; i < cache_count; ++i) {
+                    uint32_t v = cache[i];
+                    if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                        new_cache[new_count++] = v;
+                    }
+                }
+
+                // 只有新缓存中的顶点（包括刚被挤出的）分数会变化，把差值累加到它们的剩余三角形上
+                for (size_t i = 0; i < new_count; ++i) {
+                    uint32_t v = new_cache[i];
+                    int position = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+                    cache_position[v] = position;
+
+                    float score = tables.Score(position, remaining[v]);
+                    float delta = score - vertex_score[v];
+                    vertex_score[v] = score;
+
+                    const uint32_t* list = &adjacency[adjacency_offset[v]];
+                    for (uint32_t j = 0; j < remaining[v]; ++j) {
+                        triangle_score[list[j]] += delta;
+                    }
+                }
+
+                cache_count = std::min<size_t>(new_count, FORSYTH_CACHE_SIZE);
+                std::memcpy(cache, new_cache, cache_count * sizeof(uint32_t));
+
+                // 下一个三角形只在缓存顶点的邻接三角形中挑选
+                best_triangle = INVALID_TRIANGLE;
+                best_score = -1.0f;
+                for (size_t i = 0; i < cache_count; ++i) {
+                    uint32_t v = cache[i];
+                    const uint32_t* list = &adjacency[adjacency_offset[v]];
+                    for (uint32_t j = 0; j < remaining[v]; ++j) {
+                        uint32_t t = list[j];
+                        if (triangle_score[t] > best_score) {
+                            best_score = triangle_score[t];
+                            best_triangle = t;
+                        }
+                    }
+                }
+            }
+
+            std::memcpy(indices, optimized_indices.data(), optimized_indices.size() * sizeof(uint32_t));
+        }
+
+// =========================================================================
+// 过度绘制与顶点读取优化
+// =========================================================================
+
+        void OptimizeOverdraw(uint32_t* indices, size_t index_count,
+                              const uint8_t* positions, size_t position_stride, uint32_t vertex_count,
+                              float threshold) {
+            const size_t triangle_count = index_count / 3;
+            if (triangle_count < 2 || vertex_count == 0 || positions == nullptr ||
+                !IndicesInRange(indices, triangle_count * 3, vertex_count)) {
+                return;
+            }
+
+            const uint32_t cache_size = VERTEX_CACHE_SIMULATE_SIZE;
+            std::vector<uint32_t> timestamps(vertex_count, 0);
+
+            // 硬边界：三个顶点都未命中说明缓存优化在这里开始了新的区域
+            std::vector<uint32_t> hard_boundaries;
+            uint32_t time = cache_size + 1;
+            for (size_t t = 0; t < triangle_count; ++t) {
+                uint32_t misses = UpdateFifoCache(indices + t * 3, cache_size, timestamps.data(), time);
+                if (t == 0 || misses == 3) {
+                    hard_boundaries.push_back(static_cast<uint32_t>(t));
+                }
+            }
+
+            // 软边界：在每个硬簇内部，累计ACMR一旦回到预算以内就切出一个新簇
+            std::vector<uint32_t> boundaries;
+            std::fill(timestamps.begin(), timestamps.end(), 0);
+            time = 0;
+            for (size_t h = 0; h < hard_boundaries.size(); ++h) {
+                const uint32_t begin = hard_boundaries[h];
+                const uint32_t end = h + 1 < hard_boundaries.size()
+                                     ? hard_boundaries[h + 1]
+                                     : static_cast<uint32_t>(triangle_count);
+
+                // 每个簇都从空缓存开始
+                time += cache_size + 1;
+                uint32_t cluster_misses = 0;
+                for (uint32_t t = begin; t < end; ++t) {
+                    cluster_misses += UpdateFifoCache(indices + t * 3, cache_size, timestamps.data(), time);
+                }
+                const float cluster_budget = threshold * static_cast<float>(cluster_misses) / static_cast<float>(end - begin);
+
+                boundaries.push_back(begin);
+                time += cache_size + 1;
+                uint32_t running_misses = 0;
+                uint32_t running_triangles = 0;
+                for (uint32_t t = begin; t < end; ++t) {
+                    running_misses += UpdateFifoCache(indices + t * 3, cache_size, timestamps.data(), time);
+                    running_triangles++;
+                    if (static_cast<float>(running_misses) <= cluster_budget * static_cast<float>(running_triangles)) {
+                        boundaries.push_back(t + 1);
+                        time += cache_size + 1;
+                        running_misses = 0;
+                        running_triangles = 0;
+                    }
+                }
+
+                // 最后一个簇通常只剩零星几个三角形，ACMR很差，合并到前一个簇里
+                if (boundaries.back() != begin) {
+                    boundaries.pop_back();
+                }
+            }
+
+            // 网格中心（按索引平均）
+            glm::dvec3 mesh_center(0.0);
+            for (size_t i = 0; i < triangle_count * 3; ++i) {
+                mesh_center += glm::dvec3(LoadPosition(positions, position_stride, indices[i]));
+            }
+            const glm::vec3 center(mesh_center / static_cast<double>(triangle_count * 3));
+
+            // 每个簇按面积加权的中心和平均法线，越朝外的簇越先绘制
+            std::vector<TriangleCluster> clusters(boundaries.size());
+            for (size_t c = 0; c < boundaries.size(); ++c) {
+                TriangleCluster& cluster = clusters[c];
+                cluster.begin = boundaries[c];
+                cluster.end = c + 1 < boundaries.size() ? boundaries[c + 1] : static_cast<uint32_t>(triangle_count);
+
+                glm::vec3 centroid(0.0f);
+                glm::vec3 normal(0.0f);
+                float area_sum = 0.0f;
+                for (uint32_t t = cluster.begin; t < cluster.end; ++t) {
+                    glm::vec3 p0 = LoadPosition(positions, position_stride, indices[t * 3 + 0]);
+                    glm::vec3 p1 = LoadPosition(positions, position_stride, indices[t * 3 + 1]);
+                    glm::vec3 p2 = LoadPosition(positions, position_stride, indices[t * 3 + 2]);
+
+                    glm::vec3 face_normal = glm::cross(p1 - p0, p2 - p0);
+                    float area = glm::length(face_normal);
+                    centroid += (p0 + p1 + p2) * (area / 3.0f);
+                    normal += face_normal;
+                    area_sum += area;
+                }
+
+                float normal_length = glm::length(normal);
+                if (area_sum > 0.0f && normal_length > 0.0f) {
+                    cluster.sort_key = glm::dot(centroid / area_sum - center, normal / normal_length);
+                }
+            }
+
+            std::stable_sort(clusters.begin(), clusters.end(), [](const TriangleCluster& a, const TriangleCluster& b) {
+                return a.sort_key > b.sort_key;
+            });
+
+            std::vector<uint32_t> reordered;
+            reordered.reserve(triangle_count * 3);
+            for (const auto& cluster : clusters) {
+                reordered.insert(reordered.end(), indices + cluster.begin * 3, indices + cluster.end * 3);
+            }
+            std::memcpy(indices, reordered.data(), reordered.size() * sizeof(uint32_t));
+        }
+
+        uint32_t OptimizeVertexFetch(std::vector<uint8_t>& vertex_buffer, uint32_t stride, uint32_t vertex_count,
+                                     uint32_t* indices, size_t index_count) {
+            if (vertex_count == 0 || stride == 0 ||
+                vertex_buffer.size() < static_cast<size_t>(vertex_count) * stride ||
+                !IndicesInRange(indices, index_count, vertex_count)) {
+                return vertex_count;
+            }
+
+            // 按首次使用顺序分配新序号
+            std::vector<uint32_t> remap(vertex_count, UINT32_MAX);
+            uint32_t next_vertex = 0;
+            for (size_t i = 0; i < index_count; ++i) {
+                uint32_t& target = remap[indices[i]];
+                if (target == UINT32_MAX) {
+                    target = next_vertex++;
+                }
+                indices[i] = target;
+            }
+
+            std::vector<uint8_t> reordered(static_cast<size_t>(next_vertex) * stride);
+            for (uint32_t v = 0; v < vertex_count; ++v) {
+                if (remap[v] != UINT32_MAX) {
+                    std::memcpy(&reordered[static_cast<size_t>(remap[v]) * stride],
+                                &vertex_buffer[static_cast<size_t>(v) * stride], stride);
+                }
+            }
+
+            vertex_buffer.swap(reordered);
+            return next_vertex;
+        }
+
+        OverdrawStats AnalyzeOverdraw(const uint32_t* indices, size_t index_count,
+                                      const uint8_t* positions, size_t position_stride, uint32_t vertex_count) {
+            OverdrawStats stats;
+            const size_t triangle_count = index_count / 3;
+            if (triangle_count == 0 || vertex_count == 0 || positions == nullptr ||
+                !IndicesInRange(indices, triangle_count * 3, vertex_count)) {
+                return stats;
+            }
+
+            // 把包围盒等比缩放到光栅网格
+            glm::vec3 bounds_min(std::numeric_limits<float>::max());
+            glm::vec3 bounds_max(-std::numeric_limits<float>::max());
+            for (uint32_t v = 0; v < vertex_count; ++v) {
+                glm::vec3 position = LoadPosition(positions, position_stride, v);
+                bounds_min = glm::min(bounds_min, position);
+                bounds_max = glm::max(bounds_max, position);
+            }
+
+            glm::vec3 extent = bounds_max - bounds_min;
+            float max_extent = std::max({extent.x, extent.y, extent.z});
+            if (max_extent <= 0.0f) {
+                return stats;
+            }
+            float scale = static_cast<float>(OVERDRAW_GRID_SIZE - 1) / max_extent;
+
+            std::vector<glm::vec3> grid_positions(vertex_count);
+            for (uint32_t v = 0; v < vertex_count; ++v) {
+                grid_positions[v] = (LoadPosition(positions, position_stride, v) - bounds_min) * scale;
+            }
+
+            std::vector<float> depth_buffer(static_cast<size_t>(OVERDRAW_GRID_SIZE) * OVERDRAW_GRID_SIZE);
+            for (int axis = 0; axis < 3; ++axis) {
+                RasterizeOverdrawView(grid_positions, indices, triangle_count, axis, 1.0f, depth_buffer, stats);
+                RasterizeOverdrawView(grid_positions, indices, triangle_count, axis, -1.0f, depth_buffer, stats);
+            }
+
+            stats.overdraw = stats.pixels_covered > 0
+                             ? static_cast<float>(stats.pixels_shaded) / static_cast<float>(stats.pixels_covered)
+                             : 0.0f;
+            return stats;
+        }
+
+        VertexFetchStats AnalyzeVertexFetch(const uint32_t* indices, size_t index_count,
+                                            uint32_t vertex_count, uint32_t stride) {
+            VertexFetchStats stats;
+            if (index_count == 0 || vertex_count == 0 || stride == 0) {
+                return stats;
+            }
+
+            const uint32_t cache_size = VERTEX_CACHE_SIMULATE_SIZE;
+            std::vector<uint32_t> vertex_timestamps(vertex_count, 0);
+            uint32_t vertex_time = cache_size + 1;
+
+            const size_t line_count = (static_cast<size_t>(vertex_count) * stride + FETCH_CACHE_LINE_SIZE - 1) /
+                                      FETCH_CACHE_LINE_SIZE;
+            std::vector<uint32_t> line_timestamps(line_count, 0);
+            uint32_t line_time = FETCH_CACHE_LINE_COUNT + 1;
+
+            uint32_t unique_vertices = 0;
+            for (size_t i = 0; i < index_count; ++i) {
+                uint32_t v = indices[i];
+                if (v >= vertex_count) {
+                    continue;
+                }
+                if (vertex_timestamps[v] == 0) {
+                    unique_vertices++;
+                }
+                // 后变换缓存命中的顶点不需要读取
+                if (vertex_time - vertex_timestamps[v] <= cache_size) {
+                    continue;
+                }
+                vertex_timestamps[v] = vertex_time++;
+
+                size_t first_line = static_cast<size_t>(v) * stride / FETCH_CACHE_LINE_SIZE;
+                size_t last_line = (static_cast<size_t>(v) * stride + stride - 1) / FETCH_CACHE_LINE_SIZE;
+                for (size_t line = first_line; line <= last_line; ++line) {
+                    if (line_time - line_timestamps[line] > FETCH_CACHE_LINE_COUNT) {
+                        line_timestamps[line] = line_time++;
+                        stats.bytes_fetched += FETCH_CACHE_LINE_SIZE;
+                    }
+                }
+            }
+
+            if (unique_vertices > 0) {
+                stats.overfetch = static_cast<float>(stats.bytes_fetched) /
+                                  static_cast<float>(static_cast<uint64_t>(unique_vertices) * stride);
+            }
+            return stats;
+        }
+
+        VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t index_count, uint32_t vertex_count,
+                                            uint32_t cache_size) {
+            VertexCacheStats stats;
+            const size_t triangle_count = index_count / 3;
+            if (triangle_count == 0 || vertex_count == 0 || cache_size == 0) {
+                return stats;
+            }
+
+            // 时间戳模拟FIFO：顶点进入缓存的时间距今超过cache_size即已被挤出
+            std::vector<uint32_t> timestamps(vertex_count, 0);
+            uint32_t time = cache_size + 1;
+
+            for (size_t i = 0; i < triangle_count * 3; ++i) {
+                uint32_t v = indices[i];
+                if (v >= vertex_count) {
+                    continue;
+                }
+                if (timestamps[v] == 0) {
+                    stats.unique_vertices++;
+                }
+                if (time - timestamps[v] > cache_size) {
+                    timestamps[v] = time++;
+                    stats.transforms++;
+                }
+            }
+
+            stats.triangle_count = static_cast<uint32_t>(triangle_count);
+            stats.acmr = static_cast<float>(stats.transforms) / static_cast<float>(triangle_count);
+            stats.atvr = stats.unique_vertices > 0
+                         ? static_cast<float>(stats.transforms) / static_cast<float>(stats.unique_vertices)
+                         : 0.0f;
+            return stats;
+        }
+
+// =========================================================================
+// 顶点属性量化
+// =========================================================================
+
+        int16_t QuantizeSnorm16(float value) {
+            float clamped = std::max(-1.0f, std::min(1.0f, value));
+            return static_cast<int16_t>(std::lround(clamped * 32767.0f));
+        }
+
+        int8_t QuantizeSnorm8(float value) {
+            float clamped = std::max(-1.0f, std::min(1.0f, value));
+            return static_cast<int8_t>(std::lround(clamped * 127.0f));
+        }
+
+        uint8_t QuantizeUnorm8(float value) {
+            float clamped = std::max(0.0f, std::min(1.0f, value));
+            return static_cast<uint8_t>(std::lround(clamped * 255.0f));
+        }
+
+        // 与GLES 3.0的snorm转换规则一致：-32768和-32767都映射到-1
+        float DequantizeSnorm16(int16_t value) {
+            return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+        }
+
+        float DequantizeSnorm8(int8_t value) {
+            return std::max(static_cast<float>(value) / 127.0f, -1.0f);
+        }
+
+        uint16_t FloatToHalf(float value) {
+            return glm::packHalf1x16(value);
+        }
+
+        float HalfToFloat(uint16_t value) {
+            return glm::unpackHalf1x16(value);
+        }
+
+        glm::vec2 EncodeOctahedral(const glm::vec3& normal) {
+            float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+            if (sum <= 0.0f) {
+                return glm::vec2(0.0f);
+            }
+
+            glm::vec2 encoded(normal.x / sum, normal.y / sum);
+            // 下半球折叠到外侧三角形
+            if (normal.z < 0.0f) {
+                glm::vec2 folded(1.0f - std::abs(encoded.y), 1.0f - std::abs(encoded.x));
+                encoded.x = encoded.x >= 0.0f ? folded.x : -folded.x;
+                encoded.y = encoded.y >= 0.0f ? folded.y : -folded.y;
+            }
+            return encoded;
+        }
+
+        glm::vec3 DecodeOctahedral(const glm::vec2& encoded) {
+            glm::vec3 normal(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+            float t = std::max(-normal.z, 0.0f);
+            normal.x += normal.x >= 0.0f ? -t : t;
+            normal.y += normal.y >= 0.0f ? -t : t;
+            return glm::normalize(normal);
+        }
+
+        void QuantizeWeights(const glm::vec4& weights, uint8_t out[4]) {
+            int sum = 0;
+            int largest = 0;
+            for (int i = 0; i < 4; ++i) {
+                out[i] = QuantizeUnorm8(weights[i]);
+                sum += out[i];
+                if (weights[i] > weights[largest]) {
+                    largest = i;
+                }
+            }
+
+            // 全零权重（无效数据）保持原样
+            if (sum == 0) {
+                return;
+            }
+            int corrected = static_cast<int>(out[largest]) + (255 - sum);
+            out[largest] = static_cast<uint8_t>(std::max(0, std::min(255, corrected)));
+        }
+
+// =========================================================================
+// 顶点去重
+// =========================================================================
+
+        uint64_t HashBytes64(const uint8_t* data, size_t size) {
+            constexpr uint64_t MUL = 0x9E3779B97F4A7C15ull;
+            uint64_t hash = 0xCBF29CE484222325ull ^ (size * MUL);
+
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, data + i, 8);
+                hash = (hash ^ word) * MUL;
+                hash ^= hash >> 32;
+            }
+            if (i < size) {
+                uint64_t word = 0;
+                std::memcpy(&word, data + i, size - i);
+                hash = (hash ^ word) * MUL;
+                hash ^= hash >> 32;
+            }
+
+            // 末尾再混合一次，保证低位也分布均匀（表索引只取低位）
+            hash ^= hash >> 29;
+            hash *= 0xBF58476D1CE4E5B9ull;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+        uint32_t GenerateVertexRemap(const uint8_t* vertices, uint32_t vertex_count, uint32_t stride,
+                                     uint32_t* remap) {
+            if (vertex_count == 0) {
+                return 0;
+            }
+
+            // 负载因子不超过0.5，线性探测
+            size_t capacity = 16;
+            while (capacity < static_cast<size_t>(vertex_count) * 2) {
+                capacity <<= 1;
+            }
+            const size_t mask = capacity - 1;
+
+            // 槽中保存代表顶点在输入中的位置
+            std::vector<uint32_t> slots(capacity, DEDUP_EMPTY_SLOT);
+            uint32_t unique_count = 0;
+
+            for (uint32_t i = 0; i < vertex_count; ++i) {
+                const uint8_t* vertex = vertices + static_cast<size_t>(i) * stride;
+                size_t slot = static_cast<size_t>(HashBytes64(vertex, stride)) & mask;
+
+                while (true) {
+                    uint32_t existing = slots[slot];
+                    if (existing == DEDUP_EMPTY_SLOT) {
+                        slots[slot] = i;
+                        remap[i] = unique_count++;
+                        break;
+                    }
+                    if (std::memcmp(vertices + static_cast<size_t>(existing) * stride, vertex, stride) == 0) {
+                        remap[i] = remap[existing];
+                        break;
+                    }
+                    slot = (slot + 1) & mask;
+                }
+            }
+
+            return unique_count;
+        }
+
+// =========================================================================
+// 基准测试
+// =========================================================================
+
+        void RunVertexCacheBenchmark() {
+            // 最后一档约50万三角形，用于确认耗时随三角形数线性增长
+            const uint32_t GRID_SIZES[] = {64, 224, 512};
+
+            std::cout << "=== 顶点缓存优化基准 (FIFO " << VERTEX_CACHE_SIMULATE_SIZE << ") ===" << std::endl;
+
+            for (uint32_t grid_size : GRID_SIZES) {
+                std::vector<uint32_t> indices = GenerateGridIndices(grid_size);
+                const uint32_t vertex_count = (grid_size + 1) * (grid_size + 1);
+                const size_t triangle_count = indices.size() / 3;
+
+                VertexCacheStats ordered = AnalyzeVertexCache(indices.data(), indices.size(), vertex_count);
+
+                // 打乱三角形顺序（固定种子，结果可复现）
+                std::vector<uint32_t> order(triangle_count);
+                for (size_t t = 0; t < triangle_count; ++t) {
+                    order[t] = static_cast<uint32_t>(t);
+                }
+                std::shuffle(order.begin(), order.end(), std::mt19937(12345));
+
+                std::vector<uint32_t> shuffled(indices.size());
+                for (size_t t = 0; t < triangle_count; ++t) {
+                    std::memcpy(&shuffled[t * 3], &indices[order[t] * 3], sizeof(uint32_t) * 3);
+                }
+
+                VertexCacheStats before = AnalyzeVertexCache(shuffled.data(), shuffled.size(), vertex_count);
+
+                auto start = std::chrono::high_resolution_clock::now();
+                OptimizeVertexCacheForsyth(shuffled.data(), shuffled.size(), vertex_count);
+                double elapsed_ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::high_resolution_clock::now() - start).count();
+
+                VertexCacheStats after = AnalyzeVertexCache(shuffled.data(), shuffled.size(), vertex_count);
+
+                std::cout << "网格 " << grid_size << "x" << grid_size << ", 三角形 " << triangle_count
+                          << ", 优化耗时 " << std::fixed << std::setprecision(2) << elapsed_ms << " ms ("
+                          << std::setprecision(3) << elapsed_ms * 1000.0 / static_cast<double>(triangle_count)
+                          << " us/三角形)" << std::defaultfloat << std::endl;
+                PrintCacheStats("按行顺序", ordered);
+                PrintCacheStats("打乱后", before);
+                PrintCacheStats("优化后", after);
+            }
+        }
+
+        void RunVertexDedupBenchmark() {
+            // 最后一档约300万个未焊接顶点
+            const uint32_t GRID_SIZES[] = {128, 512, 724};
+            constexpr uint32_t STRIDE = 32;
+
+            std::cout << "=== 顶点去重基准 (步长 " << STRIDE << " 字节) ===" << std::endl;
+
+            for (uint32_t grid_size : GRID_SIZES) {
+                uint32_t vertex_count = 0;
+                std::vector<uint8_t> vertices = GenerateUnweldedGrid(grid_size, &vertex_count);
+
+                // 旧实现：节点式unordered_map，逐字节FNV-1a
+                auto start = std::chrono::high_resolution_clock::now();
+                auto fnv_hash = [&](uint32_t index) {
+                    const uint8_t* bytes = vertices.data() + static_cast<size_t>(index) * STRIDE;
+                    size_t hash = 0;
+                    for (uint32_t b = 0; b < STRIDE; ++b) {
+                        hash ^= bytes[b];
+                        hash *= 0x100000001b3;
+                    }
+                    return hash;
+                };
+                auto bytes_equal = [&](uint32_t a, uint32_t b) {
+                    return std::memcmp(vertices.data() + static_cast<size_t>(a) * STRIDE,
+                                       vertices.data() + static_cast<size_t>(b) * STRIDE, STRIDE) == 0;
+                };
+                std::unordered_map<uint32_t, uint32_t, decltype(fnv_hash), decltype(bytes_equal)>
+                        node_map(vertex_count, fnv_hash, bytes_equal);
+                uint32_t node_unique = 0;
+                for (uint32_t i = 0; i < vertex_count; ++i) {
+                    if (node_map.emplace(i, node_unique).second) {
+                        node_unique++;
+                    }
+                }
+                double node_ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::high_resolution_clock::now() - start).count();
+
+                start = std::chrono::high_resolution_clock::now();
+                std::vector<uint32_t> remap(vertex_count);
+                uint32_t unique = GenerateVertexRemap(vertices.data(), vertex_count, STRIDE, remap.data());
+                double open_ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::high_resolution_clock::now() - start).count();
+
+                std::cout << "网格 " << grid_size << "x" << grid_size << ", 顶点 " << vertex_count
+                          << " -> " << unique << (unique == node_unique ? "" : " (结果不一致!)") << std::endl;
+                std::cout << std::fixed << std::setprecision(2)
+                          << "  unordered_map:  " << node_ms << " ms" << std::endl
+                          << "  开放寻址:       " << open_ms << " ms (x"
+                          << (open_ms > 0.0 ? node_ms / open_ms : 0.0) << ")" << std::defaultfloat << std::endl;
+            }
+        }
+
+    } // namespace asset
+} // namespace spartan
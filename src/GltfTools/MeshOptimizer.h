@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace spartan {
+    namespace asset {
+
+// 后变换顶点缓存统计
+        struct VertexCacheStats {
+            uint32_t triangle_count = 0;
+            uint32_t unique_vertices = 0;  // 被索引引用到的顶点数
+            uint32_t transforms = 0;       // 缓存未命中，即顶点着色器执行次数
+            float acmr = 0.0f;             // 平均每三角形未命中数，最差3.0，规则网格理想值约0.5
+            float atvr = 0.0f;             // 未命中数/唯一顶点数，理想值1.0
+        };
+
+// 统计时模拟的FIFO缓存大小（移动GPU常见值）
+        constexpr uint32_t VERTEX_CACHE_SIMULATE_SIZE = 16;
+
+// 过度绘制统计（软件光栅化，从六个轴向正交观察取平均）
+        struct OverdrawStats {
+            uint32_t pixels_covered = 0;  // 至少被写入一次的像素
+            uint32_t pixels_shaded = 0;   // 通过深度测试的片元总数
+            float overdraw = 0.0f;        // shaded/covered，理想值1.0
+        };
+
+// 顶点读取统计（后变换缓存未命中时才读取顶点，按缓存行计量带宽）
+        struct VertexFetchStats {
+            uint64_t bytes_fetched = 0;
+            float overfetch = 0.0f;       // 读取字节数/被引用顶点的总字节数，理想值1.0
+        };
+
+        /**
+         * 线性时间的Forsyth顶点缓存优化，原地重排三角形顺序
+         * 顶点->三角形邻接表只构建一次，每输出一个三角形只增量更新缓存内顶点的分数，
+         * 下一个三角形从缓存顶点的邻接三角形中挑选，找不到时按游标顺序扫描。
+         * @param indices 三角形列表索引
+         * @param index_count 索引数量（3的倍数，多余的部分保持不动）
+         * @param vertex_count 顶点数量，索引越界时不做任何修改
+         */
+        void OptimizeVertexCacheForsyth(uint32_t* indices, size_t index_count, uint32_t vertex_count);
+
+        /**
+         * 用FIFO缓存模拟后变换缓存，计算ACMR/ATVR
+         * @param cache_size 模拟的缓存大小
+         */
+        VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t index_count, uint32_t vertex_count,
+                                            uint32_t cache_size = VERTEX_CACHE_SIMULATE_SIZE);
+
+        /**
+         * 过度绘制优化：把已做过缓存优化的三角形序列切成簇，按簇朝外的程度从外到内排序
+         * 簇边界处ACMR会变差，threshold限制每个簇的ACMR不超过原序列的threshold倍
+         * @param positions 第一个顶点的位置（float3）
+         * @param position_stride 相邻顶点位置之间的字节距离
+         * @param threshold ACMR预算，1.05表示允许变差5%
+         */
+        void OptimizeOverdraw(uint32_t* indices, size_t index_count,
+                              const uint8_t* positions, size_t position_stride, uint32_t vertex_count,
+                              float threshold);
+
+        /**
+         * 顶点读取优化：按索引中首次使用的顺序重排顶点，并改写索引
+         * 未被引用的顶点会被丢弃
+         * @param vertex_buffer 交错顶点数据，原地重排
+         * @param stride 顶点步长
+         * @return 重排后的顶点数量
+         */
+        uint32_t OptimizeVertexFetch(std::vector<uint8_t>& vertex_buffer, uint32_t stride, uint32_t vertex_count,
+                                     uint32_t* indices, size_t index_count);
+
+        /**
+         * 用软件光栅化估算过度绘制（绘制顺序即索引顺序，开启背面剔除）
+         */
+        OverdrawStats AnalyzeOverdraw(const uint32_t* indices, size_t index_count,
+                                      const uint8_t* positions, size_t position_stride, uint32_t vertex_count);
+
+        /**
+         * 估算顶点读取带宽：后变换缓存未命中的顶点按64字节缓存行读取
+         */
+        VertexFetchStats AnalyzeVertexFetch(const uint32_t* indices, size_t index_count,
+                                            uint32_t vertex_count, uint32_t stride);
+
+// =========================================================================
+// 顶点属性量化
+// =========================================================================
+
+        int16_t QuantizeSnorm16(float value);
+        int8_t QuantizeSnorm8(float value);
+        uint8_t QuantizeUnorm8(float value);
+        float DequantizeSnorm16(int16_t value);
+        float DequantizeSnorm8(int8_t value);
+
+        uint16_t FloatToHalf(float value);
+        float HalfToFloat(uint16_t value);
+
+        /**
+         * 八面体编码：把单位向量映射到[-1,1]^2，解码见DecodeOctahedral和顶点着色器octDecode
+         */
+        glm::vec2 EncodeOctahedral(const glm::vec3& normal);
+        glm::vec3 DecodeOctahedral(const glm::vec2& encoded);
+
+        /**
+         * 把权重量化为unorm8，并把舍入误差补到最大的权重上，保证四个权重之和仍为1
+         */
+        void QuantizeWeights(const glm::vec4& weights, uint8_t out[4]);
+
+// =========================================================================
+// 顶点去重
+// =========================================================================
+
+        /**
+         * 64位哈希，按8字节分块读取原始字节
+         */
+        uint64_t HashBytes64(const uint8_t* data, size_t size);
+
+        /**
+         * 按原始字节去重顶点（开放寻址哈希表，容量按顶点数一次性分配）
+         * 唯一顶点按首次出现的顺序编号
+         * @param vertices 交错顶点数据
+         * @param remap 输出，长度vertex_count，remap[i]为顶点i去重后的编号
+         * @return 唯一顶点数量
+         */
+        uint32_t GenerateVertexRemap(const uint8_t* vertices, uint32_t vertex_count, uint32_t stride,
+                                     uint32_t* remap);
+
+        /**
+         * 顶点缓存优化基准：生成规则网格并打乱三角形顺序，
+         * 输出不同规模下的优化耗时以及优化前后的ACMR/ATVR
+         */
+        void RunVertexCacheBenchmark();
+
+        /**
+         * 顶点去重基准：生成未焊接的大型网格，对比节点式unordered_map和GenerateVertexRemap的耗时
+         */
+        void RunVertexDedupBenchmark();
+
+    } // namespace asset
+} // namespace spartan
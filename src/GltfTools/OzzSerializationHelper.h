@@ -15,7 +15,7 @@ namespace spartan {
         public:
             OzzMemoryBuffer() : position_(0) {}
 
-            // 从已有数据构造（用于反序列化）
+            // 从已有数据构造（复制数据；只读时用OzzSpanStream直接引用）
             explicit OzzMemoryBuffer(const uint8_t* data, size_t size)
                     : buffer_(data, data + size), position_(0) {}
 
@@ -38,7 +38,9 @@ namespace spartan {
                 if (new_size > buffer_.size()) {
                     buffer_.resize(new_size);
                 }
-                std::memcpy(buffer_.data() + position_, buffer, size);
+                if (size > 0) {
+                    std::memcpy(buffer_.data() + position_, buffer, size);
+                }
                 position_ += size;
                 return size;
             }
@@ -82,6 +84,126 @@ namespace spartan {
             size_t position_;
         };
 
+// 辅助类：把OZZ对象直接追加到已有的缓冲区末尾（只写），避免先写临时缓冲再复制
+        class OzzAppendStream : public ozz::io::Stream {
+        public:
+            explicit OzzAppendStream(std::vector<uint8_t>& target)
+                    : target_(target), begin_(target.size()), position_(target.size()) {}
+
+            bool opened() const override { return true; }
+
+            size_t Read(void*, size_t) override { return 0; }
+
+            size_t Write(const void* buffer, size_t size) override {
+                if (position_ + size > target_.size()) {
+                    target_.resize(position_ + size);
+                }
+                if (size > 0) {
+                    std::memcpy(target_.data() + position_, buffer, size);
+                }
+                position_ += size;
+                return size;
+            }
+
+            // 偏移相对于流的起始位置（构造时缓冲区的末尾）
+            int Seek(int offset, Origin origin) override {
+                size_t new_pos = position_;
+                switch (origin) {
+                    case kSet:
+                        new_pos = begin_ + offset;
+                        break;
+                    case kCurrent:
+                        new_pos = position_ + offset;
+                        break;
+                    case kEnd:
+                        new_pos = target_.size() + offset;
+                        break;
+                }
+
+                if (new_pos < begin_ || new_pos > target_.size()) {
+                    return -1;
+                }
+
+                position_ = new_pos;
+                return 0;
+            }
+
+            int Tell() const override {
+                return static_cast<int>(position_ - begin_);
+            }
+
+            size_t Size() const override {
+                return target_.size() - begin_;
+            }
+
+        private:
+            std::vector<uint8_t>& target_;
+            size_t begin_;
+            size_t position_;
+        };
+
+// 辅助类：只读地引用一段外部内存（如映射的文件），反序列化时不复制数据
+        class OzzSpanStream : public ozz::io::Stream {
+        public:
+            OzzSpanStream(const uint8_t* data, size_t size)
+                    : data_(data), size_(size), position_(0), overrun_(false) {}
+
+            bool opened() const override { return data_ != nullptr || size_ == 0; }
+
+            size_t Read(void* buffer, size_t size) override {
+                if (size > size_ - position_) {
+                    size = size_ - position_;
+                    overrun_ = true;
+                }
+                if (size > 0) {
+                    std::memcpy(buffer, data_ + position_, size);
+                    position_ += size;
+                }
+                return size;
+            }
+
+            size_t Write(const void*, size_t) override { return 0; }
+
+            int Seek(int offset, Origin origin) override {
+                size_t new_pos = position_;
+                switch (origin) {
+                    case kSet:
+                        new_pos = offset;
+                        break;
+                    case kCurrent:
+                        new_pos = position_ + offset;
+                        break;
+                    case kEnd:
+                        new_pos = size_ + offset;
+                        break;
+                }
+
+                if (new_pos > size_) {
+                    return -1;
+                }
+
+                position_ = new_pos;
+                return 0;
+            }
+
+            int Tell() const override {
+                return static_cast<int>(position_);
+            }
+
+            size_t Size() const override {
+                return size_;
+            }
+
+            // 是否出现过超出范围的读取（数据被截断或损坏）
+            bool Overrun() const { return overrun_; }
+
+        private:
+            const uint8_t* data_;
+            size_t size_;
+            size_t position_;
+            bool overrun_;
+        };
+
 // 辅助函数：序列化OZZ对象到缓冲区
         template<typename T>
         inline std::vector<uint8_t> SerializeOzzObject(const T& object) {
@@ -91,13 +213,22 @@ namespace spartan {
             return std::move(buffer.GetBuffer());
         }
 
-// 辅助函数：从缓冲区反序列化OZZ对象
+// 辅助函数：把OZZ对象追加到缓冲区末尾，返回写入的字节数
+        template<typename T>
+        inline size_t AppendOzzObject(const T& object, std::vector<uint8_t>& buffer) {
+            OzzAppendStream stream(buffer);
+            ozz::io::OArchive archive(&stream);
+            archive << object;
+            return stream.Size();
+        }
+
+// 辅助函数：直接从缓冲区反序列化OZZ对象，数据被截断时返回false
         template<typename T>
         inline bool DeserializeOzzObject(const uint8_t* data, size_t size, T& object) {
-            OzzMemoryBuffer buffer(data, size);
-            ozz::io::IArchive archive(&buffer);
+            OzzSpanStream stream(data, size);
+            ozz::io::IArchive archive(&stream);
             archive >> object;
-            return true;
+            return !stream.Overrun();
         }
 
     } // namespace asset
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace spartan {
+    namespace asset {
+
+        /**
+         * 把[0, count)分给thread_count个线程执行（0 = 硬件线程数），调用线程也参与；
+         * 任务按索引动态领取，每个任务只应写自己的槽位，结果与执行顺序无关
+         */
+        inline void ParallelFor(size_t count, uint32_t thread_count, const std::function<void(size_t)>& job) {
+            if (thread_count == 0) {
+                thread_count = std::max(1u, std::thread::hardware_concurrency());
+            }
+            thread_count = static_cast<uint32_t>(std::min<size_t>(thread_count, count));
+
+            if (thread_count <= 1) {
+                for (size_t i = 0; i < count; ++i) {
+                    job(i);
+                }
+                return;
+            }
+
+            std::atomic<size_t> next{0};
+            auto worker = [&]() {
+                for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                    job(i);
+                }
+            };
+
+            std::vector<std::thread> workers;
+            workers.reserve(thread_count - 1);
+            for (uint32_t t = 1; t < thread_count; ++t) {
+                workers.emplace_back(worker);
+            }
+            worker();
+            for (auto& thread : workers) {
+                thread.join();
+            }
+        }
+
+    } // namespace asset
+} // namespace spartan
@@ -0,0 +1,119 @@
+#include "SlotMap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace spartan {
+    namespace asset {
+
+        namespace {
+            // 与MeshData热字段大小相近的负载，查找后读取其中一个字段，避免查找被优化掉
+            struct BenchPayload {
+                uint32_t index_count = 0;
+                uint32_t vertex_offset = 0;
+                float bounds[6] = {};
+            };
+
+            double MeasureNs(size_t operations, const std::function<uint64_t()>& run, uint64_t& checksum) {
+                const int iterations = 20;
+                checksum = run();
+                auto start = std::chrono::high_resolution_clock::now();
+                for (int i = 0; i < iterations; ++i) checksum += run();
+                const double seconds = std::chrono::duration<double>(
+                        std::chrono::high_resolution_clock::now() - start).count() / iterations;
+                return seconds * 1e9 / static_cast<double>(operations);
+            }
+        }
+
+        void RunSlotMapBenchmark() {
+            std::cout << "=== 句柄查找基准 (unordered_map vs SlotMap) ===" << std::endl;
+            std::cout << "  单位：ns/次" << std::endl;
+
+            for (size_t count : {size_t(64), size_t(1024), size_t(16384), size_t(262144)}) {
+                std::mt19937 rng(11);
+                std::unordered_map<MeshHandle, BenchPayload, HandleHash<MeshTag>> hash_map;
+                SlotMap<MeshTag, BenchPayload> slot_map;
+                std::vector<MeshHandle> handles;
+                handles.reserve(count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    const MeshHandle handle(i + 1, 1 + (rng() & 3));
+                    BenchPayload payload;
+                    payload.index_count = i * 3;
+                    hash_map.emplace(handle, payload);
+                    slot_map.emplace(handle, payload);
+                    handles.push_back(handle);
+                }
+
+                // 每帧提交的绘制顺序与id无关：按打乱后的顺序查找
+                std::vector<MeshHandle> lookups;
+                lookups.reserve(1 << 20);
+                while (lookups.size() < (1 << 20)) {
+                    lookups.insert(lookups.end(), handles.begin(), handles.end());
+                }
+                lookups.resize(1 << 20);
+                std::shuffle(lookups.begin(), lookups.end(), rng);
+
+                // 过期句柄：id有效但代际已变
+                std::vector<MeshHandle> stale(lookups.size());
+                std::transform(lookups.begin(), lookups.end(), stale.begin(), [](MeshHandle handle) {
+                    return MeshHandle(handle.id, handle.generation + 8);
+                });
+
+                uint64_t hash_sum = 0, slot_sum = 0, unused = 0;
+                const double hash_hit = MeasureNs(lookups.size(), [&]() {
+                    uint64_t sum = 0;
+                    for (MeshHandle handle : lookups) {
+                        auto it = hash_map.find(handle);
+                        if (it != hash_map.end()) sum += it->second.index_count;
+                    }
+                    return sum;
+                }, hash_sum);
+                const double slot_hit = MeasureNs(lookups.size(), [&]() {
+                    uint64_t sum = 0;
+                    for (MeshHandle handle : lookups) {
+                        if (const BenchPayload* payload = slot_map.get(handle)) sum += payload->index_count;
+                    }
+                    return sum;
+                }, slot_sum);
+
+                const double hash_miss = MeasureNs(stale.size(), [&]() {
+                    uint64_t misses = 0;
+                    for (MeshHandle handle : stale) misses += hash_map.find(handle) == hash_map.end();
+                    return misses;
+                }, unused);
+                const double slot_miss = MeasureNs(stale.size(), [&]() {
+                    uint64_t misses = 0;
+                    for (MeshHandle handle : stale) misses += slot_map.get(handle) == nullptr;
+                    return misses;
+                }, unused);
+
+                uint64_t hash_iterate_sum = 0, slot_iterate_sum = 0;
+                const double hash_iterate = MeasureNs(count, [&]() {
+                    uint64_t sum = 0;
+                    for (const auto& [handle, payload] : hash_map) sum += payload.index_count;
+                    return sum;
+                }, hash_iterate_sum);
+                const double slot_iterate = MeasureNs(count, [&]() {
+                    uint64_t sum = 0;
+                    for (const auto& [handle, payload] : slot_map) sum += payload.index_count;
+                    return sum;
+                }, slot_iterate_sum);
+
+                std::cout << std::fixed << std::setprecision(2)
+                          << "  " << std::setw(6) << count << " 项  命中 " << hash_hit << " -> " << slot_hit
+                          << "  过期 " << hash_miss << " -> " << slot_miss
+                          << "  遍历 " << hash_iterate << " -> " << slot_iterate
+                          << ((hash_sum == slot_sum && hash_iterate_sum == slot_iterate_sum) ? "" : "  [结果不一致]")
+                          << std::defaultfloat << std::endl;
+            }
+        }
+
+    } // namespace asset
+} // namespace spartan
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AssetTypes.h"
+
+namespace spartan {
+    namespace asset {
+
+        // 槽位表页表上限，超出的id视为无效句柄
+        constexpr uint32_t SLOT_MAP_MAX_ID = 1u << 24;
+
+        /**
+         * 能否作为SlotMap的键（id非0且不超过上限），反序列化时用来拒绝损坏的句柄
+         */
+        template<typename Tag>
+        inline bool IsSlotMapHandle(Handle<Tag> handle) {
+            return handle.id != 0 && handle.id <= SLOT_MAP_MAX_ID;
+        }
+
+        /**
+         * 句柄槽位表：Handle::id直接作为下标（id-1）访问分页的连续存储，查找时校验generation
+         * 接口与原先的std::unordered_map<Handle<Tag>, T, HandleHash<Tag>>保持一致（find/end/[]/emplace/erase/范围for），
+         * 元素为std::pair<const Handle<Tag>, T>，结构化绑定写法不变。
+         * 约定：
+         *  - 插入和删除都不移动其它元素（按页分配，页不重新分配），引用和指针与unordered_map一样保持有效；
+         *  - 同一id只保留一个代际，以新代际插入会析构旧元素，旧句柄随之失效；
+         *  - 遍历按id升序，跳过空槽位；id由句柄生成器连续分配，空洞不多。
+         */
+        template<typename Tag, typename T>
+        class SlotMap {
+        public:
+            using key_type = Handle<Tag>;
+            using mapped_type = T;
+            using value_type = std::pair<const Handle<Tag>, T>;
+            using size_type = size_t;
+
+            static constexpr uint32_t PAGE_SHIFT = 6;
+            static constexpr uint32_t PAGE_SIZE = 1u << PAGE_SHIFT;
+            static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1;
+            static constexpr uint32_t END_INDEX = 0xFFFFFFFFu;  // end()的下标，插入删除后不变
+
+        private:
+            // 占用标志放在页首，连续查找同一页时标志常驻同一缓存行
+            struct Page {
+                bool occupied[PAGE_SIZE] = {};
+                typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type values[PAGE_SIZE];
+
+                value_type* Get(uint32_t offset) { return std::launder(reinterpret_cast<value_type*>(&values[offset])); }
+            };
+
+            template<bool IsConst>
+            class Iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = typename SlotMap::value_type;
+                using difference_type = std::ptrdiff_t;
+                using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+                using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+                using MapPointer = std::conditional_t<IsConst, const SlotMap*, SlotMap*>;
+
+                Iterator() = default;
+                Iterator(MapPointer map, uint32_t index) : map_(map), index_(index) {}
+                // 非const迭代器可转换为const迭代器
+                template<bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+                Iterator(const Iterator<OtherConst>& other) : map_(other.map_), index_(other.index_) {}
+
+                reference operator*() const { return *map_->pages_[index_ >> PAGE_SHIFT]->Get(index_ & PAGE_MASK); }
+                pointer operator->() const { return &**this; }
+
+                Iterator& operator++() {
+                    index_ = map_->NextOccupied(index_ + 1);
+                    return *this;
+                }
+                Iterator operator++(int) {
+                    Iterator copy = *this;
+                    ++*this;
+                    return copy;
+                }
+
+                bool operator==(const Iterator& other) const { return index_ == other.index_; }
+                bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+
+            private:
+                friend class SlotMap;
+                template<bool> friend class Iterator;
+                MapPointer map_ = nullptr;
+                uint32_t index_ = 0;
+            };
+
+        public:
+            using iterator = Iterator<false>;
+            using const_iterator = Iterator<true>;
+
+            SlotMap() = default;
+            ~SlotMap() { clear(); }
+
+            SlotMap(SlotMap&& other) noexcept
+                    : pages_(std::move(other.pages_)), size_(other.size_), end_index_(other.end_index_) {
+                other.size_ = 0;
+                other.end_index_ = 0;
+            }
+
+            SlotMap& operator=(SlotMap&& other) noexcept {
+                if (this != &other) {
+                    clear();
+                    pages_ = std::move(other.pages_);
+                    size_ = other.size_;
+                    end_index_ = other.end_index_;
+                    other.size_ = 0;
+                    other.end_index_ = 0;
+                }
+                return *this;
+            }
+
+            SlotMap(const SlotMap& other) {
+                for (const auto& value : other) {
+                    emplace(value.first, value.second);
+                }
+            }
+
+            SlotMap& operator=(const SlotMap& other) {
+                if (this != &other) {
+                    clear();
+                    for (const auto& value : other) {
+                        emplace(value.first, value.second);
+                    }
+                }
+                return *this;
+            }
+
+            // ---- 查找 ----
+
+            iterator find(Handle<Tag> handle) {
+                return iterator(this, Locate(handle) ? handle.id - 1 : END_INDEX);
+            }
+
+            const_iterator find(Handle<Tag> handle) const {
+                return const_iterator(this, Locate(handle) ? handle.id - 1 : END_INDEX);
+            }
+
+            /**
+             * 直接返回元素指针，句柄无效或代际不符时返回nullptr（热路径上省去迭代器比较）
+             */
+            T* get(Handle<Tag> handle) {
+                value_type* value = Locate(handle);
+                return value ? &value->second : nullptr;
+            }
+
+            const T* get(Handle<Tag> handle) const {
+                return const_cast<SlotMap*>(this)->get(handle);
+            }
+
+            size_t count(Handle<Tag> handle) const { return Locate(handle) ? 1 : 0; }
+
+            T& at(Handle<Tag> handle) {
+                value_type* value = Locate(handle);
+                if (!value) {
+                    throw std::out_of_range("SlotMap::at: invalid handle");
+                }
+                return value->second;
+            }
+
+            const T& at(Handle<Tag> handle) const {
+                return const_cast<SlotMap*>(this)->at(handle);
+            }
+
+            // ---- 插入和删除 ----
+
+            T& operator[](Handle<Tag> handle) {
+                auto result = emplace(handle);
+                if (result.first == end()) {
+                    throw std::out_of_range("SlotMap::operator[]: invalid handle id");
+                }
+                return result.first->second;
+            }
+
+            template<typename... Args>
+            std::pair<iterator, bool> emplace(Handle<Tag> handle, Args&&... args) {
+                if (!IsSlotMapHandle(handle)) {
+                    return {end(), false};
+                }
+                const uint32_t index = handle.id - 1;
+                Page& page = EnsurePage(index >> PAGE_SHIFT);
+                const uint32_t offset = index & PAGE_MASK;
+                if (page.occupied[offset]) {
+                    if (page.Get(offset)->first.generation == handle.generation) {
+                        return {iterator(this, index), false};
+                    }
+                    Destroy(page, offset);
+                }
+
+                new (&page.values[offset]) value_type(std::piecewise_construct, std::forward_as_tuple(handle),
+                                                      std::forward_as_tuple(std::forward<Args>(args)...));
+                page.occupied[offset] = true;
+                ++size_;
+                if (index >= end_index_) {
+                    end_index_ = index + 1;
+                }
+                return {iterator(this, index), true};
+            }
+
+            size_t erase(Handle<Tag> handle) {
+                if (!Locate(handle)) {
+                    return 0;
+                }
+                const uint32_t index = handle.id - 1;
+                Destroy(*pages_[index >> PAGE_SHIFT], index & PAGE_MASK);
+                ShrinkEnd();
+                return 1;
+            }
+
+            iterator erase(const_iterator position) {
+                const uint32_t index = position.index_;
+                Destroy(*pages_[index >> PAGE_SHIFT], index & PAGE_MASK);
+                const uint32_t next = NextOccupied(index + 1);
+                ShrinkEnd();
+                return iterator(this, next);
+            }
+
+            void clear() {
+                for (uint32_t page_index = 0; page_index < pages_.size(); ++page_index) {
+                    Page* page = pages_[page_index].get();
+                    if (!page) continue;
+                    for (uint32_t offset = 0; offset < PAGE_SIZE; ++offset) {
+                        if (page->occupied[offset]) {
+                            Destroy(*page, offset);
+                        }
+                    }
+                }
+                pages_.clear();
+                size_ = 0;
+                end_index_ = 0;
+            }
+
+            /**
+             * 预留页表，使id不超过capacity的插入不再扩容页表
+             */
+            void reserve(size_t capacity) {
+                pages_.reserve((capacity + PAGE_MASK) >> PAGE_SHIFT);
+            }
+
+            // ---- 遍历和容量 ----
+
+            iterator begin() { return iterator(this, NextOccupied(0)); }
+            iterator end() { return iterator(this, END_INDEX); }
+            const_iterator begin() const { return const_iterator(this, NextOccupied(0)); }
+            const_iterator end() const { return const_iterator(this, END_INDEX); }
+            const_iterator cbegin() const { return begin(); }
+            const_iterator cend() const { return end(); }
+
+            size_t size() const { return size_; }
+            bool empty() const { return size_ == 0; }
+
+            // 已分配的槽位数（页数 * 每页槽位），用于统计
+            size_t slot_capacity() const {
+                size_t pages = 0;
+                for (const auto& page : pages_) pages += page ? 1 : 0;
+                return pages * PAGE_SIZE;
+            }
+
+        private:
+            value_type* Locate(Handle<Tag> handle) const {
+                const uint32_t index = handle.id - 1;  // id为0时回绕成最大值，落在end_index_之外
+                if (index >= end_index_) {
+                    return nullptr;
+                }
+                Page* page = pages_[index >> PAGE_SHIFT].get();
+                const uint32_t offset = index & PAGE_MASK;
+                if (!page || !page->occupied[offset]) {
+                    return nullptr;
+                }
+                value_type* value = page->Get(offset);
+                return value->first.generation == handle.generation ? value : nullptr;
+            }
+
+            Page& EnsurePage(uint32_t page_index) {
+                if (page_index >= pages_.size()) {
+                    pages_.resize(page_index + 1);
+                }
+                if (!pages_[page_index]) {
+                    pages_[page_index] = std::make_unique<Page>();
+                }
+                return *pages_[page_index];
+            }
+
+            void Destroy(Page& page, uint32_t offset) {
+                page.Get(offset)->~value_type();
+                page.occupied[offset] = false;
+                --size_;
+            }
+
+            uint32_t NextOccupied(uint32_t index) const {
+                while (index < end_index_) {
+                    const Page* page = pages_[index >> PAGE_SHIFT].get();
+                    if (!page) {
+                        index = (index | PAGE_MASK) + 1;
+                        continue;
+                    }
+                    if (page->occupied[index & PAGE_MASK]) {
+                        return index;
+                    }
+                    ++index;
+                }
+                return END_INDEX;
+            }
+
+            // 删除末尾元素后收缩遍历上界
+            void ShrinkEnd() {
+                while (end_index_ > 0) {
+                    const uint32_t last = end_index_ - 1;
+                    const Page* page = pages_[last >> PAGE_SHIFT].get();
+                    if (page && page->occupied[last & PAGE_MASK]) {
+                        break;
+                    }
+                    end_index_ = last;
+                }
+            }
+
+            std::vector<std::unique_ptr<Page>> pages_;
+            size_t size_ = 0;
+            uint32_t end_index_ = 0;  // 最大已占用下标+1，遍历和查找的上界
+        };
+
+        /**
+         * 句柄查找基准：模拟逐帧按句柄查找网格/动画，对比std::unordered_map与SlotMap的查找耗时和遍历耗时
+         */
+        void RunSlotMapBenchmark();
+
+    } // namespace asset
+} // namespace spartan
@@ -0,0 +1,369 @@
+#include "StreamFilter.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPARTAN_STREAM_FILTER_SSE2 1
+#endif
+
+namespace spartan {
+    namespace asset {
+
+        namespace {
+
+            inline uint32_t LoadIndex(const uint8_t* p, size_t index_size) {
+                if (index_size == 2) {
+                    uint16_t value;
+                    std::memcpy(&value, p, sizeof(value));
+                    return value;
+                }
+                uint32_t value;
+                std::memcpy(&value, p, sizeof(value));
+                return value;
+            }
+
+            inline void StoreIndex(uint8_t* p, size_t index_size, uint32_t value) {
+                if (index_size == 2) {
+                    const uint16_t narrow = static_cast<uint16_t>(value);
+                    std::memcpy(p, &narrow, sizeof(narrow));
+                } else {
+                    std::memcpy(p, &value, sizeof(value));
+                }
+            }
+
+#ifdef SPARTAN_STREAM_FILTER_SSE2
+            // 16个字节的前缀和，再加上前一段的最后一个值
+            inline __m128i PrefixSum8(__m128i v, __m128i carry) {
+                v = _mm_add_epi8(v, _mm_slli_si128(v, 1));
+                v = _mm_add_epi8(v, _mm_slli_si128(v, 2));
+                v = _mm_add_epi8(v, _mm_slli_si128(v, 4));
+                v = _mm_add_epi8(v, _mm_slli_si128(v, 8));
+                return _mm_add_epi8(v, carry);
+            }
+
+            inline __m128i BroadcastLast8(__m128i v) {
+                v = _mm_unpackhi_epi8(v, v);
+                v = _mm_unpackhi_epi16(v, v);
+                return _mm_shuffle_epi32(v, 0xFF);
+            }
+
+            inline __m128i ZigzagDecode16(__m128i v) {
+                return _mm_xor_si128(_mm_srli_epi16(v, 1), _mm_sub_epi16(_mm_setzero_si128(),
+                                                                           _mm_and_si128(v, _mm_set1_epi16(1))));
+            }
+
+            inline __m128i ZigzagDecode32(__m128i v) {
+                return _mm_xor_si128(_mm_srli_epi32(v, 1), _mm_sub_epi32(_mm_setzero_si128(),
+                                                                           _mm_and_si128(v, _mm_set1_epi32(1))));
+            }
+
+            inline __m128i PrefixSum16(__m128i v, __m128i carry) {
+                v = _mm_add_epi16(v, _mm_slli_si128(v, 2));
+                v = _mm_add_epi16(v, _mm_slli_si128(v, 4));
+                v = _mm_add_epi16(v, _mm_slli_si128(v, 8));
+                return _mm_add_epi16(v, carry);
+            }
+
+            inline __m128i BroadcastLast16(__m128i v) {
+                v = _mm_shufflehi_epi16(v, 0xFF);
+                return _mm_unpackhi_epi64(v, v);
+            }
+
+            inline __m128i PrefixSum32(__m128i v, __m128i carry) {
+                v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+                v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+                return _mm_add_epi32(v, carry);
+            }
+
+            inline __m128i PrefixXor32(__m128i v, __m128i carry) {
+                v = _mm_xor_si128(v, _mm_slli_si128(v, 4));
+                v = _mm_xor_si128(v, _mm_slli_si128(v, 8));
+                return _mm_xor_si128(v, carry);
+            }
+#endif
+
+        } // namespace
+
+// 顶点字节平面
+        void EncodeBytePlanes(const uint8_t* src, size_t count, size_t stride, uint8_t* dst) {
+            for (size_t b = 0; b < stride; ++b) {
+                uint8_t* plane = dst + b * count;
+                uint8_t previous = 0;
+                for (size_t i = 0; i < count; ++i) {
+                    const uint8_t value = src[i * stride + b];
+                    plane[i] = static_cast<uint8_t>(value - previous);
+                    previous = value;
+                }
+            }
+        }
+
+        void DecodeBytePlanes(const uint8_t* src, size_t count, size_t stride, uint8_t* dst) {
+            size_t b = 0;
+#ifdef SPARTAN_STREAM_FILTER_SSE2
+            // 每次处理4个平面 x 16个顶点：平面内前缀和后两级unpack转置成16个4字节字
+            for (; b + 4 <= stride; b += 4) {
+                const uint8_t* p0 = src + b * count;
+                const uint8_t* p1 = p0 + count;
+                const uint8_t* p2 = p1 + count;
+                const uint8_t* p3 = p2 + count;
+                __m128i c0 = _mm_setzero_si128(), c1 = c0, c2 = c0, c3 = c0;
+
+                size_t i = 0;
+                for (; i + 16 <= count; i += 16) {
+                    __m128i v0 = PrefixSum8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p0 + i)), c0);
+                    __m128i v1 = PrefixSum8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p1 + i)), c1);
+                    __m128i v2 = PrefixSum8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p2 + i)), c2);
+                    __m128i v3 = PrefixSum8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p3 + i)), c3);
+                    c0 = BroadcastLast8(v0);
+                    c1 = BroadcastLast8(v1);
+                    c2 = BroadcastLast8(v2);
+                    c3 = BroadcastLast8(v3);
+
+                    const __m128i a = _mm_unpacklo_epi8(v0, v1);
+                    const __m128i bb = _mm_unpackhi_epi8(v0, v1);
+                    const __m128i c = _mm_unpacklo_epi8(v2, v3);
+                    const __m128i d = _mm_unpackhi_epi8(v2, v3);
+                    alignas(16) uint32_t words[16];
+                    _mm_store_si128(reinterpret_cast<__m128i*>(words + 0), _mm_unpacklo_epi16(a, c));
+                    _mm_store_si128(reinterpret_cast<__m128i*>(words + 4), _mm_unpackhi_epi16(a, c));
+                    _mm_store_si128(reinterpret_cast<__m128i*>(words + 8), _mm_unpacklo_epi16(bb, d));
+                    _mm_store_si128(reinterpret_cast<__m128i*>(words + 12), _mm_unpackhi_epi16(bb, d));
+
+                    uint8_t* out = dst + i * stride + b;
+                    for (size_t k = 0; k < 16; ++k) {
+                        std::memcpy(out + k * stride, &words[k], sizeof(uint32_t));
+                    }
+                }
+
+                // 剩余顶点接着向量部分的累加值走标量路径
+                uint8_t acc[4] = {
+                        static_cast<uint8_t>(_mm_cvtsi128_si32(c0)), static_cast<uint8_t>(_mm_cvtsi128_si32(c1)),
+                        static_cast<uint8_t>(_mm_cvtsi128_si32(c2)), static_cast<uint8_t>(_mm_cvtsi128_si32(c3))};
+                for (; i < count; ++i) {
+                    for (size_t k = 0; k < 4; ++k) {
+                        acc[k] = static_cast<uint8_t>(acc[k] + src[(b + k) * count + i]);
+                        dst[i * stride + b + k] = acc[k];
+                    }
+                }
+            }
+#endif
+            for (; b < stride; ++b) {
+                const uint8_t* plane = src + b * count;
+                uint8_t acc = 0;
+                for (size_t i = 0; i < count; ++i) {
+                    acc = static_cast<uint8_t>(acc + plane[i]);
+                    dst[i * stride + b] = acc;
+                }
+            }
+        }
+
+// 索引差分
+        void EncodeIndexDeltas(const uint8_t* src, size_t count, size_t index_size, uint8_t* dst) {
+            const uint32_t mask = index_size == 2 ? 0xFFFFu : 0xFFFFFFFFu;
+            const uint32_t sign_shift = index_size == 2 ? 15 : 31;
+            uint32_t previous = 0;
+            for (size_t i = 0; i < count; ++i) {
+                const uint32_t value = LoadIndex(src + i * index_size, index_size);
+                const uint32_t delta = (value - previous) & mask;
+                previous = value;
+                // 按索引宽度做zigzag：最高位是符号
+                const uint32_t sign = (delta >> sign_shift) & 1u;
+                const uint32_t zigzag = ((delta << 1) ^ (0u - sign)) & mask;
+                for (size_t b = 0; b < index_size; ++b) {
+                    dst[b * count + i] = static_cast<uint8_t>(zigzag >> (8 * b));
+                }
+            }
+        }
+
+        void DecodeIndexDeltas(const uint8_t* src, size_t count, size_t index_size, uint8_t* dst) {
+            size_t i = 0;
+            uint32_t previous = 0;
+#ifdef SPARTAN_STREAM_FILTER_SSE2
+            if (index_size == 2) {
+                __m128i carry = _mm_setzero_si128();
+                for (; i + 16 <= count; i += 16) {
+                    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                    const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + count + i));
+                    __m128i v0 = PrefixSum16(ZigzagDecode16(_mm_unpacklo_epi8(lo, hi)), carry);
+                    __m128i v1 = PrefixSum16(ZigzagDecode16(_mm_unpackhi_epi8(lo, hi)), BroadcastLast16(v0));
+                    carry = BroadcastLast16(v1);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), v0);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2 + 16), v1);
+                }
+                previous = static_cast<uint32_t>(_mm_cvtsi128_si32(carry)) & 0xFFFFu;
+            } else {
+                __m128i carry = _mm_setzero_si128();
+                for (; i + 16 <= count; i += 16) {
+                    const __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                    const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + count + i));
+                    const __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * count + i));
+                    const __m128i p3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * count + i));
+                    const __m128i a = _mm_unpacklo_epi8(p0, p1);
+                    const __m128i b = _mm_unpackhi_epi8(p0, p1);
+                    const __m128i c = _mm_unpacklo_epi8(p2, p3);
+                    const __m128i d = _mm_unpackhi_epi8(p2, p3);
+                    const __m128i words[4] = {_mm_unpacklo_epi16(a, c), _mm_unpackhi_epi16(a, c),
+                                              _mm_unpacklo_epi16(b, d), _mm_unpackhi_epi16(b, d)};
+                    for (int k = 0; k < 4; ++k) {
+                        const __m128i v = PrefixSum32(ZigzagDecode32(words[k]), carry);
+                        carry = _mm_shuffle_epi32(v, 0xFF);
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (i + k * 4) * 4), v);
+                    }
+                }
+                previous = static_cast<uint32_t>(_mm_cvtsi128_si32(carry));
+            }
+#endif
+            for (; i < count; ++i) {
+                uint32_t zigzag = 0;
+                for (size_t b = 0; b < index_size; ++b) {
+                    zigzag |= static_cast<uint32_t>(src[b * count + i]) << (8 * b);
+                }
+                const uint32_t delta = (zigzag >> 1) ^ (0u - (zigzag & 1u));
+                previous += delta;
+                StoreIndex(dst + i * index_size, index_size, previous);
+            }
+        }
+
+// 关键帧异或差分
+        void EncodeXorDelta(const float* src, size_t count, size_t components, uint32_t* dst) {
+            for (size_t c = 0; c < components; ++c) {
+                uint32_t previous = 0;
+                for (size_t i = 0; i < count; ++i) {
+                    uint32_t bits;
+                    std::memcpy(&bits, &src[i * components + c], sizeof(bits));
+                    dst[i * components + c] = bits ^ previous;
+                    previous = bits;
+                }
+            }
+        }
+
+        void DecodeXorDelta(const uint32_t* src, size_t count, size_t components, float* dst) {
+            size_t i = 0;
+#ifdef SPARTAN_STREAM_FILTER_SSE2
+            // 四元数：一个关键帧正好一个寄存器；标量流：寄存器内做前缀异或
+            if (components == 4) {
+                __m128i previous = _mm_setzero_si128();
+                for (; i < count; ++i) {
+                    previous = _mm_xor_si128(previous, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4)));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), previous);
+                }
+                return;
+            }
+            if (components == 1) {
+                __m128i carry = _mm_setzero_si128();
+                for (; i + 4 <= count; i += 4) {
+                    const __m128i v = PrefixXor32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), carry);
+                    carry = _mm_shuffle_epi32(v, 0xFF);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+                }
+            }
+#endif
+            for (size_t c = 0; c < components; ++c) {
+                uint32_t previous = 0;
+                if (i > 0) {
+                    std::memcpy(&previous, &dst[(i - 1) * components + c], sizeof(previous));
+                }
+                for (size_t k = i; k < count; ++k) {
+                    previous ^= src[k * components + c];
+                    std::memcpy(&dst[k * components + c], &previous, sizeof(previous));
+                }
+            }
+        }
+
+// 解码基准
+        void RunStreamFilterBenchmark() {
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<float> jitter(-0.01f, 0.01f);
+
+            // 网格状的量化顶点（步长20字节）、条带状三角形索引和平滑的四元数曲线
+            const size_t vertex_count = 1 << 20;
+            const size_t stride = 20;
+            std::vector<uint8_t> vertices(vertex_count * stride);
+            for (size_t i = 0; i < vertex_count; ++i) {
+                const uint16_t position[3] = {static_cast<uint16_t>(i % 1024 * 64), static_cast<uint16_t>(rng() & 0xFF),
+                                              static_cast<uint16_t>(i / 1024 * 64)};
+                std::memcpy(&vertices[i * stride], position, sizeof(position));
+                for (size_t b = sizeof(position); b < stride; ++b) {
+                    vertices[i * stride + b] = static_cast<uint8_t>(b * 13 + (rng() & 3));
+                }
+            }
+
+            const size_t index_count = 3 << 20;
+            std::vector<uint32_t> indices(index_count);
+            for (size_t t = 0; t < index_count / 3; ++t) {
+                const uint32_t base = static_cast<uint32_t>(t / 2 + (t / 2) / 1023);
+                indices[t * 3 + 0] = base;
+                indices[t * 3 + 1] = base + 1 + (t & 1) * 1023;
+                indices[t * 3 + 2] = base + 1024;
+            }
+            std::vector<uint16_t> narrow(index_count);
+            for (size_t i = 0; i < index_count; ++i) narrow[i] = static_cast<uint16_t>(indices[i]);
+
+            const size_t key_count = 1 << 20;
+            std::vector<float> keys(key_count * 4);
+            for (size_t i = 0; i < key_count; ++i) {
+                const float angle = static_cast<float>(i) * 0.001f;
+                keys[i * 4 + 0] = std::sin(angle) * 0.5f + jitter(rng);
+                keys[i * 4 + 1] = 0.0f;
+                keys[i * 4 + 2] = 0.0f;
+                keys[i * 4 + 3] = std::cos(angle) * 0.5f + jitter(rng);
+            }
+
+            auto measure = [](const char* label, size_t bytes, const std::function<void()>& decode, bool ok) {
+                const int iterations = 10;
+                decode();
+                auto start = std::chrono::high_resolution_clock::now();
+                for (int i = 0; i < iterations; ++i) decode();
+                const double seconds = std::chrono::duration<double>(
+                        std::chrono::high_resolution_clock::now() - start).count() / iterations;
+                std::cout << "  " << label << ": " << std::fixed << std::setprecision(2) << bytes / seconds / 1e9 << " GB/s"
+                          << (ok ? "" : "  [往返不一致]") << std::defaultfloat << std::endl;
+            };
+
+            std::cout << "=== 流过滤器解码基准"
+#ifdef SPARTAN_STREAM_FILTER_SSE2
+                      << " (SSE2)"
+#else
+                      << " (标量)"
+#endif
+                      << " ===" << std::endl;
+
+            std::vector<uint8_t> encoded(vertices.size()), decoded(vertices.size());
+            EncodeBytePlanes(vertices.data(), vertex_count, stride, encoded.data());
+            DecodeBytePlanes(encoded.data(), vertex_count, stride, decoded.data());
+            measure("顶点字节平面", vertices.size(), [&]() {
+                DecodeBytePlanes(encoded.data(), vertex_count, stride, decoded.data());
+            }, decoded == vertices);
+
+            for (size_t index_size : {size_t(2), size_t(4)}) {
+                const uint8_t* source = index_size == 2 ? reinterpret_cast<const uint8_t*>(narrow.data())
+                                                        : reinterpret_cast<const uint8_t*>(indices.data());
+                const size_t bytes = index_count * index_size;
+                encoded.resize(bytes);
+                decoded.resize(bytes);
+                EncodeIndexDeltas(source, index_count, index_size, encoded.data());
+                DecodeIndexDeltas(encoded.data(), index_count, index_size, decoded.data());
+                measure(index_size == 2 ? "16位索引差分" : "32位索引差分", bytes, [&]() {
+                    DecodeIndexDeltas(encoded.data(), index_count, index_size, decoded.data());
+                }, std::memcmp(decoded.data(), source, bytes) == 0);
+            }
+
+            std::vector<uint32_t> xor_encoded(keys.size());
+            std::vector<float> xor_decoded(keys.size());
+            EncodeXorDelta(keys.data(), key_count, 4, xor_encoded.data());
+            DecodeXorDelta(xor_encoded.data(), key_count, 4, xor_decoded.data());
+            measure("四元数关键帧异或", keys.size() * sizeof(float), [&]() {
+                DecodeXorDelta(xor_encoded.data(), key_count, 4, xor_decoded.data());
+            }, std::memcmp(xor_decoded.data(), keys.data(), keys.size() * sizeof(float)) == 0);
+        }
+
+    } // namespace asset
+} // namespace spartan
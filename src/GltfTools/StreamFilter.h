@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace spartan {
+    namespace asset {
+
+        /**
+         * 压缩前的可逆流变换：把结构化数据重排成LZ更容易匹配的形式
+         * 编码在烘焙时执行（标量），解码在加载时执行（SSE2路径 + 标量回退）
+         */
+        enum class StreamFilter : uint8_t {
+            NONE = 0,
+            BYTE_PLANES = 1,   // 顶点：按字节平面拆分（平面b为每个顶点的第b个字节），平面内再做字节差分
+            DELTA_ZIGZAG = 2,  // 索引：相邻差值 + zigzag，再按字节平面拆分
+            XOR_DELTA = 3,     // 浮点关键帧：与前一个关键帧的同一分量按位异或
+        };
+
+        // 顶点流：count个顶点，每个stride字节
+        void EncodeBytePlanes(const uint8_t* src, size_t count, size_t stride, uint8_t* dst);
+        void DecodeBytePlanes(const uint8_t* src, size_t count, size_t stride, uint8_t* dst);
+
+        // 索引流：index_size为2或4
+        void EncodeIndexDeltas(const uint8_t* src, size_t count, size_t index_size, uint8_t* dst);
+        void DecodeIndexDeltas(const uint8_t* src, size_t count, size_t index_size, uint8_t* dst);
+
+        // 关键帧流：count个关键帧，每个components个float
+        void EncodeXorDelta(const float* src, size_t count, size_t components, uint32_t* dst);
+        void DecodeXorDelta(const uint32_t* src, size_t count, size_t components, float* dst);
+
+        /**
+         * 解码吞吐基准：分别测量三种过滤器的解码速度（GB/s，按解码后的字节计）
+         */
+        void RunStreamFilterBenchmark();
+
+    } // namespace asset
+} // namespace spartan
@@ -1,11 +1,27 @@
 #include "RenderDevice.h"
 #include "AnimationTask.h"
+#include "ShaderCache.h"
 #include <iostream>
 
 // =========================================================================
 // 着色器源码定义 - 支持VTF多角色骨骼偏移
 // =========================================================================
 
+// 每帧常量块，两个阶段声明必须完全一致（包括精度）
+#define FRAME_CONSTANTS_GLSL \
+"struct Light {\n" \
+"    highp vec4 direction;\n" \
+"    highp vec4 color;\n" \
+"};\n" \
+"layout(std140) uniform FrameConstants {\n" \
+"    highp mat4 uViewProjection;\n" \
+"    highp mat4 uView;\n" \
+"    highp vec4 uViewPos;\n" \
+"    highp vec4 uTime;\n" \
+"    highp ivec4 uLightCount;\n" \
+"    Light uLights[4];\n" \
+"};\n"
+
 const char* vertexShaderSource = R"(#version 300 es
 precision highp float;
 
@@ -20,13 +36,18 @@ layout(location = 7) in vec4 aInstanceMatrix1;
 layout(location = 8) in vec4 aInstanceMatrix2;
 layout(location = 9) in vec4 aInstanceMatrix3;
 
-uniform mat4 uViewProjection;
+)" FRAME_CONSTANTS_GLSL R"(
 uniform mat4 uModel;
 uniform highp sampler2D uBoneTexture;
 uniform bool uUseSkinning;
 uniform bool uUseInstancing;
 uniform int uBoneOffset;  // 骨骼偏移 - 支持多角色
 
+// 压缩顶点格式：位置为snorm16，按子网格范围反量化；法线为八面体编码
+uniform bool uVertexQuantized;
+uniform vec3 uPositionOffset;
+uniform vec3 uPositionScale;
+
 out vec3 vNormal;
 out vec2 vTexCoord;
 out vec3 vWorldPos;
@@ -41,9 +62,17 @@ mat4 getBoneMatrix(uint boneIndex) {
     return bone;
 }
 
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
 void main() {
-    vec4 localPos = vec4(aPosition, 1.0);
-    vec3 localNormal = aNormal;
+    vec4 localPos = vec4(aPosition * uPositionScale + uPositionOffset, 1.0);
+    vec3 localNormal = uVertexQuantized ? octDecode(aNormal.xy) : aNormal;
 
     if (uUseSkinning) {
         mat4 skinMatrix =
@@ -89,10 +118,9 @@ in vec4 vWeights;
 
 out vec4 fragColor;
 
+)" FRAME_CONSTANTS_GLSL R"(
 uniform sampler2D uBaseColorTexture;
 uniform vec4 uBaseColorFactor;
-uniform vec3 uLightDir;
-uniform vec3 uViewPos;
 uniform bool uDebugWeights;
 
 void main() {
@@ -100,18 +128,26 @@ void main() {
     if (baseColor.a < 0.1) baseColor.a = 1.0;
 
     vec3 normal = normalize(vNormal);
-    vec3 lightDir = normalize(-uLightDir);
+    vec3 viewDir = normalize(uViewPos.xyz - vWorldPos);
 
-    float diff = max(dot(normal, lightDir), 0.0);
-    vec3 diffuse = diff * baseColor.rgb;
+    vec3 ambient = 0.3 * baseColor.rgb;
+    vec3 result = ambient;
 
-    vec3 viewDir = normalize(uViewPos - vWorldPos);
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
-    vec3 specular = spec * vec3(0.5);
+    for (int i = 0; i < 4; i++) {
+        if (i >= uLightCount.x) break;
 
-    vec3 ambient = 0.3 * baseColor.rgb;
-    vec3 result = ambient + diffuse + specular;
+        vec3 lightDir = normalize(-uLights[i].direction.xyz);
+        vec3 lightColor = uLights[i].color.rgb * uLights[i].direction.w;
+
+        float diff = max(dot(normal, lightDir), 0.0);
+        vec3 diffuse = diff * baseColor.rgb;
+
+        vec3 reflectDir = reflect(-lightDir, normal);
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
+        vec3 specular = spec * vec3(0.5);
+
+        result += (diffuse + specular) * lightColor;
+    }
 
     fragColor = vec4(result, baseColor.a);
 }
@@ -162,12 +198,16 @@ bool RenderDevice::initialize() {
         return false;
     }
 
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glDisable(GL_CULL_FACE);
+    stateCache.invalidate();
+    stateCache.setDepthTest(true);
+    stateCache.setDepthFunc(GL_LESS);
+    stateCache.setCullFace(false);
+    stateCache.setCullMode(GL_BACK);
+    stateCache.setFrontFace(GL_CCW);
     glViewport(0, 0, windowWidth, windowHeight);
 
     createDefaultTexture();
+    createFrameUniformBuffer();
 
     // 初始化GPU骨骼纹理管理器
     if (!BoneTextureManager::getInstance().initialize()) {
@@ -179,39 +219,21 @@ bool RenderDevice::initialize() {
 }
 
 bool RenderDevice::compileShaders() {
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
+    // 优先从程序二进制缓存加载，失败时ShaderCache内部回退到源码编译
+    auto& shaderCache = ShaderCache::getInstance();
+    shaderCache.initialize();
 
-    if (!checkShaderCompile(vertexShader, "顶点着色器")) {
+    shaderProgram = shaderCache.getOrCreateProgram(vertexShaderSource, fragmentShaderSource);
+    if (!shaderProgram) {
+        std::cerr << "着色器程序创建失败" << std::endl;
         return false;
     }
+    mainProgram.reflect(shaderProgram);
 
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fragmentShader);
-
-    if (!checkShaderCompile(fragmentShader, "片段着色器")) {
-        return false;
-    }
-
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    GLint success;
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
-        std::cerr << "着色器程序链接失败: " << infoLog << std::endl;
-        return false;
-    }
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    // 蒙皮、实例化和权重调试目前由uniform开关（uUseSkinning等）在主程序内分支，
+    // 着色器没有VARIANT_*分支，不预热变体；拆出变体后在这里queueWarmup
 
+    shaderCache.printStats();
     return true;
 }
 
@@ -229,20 +251,41 @@ bool RenderDevice::checkShaderCompile(GLuint shader, const char* name) {
 
 void RenderDevice::createDefaultTexture() {
     glGenTextures(1, &defaultTexture);
-    glBindTexture(GL_TEXTURE_2D, defaultTexture);
+    stateCache.bindTexture2D(0, defaultTexture);
     uint32_t white = 0xFFFFFFFF;
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &white);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 }
 
+void RenderDevice::createFrameUniformBuffer() {
+    glGenBuffers(1, &frameUniformBuffer);
+    stateCache.bindBuffer(GL_UNIFORM_BUFFER, frameUniformBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameConstants), nullptr, GL_DYNAMIC_DRAW);
+
+    // 绑定点在整个生命周期内不变，各程序在反射时通过glUniformBlockBinding指向它
+    // glBindBufferBase同时会改写通用绑定，与上面的影子一致
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_CONSTANTS_BINDING, frameUniformBuffer);
+}
+
+void RenderDevice::updateFrameConstants(const FrameConstants& constants) {
+    if (!frameUniformBuffer) {
+        return;
+    }
+
+    stateCache.bindBuffer(GL_UNIFORM_BUFFER, frameUniformBuffer);
+    // 先孤立旧存储，避免等待上一帧仍在使用该缓冲的绘制
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameConstants), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameConstants), &constants);
+}
+
 GLuint RenderDevice::getBoneTexture() const {
     return BoneTextureManager::getInstance().getBoneTextureID();
 }
 
 void RenderDevice::createDummyTexture(spartan::asset::TextureData& texture) {
     glGenTextures(1, &texture.gpu_texture_id);
-    glBindTexture(GL_TEXTURE_2D, texture.gpu_texture_id);
+    stateCache.bindTexture2D(0, texture.gpu_texture_id);
     uint32_t white = 0xFFFFFFFF;
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &white);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -251,6 +294,83 @@ void RenderDevice::createDummyTexture(spartan::asset::TextureData& texture) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 }
 
+size_t RenderDevice::uploadTexture(spartan::asset::TextureData& texture) {
+    if (texture.pixels.empty() || texture.mip_levels == 0) {
+        return 0;
+    }
+
+    // 着色器把采样值直接当作显示颜色，所以sRGB贴图也按线性格式上传
+    GLenum internalFormat = GL_RGBA8;
+    GLenum format = GL_RGBA;
+    switch (texture.channels) {
+        case 1: internalFormat = GL_R8; format = GL_RED; break;
+        case 2: internalFormat = GL_RG8; format = GL_RG; break;
+        case 3: internalFormat = GL_RGB8; format = GL_RGB; break;
+        default: break;
+    }
+
+    glGenTextures(1, &texture.gpu_texture_id);
+    stateCache.bindTexture2D(0, texture.gpu_texture_id);
+
+    // 像素行紧密排列，RGB8/R8的行宽不一定是4的倍数
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (uint32_t level = 0; level < texture.mip_levels; ++level) {
+        glTexImage2D(GL_TEXTURE_2D, level, internalFormat,
+                     texture.GetMipWidth(level), texture.GetMipHeight(level), 0,
+                     format, GL_UNSIGNED_BYTE, texture.pixels.data() + texture.GetMipOffset(level));
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    bool mipmapped = texture.mip_levels > 1;
+    if (!mipmapped && texture.generate_mipmaps) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        mipmapped = true;
+    } else {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(texture.mip_levels - 1));
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    return texture.pixels.size();
+}
+
+void RenderDevice::setupVertexAttributes(const spartan::asset::VertexFormat& format) {
+    using spartan::asset::VertexFormat;
+
+    // 属性位置与着色器中的layout(location)一一对应
+    struct AttributeBinding {
+        VertexFormat::Attribute attribute;
+        uint32_t location;
+        bool integer;
+    };
+    static const AttributeBinding bindings[] = {
+            {VertexFormat::POSITION, 0, false},
+            {VertexFormat::NORMAL,   1, false},
+            {VertexFormat::UV0,      2, false},
+            {VertexFormat::JOINTS0,  4, true},
+            {VertexFormat::WEIGHTS0, 5, false},
+    };
+
+    for (const auto& binding : bindings) {
+        if (!(format.attributes & binding.attribute)) continue;
+        auto it = format.attribute_map.find(binding.attribute);
+        if (it == format.attribute_map.end()) continue;
+
+        const auto& info = it->second;
+        stateCache.enableVertexAttrib(binding.location);
+        if (binding.integer) {
+            glVertexAttribIPointer(binding.location, info.components, info.type,
+                                   format.stride, (void*)(uintptr_t)info.offset);
+        } else {
+            glVertexAttribPointer(binding.location, info.components, info.type, info.normalized,
+                                  format.stride, (void*)(uintptr_t)info.offset);
+        }
+    }
+}
+
 void RenderDevice::checkGLError(const char* operation) {
     GLenum error = glGetError();
     if (error != GL_NO_ERROR) {
@@ -276,12 +396,18 @@ void RenderDevice::cleanup() {
 
     if (defaultTexture) {
         glDeleteTextures(1, &defaultTexture);
+        stateCache.onTextureDeleted(defaultTexture);
         defaultTexture = 0;
     }
-    if (shaderProgram) {
-        glDeleteProgram(shaderProgram);
-        shaderProgram = 0;
+    if (frameUniformBuffer) {
+        glDeleteBuffers(1, &frameUniformBuffer);
+        stateCache.onBufferDeleted(frameUniformBuffer);
+        frameUniformBuffer = 0;
     }
+    // 着色器程序归ShaderCache所有
+    ShaderCache::getInstance().cleanup();
+    mainProgram.reset();
+    shaderProgram = 0;
 
     if (glContext) {
         SDL_GL_DeleteContext(glContext);
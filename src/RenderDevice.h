@@ -2,6 +2,8 @@
 
 #include <SDL2/SDL.h>
 #include "glad/glad.h"
+#include "ShaderProgram.h"
+#include "GLStateCache.h"
 #include "GltfTools/AssetSerializer.h"
 
 // =========================================================================
@@ -23,10 +25,23 @@ public:
     bool compileShaders();
     bool checkShaderCompile(GLuint shader, const char* name);
 
+    // 每帧常量UBO（README 9.2）
+    void createFrameUniformBuffer();
+    void updateFrameConstants(const FrameConstants& constants);
+
     // 纹理相关
     void createDefaultTexture();
     void createDummyTexture(spartan::asset::TextureData& texture);
 
+    /**
+     * 上传TextureData::pixels中的全部mip级别（没有预生成mip且要求mipmap时由GL生成）
+     * @return 上传的字节数，像素为空时返回0且不创建纹理
+     */
+    size_t uploadTexture(spartan::asset::TextureData& texture);
+
+    // 顶点属性：按顶点格式在当前绑定的VAO/VBO上设置属性0-5（独立网格和几何池页共用）
+    void setupVertexAttributes(const spartan::asset::VertexFormat& format);
+
     // 工具函数
     void checkGLError(const char* operation);
 
@@ -36,7 +51,10 @@ public:
     int getWindowWidth() const { return windowWidth; }
     int getWindowHeight() const { return windowHeight; }
     GLuint getShaderProgram() const { return shaderProgram; }
+    ShaderProgram& getMainProgram() { return mainProgram; }
+    GLStateCache& getStateCache() { return stateCache; }
     GLuint getDefaultTexture() const { return defaultTexture; }
+    GLuint getFrameUniformBuffer() const { return frameUniformBuffer; }
 
     // 骨骼纹理现在通过BoneTextureManager管理
     GLuint getBoneTexture() const;
@@ -51,7 +69,10 @@ private:
     int windowHeight = 720;
 
     GLuint shaderProgram = 0;
+    ShaderProgram mainProgram;  // 主程序的uniform反射表和影子值
+    GLStateCache stateCache;    // 绘制路径的GL状态影子
     GLuint defaultTexture = 0;
+    GLuint frameUniformBuffer = 0;
 
     bool isCleanedUp = false;
 };
\ No newline at end of file
@@ -14,6 +14,14 @@ void RenderPipeline::addRenderCommand(const RenderCommand& command) {
 }
 
 void RenderPipeline::processRenderQueue() {
+    auto& state = device.getStateCache();
+    auto& program = device.getMainProgram();
+    frameStats = RenderStats{};
+    state.resetStats();
+    program.resetStats();
+
+    // 深度写关闭时glClear不会清除深度
+    state.setDepthWrite(true);
     glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -22,22 +30,34 @@ void RenderPipeline::processRenderQueue() {
         return a.sortKey < b.sortKey;
     });
 
-    GLuint shaderProgram = device.getShaderProgram();
-    glUseProgram(shaderProgram);
+    state.useProgram(program.getProgram());
 
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, device.getBoneTexture());
-    glUniform1i(glGetUniformLocation(shaderProgram, "uBoneTexture"), 1);
+    state.bindTexture2D(1, device.getBoneTexture());
+    program.setInt(UniformId::BoneTexture, 1);
 
     processBatchedRendering();
 
-    glBindVertexArray(0);
+    state.bindVertexArray(0);
+
+    // 汇总本帧统计
+    frameStats.stateCallsIssued = state.getStats().issued;
+    frameStats.stateCallsFiltered = state.getStats().filtered;
+    frameStats.uniformUploads = program.getStats().uploads;
+    frameStats.uniformsSkipped = program.getStats().skipped;
+    renderStats = frameStats;
+
+    if (batchingStats.frameCount % 60 == 0) {
+        std::cout << "状态统计: GL状态调用 " << renderStats.stateCallsIssued
+                  << ", 过滤 " << renderStats.stateCallsFiltered
+                  << "; Uniform上传 " << renderStats.uniformUploads
+                  << ", 跳过 " << renderStats.uniformsSkipped
+                  << "; 三角形 " << renderStats.triangles << std::endl;
+    }
 }
 
 void RenderPipeline::processBatchedRendering() {
-    // 动态合批统计
-    MaterialHandle currentMaterial;
-    currentMaterial.Invalidate();
+    // 材质切换由Renderer::applyMaterial按状态块差异处理，这里只负责合批
+    renderer.resetMaterialState();
 
     size_t i = 0;
     while (i < renderQueue.size()) {
@@ -62,13 +82,13 @@ void RenderPipeline::processBatchedRendering() {
 
         // 处理实例化绘制命令
         if (command.type == RenderCommandType::DRAW_INSTANCED_MESH) {
-            if (command.drawInstancedMesh.material != currentMaterial) {
-                renderer.setupMaterial(command.drawInstancedMesh.material);
-                currentMaterial = command.drawInstancedMesh.material;
-            }
+            renderer.applyMaterial(command.drawInstancedMesh.materialIndex);
             renderer.executeDrawInstancedMesh(command.drawInstancedMesh);
             ++i;
             batchingStats.totalDrawCalls++;
+            frameStats.drawCalls++;
+            frameStats.triangles += command.drawInstancedMesh.submesh->index_count / 3 *
+                                    static_cast<uint32_t>(command.drawInstancedMesh.instanceMatrices->size());
             continue;
         }
 
@@ -76,10 +96,7 @@ void RenderPipeline::processBatchedRendering() {
         if (command.type == RenderCommandType::DRAW_MESH) {
             const auto& firstDraw = command.drawMesh;
 
-            if (firstDraw.material != currentMaterial) {
-                renderer.setupMaterial(firstDraw.material);
-                currentMaterial = firstDraw.material;
-            }
+            renderer.applyMaterial(firstDraw.materialIndex);
 
             bool canBatch = !firstDraw.wireframe;
 
@@ -87,6 +104,8 @@ void RenderPipeline::processBatchedRendering() {
                 renderer.executeDrawMesh(firstDraw);
                 ++i;
                 batchingStats.totalDrawCalls++;
+                frameStats.drawCalls++;
+                frameStats.triangles += firstDraw.submesh->index_count / 3;
                 continue;
             }
 
@@ -102,7 +121,7 @@ void RenderPipeline::processBatchedRendering() {
                 const auto& nextCommand = renderQueue[i + batchCount];
                 if (nextCommand.type != RenderCommandType::DRAW_MESH ||
                     nextCommand.drawMesh.wireframe ||
-                    nextCommand.drawMesh.material != firstDraw.material ||
+                    nextCommand.drawMesh.materialIndex != firstDraw.materialIndex ||
                     nextCommand.drawMesh.mesh != firstDraw.mesh ||
                     nextCommand.drawMesh.submesh != firstDraw.submesh) {
                     break;
@@ -122,6 +141,11 @@ void RenderPipeline::processBatchedRendering() {
                 renderer.executeDrawMesh(firstDraw);
             }
             batchingStats.totalDrawCalls++;
+            frameStats.drawCalls++;
+            if (batchCount > 1) {
+                frameStats.batchedDrawCalls++;
+            }
+            frameStats.triangles += firstDraw.submesh->index_count / 3 * static_cast<uint32_t>(batchCount);
             i += batchCount;
         }
     }
@@ -149,22 +173,44 @@ void RenderPipeline::submitRenderCommands(entt::registry& registry) {
         break;
     }
 
-    submitGlobalUniforms(registry, viewMatrix);
+    updateFrameConstants(registry, viewMatrix);
     submitMeshes(registry, viewMatrix);
     submitInstancedMeshes(registry, viewMatrix);
 }
 
-void RenderPipeline::submitGlobalUniforms(entt::registry& registry, const glm::mat4& viewMatrix) {
+void RenderPipeline::updateFrameConstants(entt::registry& registry, const glm::mat4& viewMatrix) {
     glm::mat4 projection = glm::perspective(glm::radians(45.0f),
                                             float(renderer.getWindowWidth()) / renderer.getWindowHeight(),
                                             0.1f, 100.0f);
     glm::vec3 viewPos = glm::inverse(viewMatrix)[3];
 
-    glm::mat4 viewProjection = projection * viewMatrix;
+    auto now = std::chrono::high_resolution_clock::now();
+    float totalTime = std::chrono::duration<float>(now - startTime).count();
+    float deltaTime = std::chrono::duration<float>(now - lastFrameTime).count();
+    lastFrameTime = now;
+
+    frameConstants.viewProjection = projection * viewMatrix;
+    frameConstants.view = viewMatrix;
+    frameConstants.viewPos = glm::vec4(viewPos, 1.0f);
+    frameConstants.time = glm::vec4(totalTime, deltaTime, 0.0f, 0.0f);
+
+    // 没有光照管理器提供数据时使用默认方向光
+    if (!lightsProvided) {
+        frameConstants.lightCount = glm::ivec4(1, 0, 0, 0);
+        frameConstants.lights[0].direction = glm::vec4(-0.5f, -1.0f, -0.5f, 1.0f);
+        frameConstants.lights[0].color = glm::vec4(1.0f);
+    }
+
+    device.updateFrameConstants(frameConstants);
+}
 
-    addRenderCommand(RenderCommand::SetUniformMat4("uViewProjection", viewProjection));
-    addRenderCommand(RenderCommand::SetUniformVec3("uViewPos", viewPos));
-    addRenderCommand(RenderCommand::SetUniformVec3("uLightDir", glm::vec3(-0.5f, -1.0f, -0.5f)));
+void RenderPipeline::setDirectionalLights(const std::vector<FrameConstants::Light>& lights) {
+    int count = std::min(static_cast<int>(lights.size()), FrameConstants::MAX_LIGHTS);
+    for (int i = 0; i < count; ++i) {
+        frameConstants.lights[i] = lights[i];
+    }
+    frameConstants.lightCount = glm::ivec4(count, 0, 0, 0);
+    lightsProvided = count > 0;
 }
 
 // 通过任何一个子实体，向上遍历父子关系，找到模型的总根
@@ -200,13 +246,12 @@ void RenderPipeline::submitMeshes(entt::registry& registry, const glm::mat4& vie
             continue;
         }
 
-        auto& asset = renderer.getAsset();
-        auto meshIt = asset.meshes.find(meshComp.handle);
-        if (meshIt == asset.meshes.end() || !meshIt->second.HasGPUData()) {
+        const MeshData* meshData = renderer.getAsset().meshes.get(meshComp.handle);
+        if (!meshData || !meshData->HasGPUData()) {
             continue;
         }
 
-        const auto& mesh = meshIt->second;
+        const auto& mesh = *meshData;
 
         // 默认情况下，模型矩阵就是实体自身的世界矩阵
         glm::mat4 modelMatrix = localTransform.matrix;
@@ -228,13 +273,13 @@ void RenderPipeline::submitMeshes(entt::registry& registry, const glm::mat4& vie
                     int boneOffset = boneManager.getSkeletonOffset(skeleton->handle);
                     if (boneOffset >= 0) {
                         // 添加骨骼偏移uniform设置指令
-                        addRenderCommand(RenderCommand::SetUniformInt("uBoneOffset", boneOffset));
+                        addRenderCommand(RenderCommand::SetUniformInt(UniformId::BoneOffset, boneOffset));
                     }
                 }
             }
         } else {
             // 非蒙皮网格，骨骼偏移设为0
-            addRenderCommand(RenderCommand::SetUniformInt("uBoneOffset", 0));
+            addRenderCommand(RenderCommand::SetUniformInt(UniformId::BoneOffset, 0));
         }
 
         // 后续的排序键和提交逻辑使用修正后的 modelMatrix
@@ -242,16 +287,12 @@ void RenderPipeline::submitMeshes(entt::registry& registry, const glm::mat4& vie
         float depth = viewSpacePos.z;
 
         for (const auto& submesh : mesh.submeshes) {
-            MaterialHandle material = submesh.material;
-            RenderCommand cmd = RenderCommand::DrawMesh(&mesh, &submesh, modelMatrix, material, depth, renderState.wireframe);
+            uint32_t materialIndex = submesh.material_index;
+            RenderCommand cmd = RenderCommand::DrawMesh(&mesh, &submesh, modelMatrix, materialIndex, depth, renderState.wireframe);
 
             // 排序键的计算逻辑
             uint64_t layer = static_cast<uint64_t>(renderState.renderLayer) << 56;
-            bool isTransparent = false;
-            auto matIt = asset.materials.find(material);
-            if (matIt != asset.materials.end() && matIt->second.alpha_mode == MaterialData::MODE_BLEND) {
-                isTransparent = true;
-            }
+            bool isTransparent = renderer.getMaterialState(materialIndex).blend;
             uint64_t transparentFlag = static_cast<uint64_t>(isTransparent) << 55;
             uint32_t depth_u32;
             if (isTransparent) {
@@ -260,7 +301,7 @@ void RenderPipeline::submitMeshes(entt::registry& registry, const glm::mat4& vie
                 depth_u32 = static_cast<uint32_t>(glm::max(0.0f, depth) * 100.0f);
             }
             uint64_t depthBits = static_cast<uint64_t>(depth_u32) << 24;
-            uint64_t materialID = static_cast<uint64_t>(material.id) & 0xFFFFFF;
+            uint64_t materialID = static_cast<uint64_t>(materialIndex) & 0xFFFFFF;
 
             cmd.sortKey = layer | transparentFlag | depthBits | materialID;
             addRenderCommand(cmd);
@@ -274,14 +315,14 @@ void RenderPipeline::submitInstancedMeshes(entt::registry& registry, const glm::
     for (auto entity : instancedView) {
         auto& instancedMesh = instancedView.get<InstancedMeshComponent>(entity);
         if (instancedMesh.getInstanceCount() == 0) continue;
-        auto meshIt = asset.meshes.find(instancedMesh.handle);
-        if (meshIt == asset.meshes.end() || !meshIt->second.HasGPUData()) continue;
+        const MeshData* meshData = asset.meshes.get(instancedMesh.handle);
+        if (!meshData || !meshData->HasGPUData()) continue;
 
-        const auto& mesh = meshIt->second;
+        const auto& mesh = *meshData;
         for (const auto& submesh : mesh.submeshes) {
             RenderCommand cmd = RenderCommand::DrawInstancedMesh(&mesh, &submesh,
-                                                                 &instancedMesh.instanceMatrices, submesh.material);
-            cmd.sortKey = (static_cast<uint64_t>(1) << 56) | (static_cast<uint64_t>(submesh.material.id) & 0xFFFFFF);
+                                                                 &instancedMesh.instanceMatrices, submesh.material_index);
+            cmd.sortKey = (static_cast<uint64_t>(1) << 56) | (static_cast<uint64_t>(submesh.material_index) & 0xFFFFFF);
             addRenderCommand(cmd);
         }
     }
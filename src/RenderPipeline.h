@@ -14,13 +14,34 @@ public:
         return instance;
     }
 
+    /**
+     * 单帧渲染统计（README 7.5）
+     */
+    struct RenderStats {
+        uint32_t drawCalls = 0;             // 实际发出的绘制调用
+        uint32_t batchedDrawCalls = 0;      // 其中由动态合批产生的
+        uint32_t triangles = 0;             // 提交的三角形数（含实例）
+        uint32_t stateCallsIssued = 0;      // 状态缓存下发的GL调用
+        uint32_t stateCallsFiltered = 0;    // 状态缓存过滤的冗余调用
+        uint32_t uniformUploads = 0;        // 实际上传的uniform
+        uint32_t uniformsSkipped = 0;       // 值未变化而跳过的uniform
+    };
+
+    /**
+     * 获取上一帧的渲染统计
+     */
+    const RenderStats& getRenderStats() const { return renderStats; }
+
     // 渲染队列管理
     void clearRenderQueue();
     void addRenderCommand(const RenderCommand& command);
     void processRenderQueue();
 
+    // 每帧常量（写入UBO，每帧一次，所有程序共享）
+    void updateFrameConstants(entt::registry& registry, const glm::mat4& viewMatrix);
+    void setDirectionalLights(const std::vector<FrameConstants::Light>& lights);
+
     // 渲染指令提交
-    void submitGlobalUniforms(entt::registry& registry, const glm::mat4& viewMatrix);
     void submitMeshes(entt::registry& registry, const glm::mat4& viewMatrix);
     void submitInstancedMeshes(entt::registry& registry, const glm::mat4& viewMatrix);
     void submitRenderCommands(entt::registry& registry);
@@ -36,6 +57,12 @@ private:
     Renderer& renderer = Renderer::getInstance();
     RenderDevice& device = RenderDevice::getInstance();
 
+    // 每帧常量的CPU副本
+    FrameConstants frameConstants;
+    bool lightsProvided = false;
+    std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+    std::chrono::high_resolution_clock::time_point lastFrameTime = startTime;
+
     // 批处理统计
     struct BatchingStats {
         int frameCount = 0;
@@ -43,5 +70,8 @@ private:
         int batchedDrawCalls = 0;
     } batchingStats;
 
+    RenderStats renderStats;   // 上一帧结果
+    RenderStats frameStats;    // 当前帧累计
+
     void processBatchedRendering();
 };
\ No newline at end of file
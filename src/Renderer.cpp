@@ -1,4 +1,5 @@
 #include "Renderer.h"
+#include <algorithm>
 #include <iostream>
 // =========================================================================
 // BatchingState 实现
@@ -13,6 +14,7 @@ void Renderer::BatchingState::ensureBufferCreated() {
 void Renderer::BatchingState::cleanup() {
     if (tempInstanceBuffer != 0) {
         glDeleteBuffers(1, &tempInstanceBuffer);
+        RenderDevice::getInstance().getStateCache().onBufferDeleted(tempInstanceBuffer);
         tempInstanceBuffer = 0;
     }
 }
@@ -41,161 +43,264 @@ void Renderer::cleanup() {
         return;
     }
 
+    auto& geometryPool = GeometryPool::getInstance();
     for (auto& [handle, mesh] : asset.meshes) {
-        if (mesh.vao) {
-            glDeleteVertexArrays(1, &mesh.vao);
-            mesh.vao = 0;
-        }
-        if (mesh.vbo) {
-            glDeleteBuffers(1, &mesh.vbo);
-            mesh.vbo = 0;
-        }
-        if (mesh.ibo) {
-            glDeleteBuffers(1, &mesh.ibo);
-            mesh.ibo = 0;
-        }
+        releaseMesh(mesh);
     }
 
+    pendingTextureUploads.clear();
     for (auto& [handle, texture] : asset.textures) {
-        if (texture.gpu_texture_id) {
-            glDeleteTextures(1, &texture.gpu_texture_id);
-            texture.gpu_texture_id = 0;
-        }
+        releaseTexture(texture);
     }
 
+    geometryPool.printStats();
+    geometryPool.cleanup();
+
     // 清理动态合批缓冲区
     batchingState.cleanup();
 
     std::cout << "渲染器资源清理完成" << std::endl;
 }
 
-bool Renderer::loadAsset(const char* gltfPath) {
-    ProcessConfig config;
-    config.generate_tangents = true;
-    config.optimize_vertex_cache = true;
+void Renderer::uploadMesh(MeshData& mesh) {
+    // 几何池开启时同格式网格共享缓冲和VAO，失败时回退到独立缓冲
+    // 映射数据只用于上传，之后释放对文件映射的引用，网格不再持有CPU数据
+    const bool fromMapping = mesh.HasMappedData();
+    if (GeometryPool::getInstance().isEnabled() && GeometryPool::getInstance().allocate(mesh)) {
+        if (fromMapping) {
+            mesh.ReleaseMappedData();
+            mesh.data_state = MeshData::GPU_ONLY;
+        }
+        return;
+    }
+
+    auto& state = device.getStateCache();
 
-    GltfProcessor processor(config);
-    processor.SetProgressCallback([](float progress, const char* stage) {
-        std::cout << "加载进度: " << int(progress * 100) << "% - " << stage << std::endl;
-    });
+    glGenVertexArrays(1, &mesh.vao);
+    state.bindVertexArray(mesh.vao);
 
-    if (!processor.ProcessFile(gltfPath, asset)) {
-        std::cerr << "加载模型失败: " << processor.GetLastError() << std::endl;
-        return false;
+    glGenBuffers(1, &mesh.vbo);
+    state.bindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, mesh.GetVertexDataSize(),
+                 mesh.GetVertexData(), GL_STATIC_DRAW);
+
+    device.setupVertexAttributes(mesh.format);
+
+    if (mesh.mapped_indices && mesh.mapped_index_count > 0) {
+        // 映射的索引已是GPU宽度，直接上传
+        glGenBuffers(1, &mesh.ibo);
+        state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(mesh.mapped_index_count) * mesh.GetIndexSize(),
+                     mesh.mapped_indices, GL_STATIC_DRAW);
+    } else if (!mesh.index_buffer.empty()) {
+        glGenBuffers(1, &mesh.ibo);
+        state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+        if (mesh.index_type == GL_UNSIGNED_SHORT) {
+            std::vector<uint16_t> narrowIndices(mesh.index_buffer.begin(), mesh.index_buffer.end());
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, narrowIndices.size() * sizeof(uint16_t),
+                         narrowIndices.data(), GL_STATIC_DRAW);
+        } else {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.index_buffer.size() * sizeof(uint32_t),
+                         mesh.index_buffer.data(), GL_STATIC_DRAW);
+        }
     }
 
-    for (auto& [handle, mesh] : asset.meshes) {
-        uploadMesh(mesh);
+    state.bindVertexArray(0);
+    mesh.data_state = MeshData::SYNCED;
+    if (fromMapping) {
+        mesh.ReleaseMappedData();
+        mesh.data_state = MeshData::GPU_ONLY;
     }
+}
 
-    for (auto& [handle, texture] : asset.textures) {
-        device.createDummyTexture(texture);
+void Renderer::releaseMesh(MeshData& mesh) {
+    if (mesh.gpu_pooled) {
+        // 共享页的GL对象由几何池统一删除
+        GeometryPool::getInstance().release(mesh);
+        return;
     }
 
-    return true;
+    auto& state = device.getStateCache();
+    if (mesh.vao) {
+        glDeleteVertexArrays(1, &mesh.vao);
+        state.onVertexArrayDeleted(mesh.vao);
+        mesh.vao = 0;
+    }
+    if (mesh.vbo) {
+        glDeleteBuffers(1, &mesh.vbo);
+        state.onBufferDeleted(mesh.vbo);
+        mesh.vbo = 0;
+    }
+    if (mesh.ibo) {
+        glDeleteBuffers(1, &mesh.ibo);
+        state.onBufferDeleted(mesh.ibo);
+        mesh.ibo = 0;
+    }
 }
 
-void Renderer::uploadMesh(MeshData& mesh) {
-    glGenVertexArrays(1, &mesh.vao);
-    glBindVertexArray(mesh.vao);
+void Renderer::releaseTexture(TextureData& texture) {
+    if (texture.gpu_texture_id) {
+        glDeleteTextures(1, &texture.gpu_texture_id);
+        device.getStateCache().onTextureDeleted(texture.gpu_texture_id);
+        texture.gpu_texture_id = 0;
+    }
+}
 
-    glGenBuffers(1, &mesh.vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-    glBufferData(GL_ARRAY_BUFFER, mesh.vertex_buffer.size(),
-                 mesh.vertex_buffer.data(), GL_STATIC_DRAW);
-
-    const auto& format = mesh.format;
-
-    if (format.attributes & VertexFormat::POSITION) {
-        auto it = format.attribute_map.find(VertexFormat::POSITION);
-        if (it != format.attribute_map.end()) {
-            const auto& info = it->second;
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, info.components, info.type, info.normalized,
-                                  format.stride, (void*)(uintptr_t)info.offset);
-        }
+void Renderer::queueTextureUpload(TextureHandle handle) {
+    auto it = asset.textures.find(handle);
+    if (it == asset.textures.end()) {
+        return;
     }
+    if (it->second.pixels.empty()) {
+        device.createDummyTexture(it->second);
+    } else {
+        pendingTextureUploads.push_back(handle);
+    }
+}
 
-    if (format.attributes & VertexFormat::NORMAL) {
-        auto it = format.attribute_map.find(VertexFormat::NORMAL);
-        if (it != format.attribute_map.end()) {
-            const auto& info = it->second;
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(1, info.components, info.type, info.normalized,
-                                  format.stride, (void*)(uintptr_t)info.offset);
+void Renderer::compileMaterials() {
+    materialStates.clear();
+    boundMaterialIndex = INVALID_MATERIAL_INDEX;
+
+    // 索引0：默认材质，双面（无材质的网格绕序不可信，不剔除）
+    MaterialState defaultState;
+    defaultState.baseColorTexture = device.getDefaultTexture();
+    defaultState.doubleSided = true;
+    materialStates.push_back(defaultState);
+
+    // 材质表按句柄id升序遍历，每次加载得到相同的稠密索引
+    SlotMap<MaterialTag, uint32_t> indexMap;
+    for (const auto& [handle, material] : asset.materials) {
+        MaterialState state;
+        state.baseColorTexture = device.getDefaultTexture();
+        if (material.base_color_texture.has_value()) {
+            state.baseColorSource = material.base_color_texture.value();
+            auto texIt = asset.textures.find(material.base_color_texture.value());
+            if (texIt != asset.textures.end() && texIt->second.gpu_texture_id != 0) {
+                state.baseColorTexture = texIt->second.gpu_texture_id;
+            }
         }
+        state.baseColorFactor = ToGLM(material.base_color_factor);
+        state.blend = material.alpha_mode == MaterialData::MODE_BLEND;
+        state.doubleSided = material.double_sided;
+
+        indexMap[handle] = static_cast<uint32_t>(materialStates.size());
+        materialStates.push_back(state);
     }
 
-    if (format.attributes & VertexFormat::UV0) {
-        auto it = format.attribute_map.find(VertexFormat::UV0);
-        if (it != format.attribute_map.end()) {
-            const auto& info = it->second;
-            glEnableVertexAttribArray(2);
-            glVertexAttribPointer(2, info.components, info.type, info.normalized,
-                                  format.stride, (void*)(uintptr_t)info.offset);
+    // 把稠密索引写回子网格，绘制路径不再查找句柄
+    for (auto& [meshHandle, mesh] : asset.meshes) {
+        for (auto& submesh : mesh.submeshes) {
+            const uint32_t* index = indexMap.get(submesh.material);
+            submesh.material_index = index ? *index : DEFAULT_MATERIAL_INDEX;
         }
     }
 
-    if (format.attributes & VertexFormat::JOINTS0) {
-        auto it = format.attribute_map.find(VertexFormat::JOINTS0);
-        if (it != format.attribute_map.end()) {
-            const auto& info = it->second;
-            glEnableVertexAttribArray(4);
-            glVertexAttribIPointer(4, info.components, info.type,
-                                   format.stride, (void*)(uintptr_t)info.offset);
+    std::cout << "材质编译完成: " << materialStates.size() << " 个状态块（含默认材质）" << std::endl;
+}
+
+uint32_t Renderer::tickTextureUploads(size_t byteBudget) {
+    uint32_t uploaded = 0;
+    size_t bytes = 0;
+
+    while (!pendingTextureUploads.empty() && (uploaded == 0 || bytes < byteBudget)) {
+        TextureHandle handle = pendingTextureUploads.front();
+        pendingTextureUploads.pop_front();
+
+        auto it = asset.textures.find(handle);
+        if (it == asset.textures.end() || it->second.gpu_texture_id != 0) {
+            continue;
+        }
+
+        bytes += device.uploadTexture(it->second);
+        uploaded++;
+
+        // 像素只用于上传，上传成功后释放CPU副本
+        if (it->second.gpu_texture_id != 0) {
+            std::vector<uint8_t>().swap(it->second.pixels);
+        }
+
+        // 已编译的材质直接换上新纹理，不需要重新编译
+        for (auto& state : materialStates) {
+            if (state.baseColorSource == handle) {
+                state.baseColorTexture = it->second.gpu_texture_id;
+            }
         }
     }
 
-    if (format.attributes & VertexFormat::WEIGHTS0) {
-        auto it = format.attribute_map.find(VertexFormat::WEIGHTS0);
-        if (it != format.attribute_map.end()) {
-            const auto& info = it->second;
-            glEnableVertexAttribArray(5);
-            glVertexAttribPointer(5, info.components, info.type, info.normalized,
-                                  format.stride, (void*)(uintptr_t)info.offset);
+    if (uploaded > 0) {
+        // 当前绑定的材质可能引用了刚替换的纹理
+        boundMaterialIndex = INVALID_MATERIAL_INDEX;
+        if (pendingTextureUploads.empty()) {
+            std::cout << "纹理上传完成" << std::endl;
         }
     }
+    return uploaded;
+}
 
-    if (!mesh.index_buffer.empty()) {
-        glGenBuffers(1, &mesh.ibo);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.index_buffer.size() * sizeof(uint32_t),
-                     mesh.index_buffer.data(), GL_STATIC_DRAW);
+const Renderer::MaterialState& Renderer::getMaterialState(uint32_t materialIndex) const {
+    if (materialIndex >= materialStates.size()) {
+        static const MaterialState fallback;
+        return materialStates.empty() ? fallback : materialStates[DEFAULT_MATERIAL_INDEX];
     }
+    return materialStates[materialIndex];
+}
 
-    glBindVertexArray(0);
-    mesh.data_state = MeshData::SYNCED;
+void Renderer::applyMaterial(uint32_t materialIndex) {
+    if (materialIndex >= materialStates.size()) {
+        materialIndex = DEFAULT_MATERIAL_INDEX;
+    }
+    if (materialIndex == boundMaterialIndex || materialStates.empty()) {
+        return;
+    }
+
+    auto& program = device.getMainProgram();
+    auto& state = device.getStateCache();
+    const MaterialState& next = materialStates[materialIndex];
+    const MaterialState* bound = boundMaterialIndex < materialStates.size()
+                                 ? &materialStates[boundMaterialIndex] : nullptr;
+
+    // 只应用与当前绑定状态块不同的部分
+    if (!bound || bound->baseColorTexture != next.baseColorTexture) {
+        state.bindTexture2D(0, next.baseColorTexture);
+    }
+    if (!bound) {
+        program.setInt(UniformId::BaseColorTexture, 0);
+    }
+    if (!bound || bound->baseColorFactor != next.baseColorFactor) {
+        program.setVec4(UniformId::BaseColorFactor, next.baseColorFactor);
+    }
+    if (!bound || bound->blend != next.blend) {
+        state.setBlend(next.blend);
+        state.setDepthWrite(!next.blend);
+        if (next.blend) {
+            state.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
+    }
+    // 剔除还取决于模型矩阵的朝向，由绘制时的applyCulling设置
+
+    boundMaterialIndex = materialIndex;
 }
 
-void Renderer::setupMaterial(const MaterialHandle& materialHandle) {
-    GLuint shaderProgram = device.getShaderProgram();
-    GLuint defaultTexture = device.getDefaultTexture();
-    
-    if (materialHandle.IsValid()) {
-        auto matIt = asset.materials.find(materialHandle);
-        if (matIt != asset.materials.end()) {
-            const auto& material = matIt->second;
-            glUniform4f(glGetUniformLocation(shaderProgram, "uBaseColorFactor"),
-                        material.base_color_factor.x, material.base_color_factor.y,
-                        material.base_color_factor.z, material.base_color_factor.w);
-
-            glActiveTexture(GL_TEXTURE0);
-            GLuint textureId = defaultTexture;
-            if (material.base_color_texture.has_value()) {
-                auto texIt = asset.textures.find(material.base_color_texture.value());
-                if (texIt != asset.textures.end()) {
-                    textureId = texIt->second.gpu_texture_id;
-                }
-            }
-            glBindTexture(GL_TEXTURE_2D, textureId);
-            glUniform1i(glGetUniformLocation(shaderProgram, "uBaseColorTexture"), 0);
+void Renderer::applyCulling(uint32_t materialIndex, const glm::mat4* modelMatrices, size_t count) {
+    auto& state = device.getStateCache();
+    if (getMaterialState(materialIndex).doubleSided || count == 0) {
+        state.setCullFace(false);
+        return;
+    }
+
+    size_t mirrored = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (glm::determinant(glm::mat3(modelMatrices[i])) < 0.0f) {
+            mirrored++;
         }
-    } else {
-        glUniform4f(glGetUniformLocation(shaderProgram, "uBaseColorFactor"), 1.0f, 1.0f, 1.0f, 1.0f);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, defaultTexture);
-        glUniform1i(glGetUniformLocation(shaderProgram, "uBaseColorTexture"), 0);
     }
+    if (mirrored != 0 && mirrored != count) {
+        state.setCullFace(false);
+        return;
+    }
+    state.setFrontFace(mirrored == 0 ? GL_CCW : GL_CW);
+    state.setCullFace(true);
 }
 
 void Renderer::setupInstancedVAO(MeshData& mesh, uint32_t instanceBuffer) {
@@ -204,66 +309,95 @@ void Renderer::setupInstancedVAO(MeshData& mesh, uint32_t instanceBuffer) {
         return;
     }
 
-    glBindVertexArray(mesh.vao);
+    // 池中网格共享VAO，实例属性只在实例化绘制期间指向instance_buffer（见executeDrawInstancedMesh）
+    mesh.instance_buffer = instanceBuffer;
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+void Renderer::bindInstanceAttributes(uint32_t instanceBuffer) {
+    auto& state = device.getStateCache();
+    state.bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
 
     for (int i = 0; i < 4; i++) {
-        glEnableVertexAttribArray(6 + i);
+        state.enableVertexAttrib(6 + i);
         glVertexAttribPointer(6 + i, 4, GL_FLOAT, GL_FALSE,
                               sizeof(glm::mat4),
                               (void*)(i * sizeof(glm::vec4)));
-        glVertexAttribDivisor(6 + i, 1);
+        state.vertexAttribDivisor(6 + i, 1);
     }
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-    glBindVertexArray(0);
+void Renderer::unbindInstanceAttributes() {
+    auto& state = device.getStateCache();
+    for (int i = 0; i < 4; i++) {
+        state.vertexAttribDivisor(6 + i, 0);
+        state.disableVertexAttrib(6 + i);
+    }
 }
 
 void Renderer::executeDrawMesh(const RenderCommand::DrawMeshData& data) {
     const auto& mesh = *data.mesh;
     const auto& submesh = *data.submesh;
-    GLuint shaderProgram = device.getShaderProgram();
+    auto& program = device.getMainProgram();
 
-    glBindVertexArray(mesh.vao);
+    device.getStateCache().bindVertexArray(mesh.vao);
+    applyVertexFormat(mesh, submesh);
 
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "uModel"), 1, GL_FALSE, glm::value_ptr(data.modelMatrix));
-    glUniform1i(glGetUniformLocation(shaderProgram, "uUseInstancing"), 0);
+    program.setMat4(UniformId::Model, data.modelMatrix);
+    program.setInt(UniformId::UseInstancing, 0);
+    applyCulling(data.materialIndex, &data.modelMatrix, 1);
 
     bool isSkinned = (mesh.format.attributes & VertexFormat::JOINTS0) && mesh.skeleton.has_value();
-    glUniform1i(glGetUniformLocation(shaderProgram, "uUseSkinning"), isSkinned ? 1 : 0);
+    program.setInt(UniformId::UseSkinning, isSkinned ? 1 : 0);
 
+    const uint32_t indexSize = mesh.GetIndexSize();
+    const uint32_t firstIndex = mesh.gpu_first_index + submesh.index_offset;
     if (data.wireframe) {
         for (uint32_t i = 0; i < submesh.index_count; i += 3) {
-            glDrawElements(GL_LINE_LOOP, 3, GL_UNSIGNED_INT, (void*)((submesh.index_offset + i) * sizeof(uint32_t)));
+            glDrawElements(GL_LINE_LOOP, 3, mesh.index_type, (void*)(uintptr_t)((firstIndex + i) * indexSize));
         }
     } else {
-        glDrawElements(GL_TRIANGLES, submesh.index_count, GL_UNSIGNED_INT, (void*)(submesh.index_offset * sizeof(uint32_t)));
+        glDrawElements(GL_TRIANGLES, submesh.index_count, mesh.index_type, (void*)(uintptr_t)(firstIndex * indexSize));
     }
 }
 
 void Renderer::executeDrawInstancedMesh(const RenderCommand::DrawInstancedMeshData& data) {
     const auto& mesh = *data.mesh;
     const auto& submesh = *data.submesh;
-    GLuint shaderProgram = device.getShaderProgram();
+    auto& program = device.getMainProgram();
 
-    glBindVertexArray(mesh.vao);
+    device.getStateCache().bindVertexArray(mesh.vao);
+    if (!mesh.instance_buffer) {
+        return;
+    }
+    bindInstanceAttributes(mesh.instance_buffer);
+    applyVertexFormat(mesh, submesh);
 
-    glUniform1i(glGetUniformLocation(shaderProgram, "uUseInstancing"), 1);
+    program.setInt(UniformId::UseInstancing, 1);
 
     bool isSkinned = (mesh.format.attributes & VertexFormat::JOINTS0) && mesh.skeleton.has_value();
-    glUniform1i(glGetUniformLocation(shaderProgram, "uUseSkinning"), isSkinned ? 1 : 0);
+    program.setInt(UniformId::UseSkinning, isSkinned ? 1 : 0);
 
-    setupMaterial(data.material);
+    applyMaterial(data.materialIndex);
+    applyCulling(data.materialIndex, data.instanceMatrices->data(), data.instanceMatrices->size());
 
     uint32_t instanceCount = static_cast<uint32_t>(data.instanceMatrices->size());
     glDrawElementsInstanced(
             GL_TRIANGLES,
             submesh.index_count,
-            GL_UNSIGNED_INT,
-            (void*)(submesh.index_offset * sizeof(uint32_t)),
+            mesh.index_type,
+            (void*)(uintptr_t)((mesh.gpu_first_index + submesh.index_offset) * mesh.GetIndexSize()),
             instanceCount
     );
+    unbindInstanceAttributes();
+}
+
+void Renderer::applyVertexFormat(const MeshData& mesh, const MeshData::SubMesh& submesh) {
+    auto& program = device.getMainProgram();
+
+    // 未量化的子网格反量化变换为恒等，uniform影子会过滤掉重复设置
+    program.setInt(UniformId::VertexQuantized, mesh.format.quantized ? 1 : 0);
+    program.setVec3(UniformId::PositionOffset, submesh.dequant_offset);
+    program.setVec3(UniformId::PositionScale, submesh.dequant_scale);
 }
 
 void Renderer::executeSetBones(const RenderCommand::SetBonesData& data) {
@@ -274,25 +408,24 @@ void Renderer::executeSetBones(const RenderCommand::SetBonesData& data) {
 }
 
 void Renderer::executeSetUniform(const RenderCommand::SetUniformData& data) {
-    GLuint shaderProgram = device.getShaderProgram();
-    GLint location = glGetUniformLocation(shaderProgram, data.name.c_str());
-    if (location == -1) return;
+    auto& program = device.getMainProgram();
+    if (!program.hasUniform(data.uniform)) return;
 
     switch (data.type) {
         case RenderCommand::SetUniformData::MAT4:
-            glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(data.mat4Value));
+            program.setMat4(data.uniform, data.mat4Value);
             break;
         case RenderCommand::SetUniformData::VEC3:
-            glUniform3fv(location, 1, glm::value_ptr(data.vec3Value));
+            program.setVec3(data.uniform, data.vec3Value);
             break;
         case RenderCommand::SetUniformData::VEC4:
-            glUniform4fv(location, 1, glm::value_ptr(data.vec4Value));
+            program.setVec4(data.uniform, data.vec4Value);
             break;
         case RenderCommand::SetUniformData::FLOAT:
-            glUniform1f(location, data.floatValue);
+            program.setFloat(data.uniform, data.floatValue);
             break;
         case RenderCommand::SetUniformData::INT:
-            glUniform1i(location, data.intValue);
+            program.setInt(data.uniform, data.intValue);
             break;
     }
 }
@@ -301,44 +434,35 @@ void Renderer::executeSetUniform(const RenderCommand::SetUniformData& data) {
 void Renderer::executeBatchedDraw(const RenderCommand::DrawMeshData& data, const std::vector<glm::mat4>& instanceMatrices) {
     const auto& mesh = *data.mesh;
     const auto& submesh = *data.submesh;
-    GLuint shaderProgram = device.getShaderProgram();
+    auto& program = device.getMainProgram();
+
+    auto& state = device.getStateCache();
 
     // 上传实例矩阵到临时缓冲区
     batchingState.ensureBufferCreated();
-    glBindBuffer(GL_ARRAY_BUFFER, batchingState.tempInstanceBuffer);
+    state.bindBuffer(GL_ARRAY_BUFFER, batchingState.tempInstanceBuffer);
     glBufferData(GL_ARRAY_BUFFER,
                  instanceMatrices.size() * sizeof(glm::mat4),
                  instanceMatrices.data(),
                  GL_STREAM_DRAW);
 
-    // 设置VAO的实例化属性
-    glBindVertexArray(mesh.vao);
-    for (int i = 0; i < 4; i++) {
-        glEnableVertexAttribArray(6 + i);
-        glVertexAttribPointer(6 + i, 4, GL_FLOAT, GL_FALSE,
-                              sizeof(glm::mat4),
-                              (void*)(i * sizeof(glm::vec4)));
-        glVertexAttribDivisor(6 + i, 1);
-    }
-
-    // 恢复顶点缓冲区绑定
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    // 设置VAO的实例化属性，绘制后立即关闭：池中网格共享VAO，
+    // 属性留在启用状态会让同页其它网格的普通绘制读取临时实例缓冲
+    state.bindVertexArray(mesh.vao);
+    bindInstanceAttributes(batchingState.tempInstanceBuffer);
+    applyVertexFormat(mesh, submesh);
 
-    glUniform1i(glGetUniformLocation(shaderProgram, "uUseInstancing"), 1);
+    program.setInt(UniformId::UseInstancing, 1);
     bool isSkinned = (mesh.format.attributes & VertexFormat::JOINTS0) && mesh.skeleton.has_value();
-    glUniform1i(glGetUniformLocation(shaderProgram, "uUseSkinning"), isSkinned ? 1 : 0);
+    program.setInt(UniformId::UseSkinning, isSkinned ? 1 : 0);
+    applyCulling(data.materialIndex, instanceMatrices.data(), instanceMatrices.size());
 
     glDrawElementsInstanced(
             GL_TRIANGLES,
             submesh.index_count,
-            GL_UNSIGNED_INT,
-            (void*)(submesh.index_offset * sizeof(uint32_t)),
+            mesh.index_type,
+            (void*)(uintptr_t)((mesh.gpu_first_index + submesh.index_offset) * mesh.GetIndexSize()),
             static_cast<GLsizei>(instanceMatrices.size())
     );
-
-    // 清理实例化属性（避免影响后续非实例化绘制）
-    for (int i = 0; i < 4; i++) {
-        glVertexAttribDivisor(6 + i, 0);
-        glDisableVertexAttribArray(6 + i);
-    }
+    unbindInstanceAttributes();
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
 #include "RenderDevice.h"
+#include "GeometryPool.h"
 #include "GltfTools/AssetSerializer.h"
 #include "EntityComponents.h"
 #include "glad/glad.h"
+#include <deque>
 
 // =========================================================================
 // 渲染器 - 负责资源管理和绘制调用执行
@@ -15,17 +17,52 @@ public:
         return instance;
     }
 
+    /**
+     * 预编译的材质状态块 - 加载时由MaterialData生成，按稠密索引访问
+     */
+    struct MaterialState {
+        GLuint baseColorTexture = 0;          // 纹理单元0
+        TextureHandle baseColorSource;        // 来源纹理，上传完成后替换默认纹理
+        glm::vec4 baseColorFactor{1.0f};
+        bool blend = false;                   // MODE_BLEND：开启混合并关闭深度写入
+        bool doubleSided = false;             // false时开启背面剔除（见applyCulling）
+    };
+
+    static constexpr uint32_t DEFAULT_MATERIAL_INDEX = 0;      // 无材质的子网格使用
+    static constexpr uint32_t INVALID_MATERIAL_INDEX = 0xFFFFFFFFu;
+
     void shutdown() { cleanup(); }
 
     bool initialize();
     void cleanup();
 
-    // 资产管理
-    bool loadAsset(const char* gltfPath);
+    // 资产管理（资源包的加载和卸载见ResourceManager）
     void uploadMesh(MeshData& mesh);
 
+    /**
+     * 删除网格/纹理的GPU对象；池中网格归还几何池
+     */
+    void releaseMesh(MeshData& mesh);
+    void releaseTexture(TextureData& texture);
+
+    /**
+     * 排队上传纹理：没有像素的纹理立即用白色占位，其余在帧尾按预算上传
+     */
+    void queueTextureUpload(TextureHandle handle);
+
     // 材质和纹理
-    void setupMaterial(const MaterialHandle& materialHandle);
+    void compileMaterials();
+
+    /**
+     * 在帧尾按字节预算上传排队的纹理（每次至少一张），上传后更新引用它的材质
+     * @return 本次上传的纹理数
+     */
+    uint32_t tickTextureUploads(size_t byteBudget);
+    size_t getPendingTextureCount() const { return pendingTextureUploads.size(); }
+    void applyMaterial(uint32_t materialIndex);
+    void resetMaterialState() { boundMaterialIndex = INVALID_MATERIAL_INDEX; }
+    const MaterialState& getMaterialState(uint32_t materialIndex) const;
+    uint32_t getMaterialCount() const { return static_cast<uint32_t>(materialStates.size()); }
     void setupInstancedVAO(MeshData& mesh, uint32_t instanceBuffer);
 
     // 绘制执行
@@ -49,6 +86,28 @@ private:
     ProcessedAsset asset;
     bool isCleanedUp = false;
 
+    // 稠密材质状态块，索引0为默认材质
+    std::vector<MaterialState> materialStates;
+    uint32_t boundMaterialIndex = INVALID_MATERIAL_INDEX;
+
+    // 等待上传的纹理（按句柄顺序），上传前材质使用默认纹理
+    std::deque<TextureHandle> pendingTextureUploads;
+
+    // 设置顶点格式相关的uniform（量化标志和子网格位置反量化变换）
+    void applyVertexFormat(const MeshData& mesh, const MeshData::SubMesh& submesh);
+
+    /**
+     * 按材质和模型矩阵设置剔除：双面材质不剔除；行列式为负（镜像）时正面改为顺时针，
+     * 一次实例化绘制中镜像和非镜像矩阵混合时关闭剔除
+     */
+    void applyCulling(uint32_t materialIndex, const glm::mat4* modelMatrices, size_t count);
+
+    // 把属性6-9（实例矩阵）指向给定缓冲，作用于当前绑定的VAO
+    void bindInstanceAttributes(uint32_t instanceBuffer);
+
+    // 关闭属性6-9并把divisor恢复为0，实例化绘制结束后调用
+    void unbindInstanceAttributes();
+
     // 动态合批相关
     struct BatchingState {
         GLuint tempInstanceBuffer = 0;
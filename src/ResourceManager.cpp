@@ -0,0 +1,541 @@
+#include "ResourceManager.h"
+#include "Renderer.h"
+#include "GeometryPool.h"
+#include "AnimationTask.h"
+#include "GltfTools/AssetCache.h"
+#include <iostream>
+
+namespace {
+
+    template<typename Tag>
+    bool acquireSlot(ResourceSlotTable<Tag>& table, Handle<Tag> handle) {
+        auto* slot = table.find(handle);
+        if (!slot) {
+            return false;
+        }
+        // 排队释放期间重新获取的资源在帧尾被跳过
+        ++slot->refCount;
+        return true;
+    }
+
+    template<typename Tag>
+    void releaseSlot(ResourceSlotTable<Tag>& table, std::vector<Handle<Tag>>& pending, Handle<Tag> handle) {
+        auto* slot = table.find(handle);
+        if (!slot || slot->refCount == 0) {
+            return;
+        }
+        if (--slot->refCount == 0 && !slot->pendingFree) {
+            slot->pendingFree = true;
+            pending.push_back(handle);
+        }
+    }
+
+    template<typename Tag>
+    uint32_t slotRefCount(const ResourceSlotTable<Tag>& table, Handle<Tag> handle) {
+        const auto* slot = table.find(handle);
+        return slot ? slot->refCount : 0;
+    }
+
+    // 包内句柄 -> 全局句柄
+    template<typename Tag>
+    using RemapTable = SlotMap<Tag, Handle<Tag>>;
+
+    template<typename Tag>
+    Handle<Tag> remap(const RemapTable<Tag>& table, Handle<Tag> handle) {
+        auto it = table.find(handle);
+        return it != table.end() ? it->second : Handle<Tag>{};
+    }
+
+    template<typename Tag>
+    void remap(const RemapTable<Tag>& table, std::optional<Handle<Tag>>& handle) {
+        if (!handle.has_value()) {
+            return;
+        }
+        auto it = table.find(handle.value());
+        if (it != table.end()) {
+            handle = it->second;
+        } else {
+            handle.reset();
+        }
+    }
+
+} // namespace
+
+// =========================================================================
+// 加载
+// =========================================================================
+
+ProcessConfig ResourceManager::makeRuntimeConfig() {
+    ProcessConfig config;
+    config.generate_tangents = true;
+    config.optimize_vertex_cache = true;
+    config.optimize_overdraw = true;
+    config.optimize_vertex_fetch = true;
+    config.quantize_vertices = true;
+    config.parallel_import = true;
+    return config;
+}
+
+PackHandle ResourceManager::loadPack(const char* gltfPath) {
+    PackHandle handle = packSlots.allocate(0);
+    if (packs.size() < packSlots.capacity()) {
+        packs.resize(packSlots.capacity());
+    }
+    Pack& pack = packs[handle.id - 1];
+    pack = Pack();
+    pack.path = gltfPath;
+
+    // 源文件、依赖和配置都未变化时直接加载上次处理的结果
+    AssetCache cache;
+    auto progress = [](float progress, const char* stage, double stageMs) {
+        std::cout << "加载进度: " << int(progress * 100) << "% - " << stage << " (" << stageMs << "ms)" << std::endl;
+    };
+
+    ProcessedAsset source;
+    if (!cache.Load(gltfPath, makeRuntimeConfig(), source, progress)) {
+        lastError = cache.GetLastError();
+        std::cerr << "加载资源包失败: " << gltfPath << " - " << lastError << std::endl;
+        pack = Pack();
+        packSlots.free(handle);
+        return PackHandle{};
+    }
+
+    integrate(handle, source);
+    return handle;
+}
+
+PackHandle ResourceManager::loadPackAsync(const char* gltfPath) {
+    PackHandle handle = packSlots.allocate(0);
+    if (packs.size() < packSlots.capacity()) {
+        packs.resize(packSlots.capacity());
+    }
+    Pack& pack = packs[handle.id - 1];
+    pack = Pack();
+    pack.path = gltfPath;
+
+    auto job = std::make_unique<LoadJob>();
+    job->pack = handle;
+    job->path = gltfPath;
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        if (!worker.joinable()) {
+            stopWorker = false;
+            worker = std::thread(&ResourceManager::workerLoop, this);
+        }
+        queuedJobs.push_back(std::move(job));
+    }
+    jobCondition.notify_one();
+    return handle;
+}
+
+void ResourceManager::workerLoop() {
+    for (;;) {
+        std::unique_ptr<LoadJob> job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobCondition.wait(lock, [this] { return stopWorker || !queuedJobs.empty(); });
+            if (stopWorker) {
+                return;
+            }
+            job = std::move(queuedJobs.front());
+            queuedJobs.pop_front();
+        }
+
+        // 只做文件读取和解码，不触碰GL和全局资产
+        AssetCache cache;
+        job->asset = std::make_unique<ProcessedAsset>();
+        job->succeeded = cache.Load(job->path.c_str(), makeRuntimeConfig(), *job->asset);
+        if (!job->succeeded) {
+            job->error = cache.GetLastError();
+            job->asset.reset();
+        }
+
+        std::lock_guard<std::mutex> lock(jobMutex);
+        finishedJobs.push_back(std::move(job));
+    }
+}
+
+void ResourceManager::integrate(PackHandle packHandle, ProcessedAsset& source) {
+    auto& renderer = Renderer::getInstance();
+    auto& asset = renderer.getAsset();
+    Pack& pack = packs[packHandle.id - 1];
+    const uint32_t owner = packHandle.id;
+
+    // 1. 为包内每个资源分配全局句柄（资源表按包内句柄id升序遍历，分配顺序稳定）
+    RemapTable<MeshTag> meshMap;
+    RemapTable<MaterialTag> materialMap;
+    RemapTable<TextureTag> textureMap;
+    RemapTable<SkeletonTag> skeletonMap;
+    RemapTable<AnimationTag> animationMap;
+
+    for (const auto& [local, item] : source.textures) {
+        textureMap[local] = textureSlots.allocate(owner);
+    }
+    for (const auto& [local, item] : source.materials) {
+        materialMap[local] = materialSlots.allocate(owner);
+    }
+    for (const auto& [local, item] : source.skeletons) {
+        skeletonMap[local] = skeletonSlots.allocate(owner);
+    }
+    for (const auto& [local, item] : source.meshes) {
+        meshMap[local] = meshSlots.allocate(owner);
+    }
+    for (const auto& [local, item] : source.animations) {
+        animationMap[local] = animationSlots.allocate(owner);
+    }
+
+    // 2. 移入全局资产并重映射资源间的引用；包对每个资源持有一份引用
+    // 同格式网格共享顶点/索引缓冲，减少VAO切换
+    GeometryPool::getInstance().setEnabled(true);
+
+    for (auto& [local, texture] : source.textures) {
+        TextureHandle handle = textureMap.at(local);
+        asset.textures.emplace(handle, std::move(texture));
+        acquireSlot(textureSlots, handle);
+        pack.textures.push_back(handle);
+    }
+
+    for (auto& [local, material] : source.materials) {
+        MaterialHandle handle = materialMap.at(local);
+        remap(textureMap, material.base_color_texture);
+        remap(textureMap, material.metallic_roughness_texture);
+        remap(textureMap, material.normal_texture);
+        remap(textureMap, material.occlusion_texture);
+        remap(textureMap, material.emissive_texture);
+        retainDependencies(material);
+        asset.materials.emplace(handle, std::move(material));
+        acquireSlot(materialSlots, handle);
+        pack.materials.push_back(handle);
+    }
+
+    for (auto& [local, mesh] : source.meshes) {
+        MeshHandle handle = meshMap.at(local);
+        for (auto& submesh : mesh.submeshes) {
+            submesh.material = remap(materialMap, submesh.material);
+        }
+        remap(skeletonMap, mesh.skeleton);
+        retainDependencies(mesh);
+        auto& stored = asset.meshes.emplace(handle, std::move(mesh)).first->second;
+        renderer.uploadMesh(stored);
+        acquireSlot(meshSlots, handle);
+        pack.meshes.push_back(handle);
+    }
+
+    // 骨架和动画容器会被动画工作线程读取
+    if (!source.skeletons.empty() || !source.animations.empty()) {
+        waitForAnimationTasks();
+    }
+
+    for (auto& [local, skeleton] : source.skeletons) {
+        SkeletonHandle handle = skeletonMap.at(local);
+        asset.skeletons.emplace(handle, std::move(skeleton));
+        acquireSlot(skeletonSlots, handle);
+        pack.skeletons.push_back(handle);
+    }
+
+    for (auto& [local, animation] : source.animations) {
+        AnimationHandle handle = animationMap.at(local);
+        remap(skeletonMap, animation.target_skeleton);
+        remap(meshMap, animation.target_mesh);
+        retainDependencies(animation);
+        asset.animations.emplace(handle, std::move(animation));
+        acquireSlot(animationSlots, handle);
+        pack.animations.push_back(handle);
+    }
+
+    // 3. 场景节点留在包内，只重映射句柄
+    pack.nodes = std::move(source.nodes);
+    pack.rootNodes = std::move(source.root_nodes);
+    for (auto& node : pack.nodes) {
+        remap(meshMap, node.mesh);
+        remap(skeletonMap, node.skeleton);
+    }
+
+    // 4. 纹理按句柄顺序排队到帧尾上传，新材质参与稠密索引编译
+    for (const auto& handle : pack.textures) {
+        renderer.queueTextureUpload(handle);
+    }
+    renderer.compileMaterials();
+
+    pack.state = PackState::READY;
+    std::cout << "资源包就绪: " << pack.path << " (网格 " << pack.meshes.size()
+              << ", 材质 " << pack.materials.size() << ", 纹理 " << pack.textures.size()
+              << ", 骨架 " << pack.skeletons.size() << ", 动画 " << pack.animations.size() << ")" << std::endl;
+}
+
+MeshHandle ResourceManager::addMesh(MeshData&& mesh) {
+    auto& renderer = Renderer::getInstance();
+    MeshHandle handle = meshSlots.allocate(0);
+    acquireSlot(meshSlots, handle);
+    retainDependencies(mesh);
+    auto& stored = renderer.getAsset().meshes.emplace(handle, std::move(mesh)).first->second;
+    renderer.uploadMesh(stored);
+    return handle;
+}
+
+// =========================================================================
+// 卸载和引用计数
+// =========================================================================
+
+void ResourceManager::unloadPack(PackHandle packHandle) {
+    if (!packSlots.find(packHandle)) {
+        return;
+    }
+
+    // 加载中的包直接作废，后台结果在整合时按句柄代际丢弃
+    Pack& pack = packs[packHandle.id - 1];
+    for (const auto& handle : pack.meshes) release(handle);
+    for (const auto& handle : pack.materials) release(handle);
+    for (const auto& handle : pack.textures) release(handle);
+    for (const auto& handle : pack.skeletons) release(handle);
+    for (const auto& handle : pack.animations) release(handle);
+
+    std::cout << "卸载资源包: " << pack.path << std::endl;
+    pack = Pack();
+    packSlots.free(packHandle);
+}
+
+ResourceManager::PackState ResourceManager::getPackState(PackHandle packHandle) const {
+    const Pack* pack = getPack(packHandle);
+    return pack ? pack->state : PackState::FAILED;
+}
+
+const ResourceManager::Pack* ResourceManager::getPack(PackHandle packHandle) const {
+    return packSlots.find(packHandle) ? &packs[packHandle.id - 1] : nullptr;
+}
+
+bool ResourceManager::acquire(MeshHandle handle) { return acquireSlot(meshSlots, handle); }
+bool ResourceManager::acquire(MaterialHandle handle) { return acquireSlot(materialSlots, handle); }
+bool ResourceManager::acquire(TextureHandle handle) { return acquireSlot(textureSlots, handle); }
+bool ResourceManager::acquire(SkeletonHandle handle) { return acquireSlot(skeletonSlots, handle); }
+bool ResourceManager::acquire(AnimationHandle handle) { return acquireSlot(animationSlots, handle); }
+
+void ResourceManager::release(MeshHandle handle) { releaseSlot(meshSlots, pendingMeshFrees, handle); }
+void ResourceManager::release(MaterialHandle handle) { releaseSlot(materialSlots, pendingMaterialFrees, handle); }
+void ResourceManager::release(TextureHandle handle) { releaseSlot(textureSlots, pendingTextureFrees, handle); }
+void ResourceManager::release(SkeletonHandle handle) { releaseSlot(skeletonSlots, pendingSkeletonFrees, handle); }
+void ResourceManager::release(AnimationHandle handle) { releaseSlot(animationSlots, pendingAnimationFrees, handle); }
+
+uint32_t ResourceManager::getRefCount(MeshHandle handle) const { return slotRefCount(meshSlots, handle); }
+uint32_t ResourceManager::getRefCount(MaterialHandle handle) const { return slotRefCount(materialSlots, handle); }
+uint32_t ResourceManager::getRefCount(TextureHandle handle) const { return slotRefCount(textureSlots, handle); }
+uint32_t ResourceManager::getRefCount(SkeletonHandle handle) const { return slotRefCount(skeletonSlots, handle); }
+uint32_t ResourceManager::getRefCount(AnimationHandle handle) const { return slotRefCount(animationSlots, handle); }
+
+void ResourceManager::retainDependencies(const MeshData& mesh) {
+    for (const auto& submesh : mesh.submeshes) {
+        acquire(submesh.material);
+    }
+    if (mesh.skeleton.has_value()) {
+        acquire(mesh.skeleton.value());
+    }
+}
+
+void ResourceManager::retainDependencies(const MaterialData& material) {
+    for (const auto* texture : {&material.base_color_texture, &material.metallic_roughness_texture,
+                                &material.normal_texture, &material.occlusion_texture, &material.emissive_texture}) {
+        if (texture->has_value()) {
+            acquire(texture->value());
+        }
+    }
+}
+
+void ResourceManager::retainDependencies(const AnimationData& animation) {
+    if (animation.target_skeleton.has_value()) {
+        acquire(animation.target_skeleton.value());
+    }
+    if (animation.target_mesh.has_value()) {
+        acquire(animation.target_mesh.value());
+    }
+}
+
+// =========================================================================
+// 帧尾整合和释放
+// =========================================================================
+
+void ResourceManager::endFrame() {
+    // 1. 每帧至多整合一个后台完成的包，把上传分摊到多帧
+    std::unique_ptr<LoadJob> job;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        if (!finishedJobs.empty()) {
+            job = std::move(finishedJobs.front());
+            finishedJobs.pop_front();
+        }
+    }
+    if (job && packSlots.find(job->pack)) {
+        if (job->succeeded) {
+            integrate(job->pack, *job->asset);
+        } else {
+            Pack& pack = packs[job->pack.id - 1];
+            pack.state = PackState::FAILED;
+            pack.error = job->error;
+            std::cerr << "加载资源包失败: " << pack.path << " - " << pack.error << std::endl;
+        }
+    }
+
+    // 2. 释放计数归零的资源；释放依赖可能让更多资源归零，循环到队列清空
+    bool materialsChanged = false;
+    auto collect = [](auto& table, auto& pending, auto&& freeFn) {
+        auto handles = std::move(pending);
+        pending.clear();
+        for (const auto& handle : handles) {
+            auto* slot = table.find(handle);
+            if (!slot || !slot->pendingFree) {
+                continue;
+            }
+            slot->pendingFree = false;
+            if (slot->refCount == 0) {
+                freeFn(handle);
+            }
+        }
+    };
+
+    // 动画任务只由主线程提交，帧尾等待一次即可
+    bool tasksDrained = false;
+    auto drainTasks = [&]() {
+        if (!tasksDrained) {
+            waitForAnimationTasks();
+            tasksDrained = true;
+        }
+    };
+
+    while (!pendingMeshFrees.empty() || !pendingMaterialFrees.empty() || !pendingTextureFrees.empty() ||
+           !pendingSkeletonFrees.empty() || !pendingAnimationFrees.empty()) {
+        materialsChanged = materialsChanged || !pendingMaterialFrees.empty() || !pendingTextureFrees.empty();
+
+        if (!pendingAnimationFrees.empty()) {
+            drainTasks();
+            collect(animationSlots, pendingAnimationFrees, [this](AnimationHandle h) { freeAnimation(h); });
+        }
+        collect(meshSlots, pendingMeshFrees, [this](MeshHandle h) { freeMesh(h); });
+        materialsChanged = materialsChanged || !pendingMaterialFrees.empty();
+        collect(materialSlots, pendingMaterialFrees, [this](MaterialHandle h) { freeMaterial(h); });
+        collect(textureSlots, pendingTextureFrees, [this](TextureHandle h) { freeTexture(h); });
+        if (!pendingSkeletonFrees.empty()) {
+            drainTasks();
+            collect(skeletonSlots, pendingSkeletonFrees, [this](SkeletonHandle h) { freeSkeleton(h); });
+        }
+    }
+
+    if (materialsChanged) {
+        // 材质稠密索引重新编译，已删除的纹理不再被状态块引用
+        Renderer::getInstance().compileMaterials();
+    }
+}
+
+void ResourceManager::freeMesh(MeshHandle handle) {
+    auto& renderer = Renderer::getInstance();
+    auto& meshes = renderer.getAsset().meshes;
+    auto it = meshes.find(handle);
+    if (it != meshes.end()) {
+        for (const auto& submesh : it->second.submeshes) {
+            release(submesh.material);
+        }
+        if (it->second.skeleton.has_value()) {
+            release(it->second.skeleton.value());
+        }
+        renderer.releaseMesh(it->second);
+        meshes.erase(it);
+    }
+    meshSlots.free(handle);
+    ++stats.freedResources;
+}
+
+void ResourceManager::freeMaterial(MaterialHandle handle) {
+    auto& materials = Renderer::getInstance().getAsset().materials;
+    auto it = materials.find(handle);
+    if (it != materials.end()) {
+        const auto& material = it->second;
+        for (const auto* texture : {&material.base_color_texture, &material.metallic_roughness_texture,
+                                    &material.normal_texture, &material.occlusion_texture, &material.emissive_texture}) {
+            if (texture->has_value()) {
+                release(texture->value());
+            }
+        }
+        materials.erase(it);
+    }
+    materialSlots.free(handle);
+    ++stats.freedResources;
+}
+
+void ResourceManager::freeTexture(TextureHandle handle) {
+    auto& renderer = Renderer::getInstance();
+    auto& textures = renderer.getAsset().textures;
+    auto it = textures.find(handle);
+    if (it != textures.end()) {
+        // 仍在上传队列中的句柄在tickTextureUploads里查找失败后跳过
+        renderer.releaseTexture(it->second);
+        textures.erase(it);
+    }
+    textureSlots.free(handle);
+    ++stats.freedResources;
+}
+
+void ResourceManager::freeSkeleton(SkeletonHandle handle) {
+    Renderer::getInstance().getAsset().skeletons.erase(handle);
+    skeletonSlots.free(handle);
+    ++stats.freedResources;
+}
+
+void ResourceManager::freeAnimation(AnimationHandle handle) {
+    auto& animations = Renderer::getInstance().getAsset().animations;
+    auto it = animations.find(handle);
+    if (it != animations.end()) {
+        if (it->second.target_skeleton.has_value()) {
+            release(it->second.target_skeleton.value());
+        }
+        if (it->second.target_mesh.has_value()) {
+            release(it->second.target_mesh.value());
+        }
+        animations.erase(it);
+    }
+    animationSlots.free(handle);
+    ++stats.freedResources;
+}
+
+void ResourceManager::waitForAnimationTasks() {
+    TaskSystem::getInstance().waitForAllPendingTasks();
+}
+
+// =========================================================================
+// 关闭和统计
+// =========================================================================
+
+void ResourceManager::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopWorker = true;
+    }
+    jobCondition.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+
+    std::lock_guard<std::mutex> lock(jobMutex);
+    queuedJobs.clear();
+    finishedJobs.clear();
+}
+
+const ResourceManager::Stats& ResourceManager::getStats() const {
+    stats.packs = packSlots.size();
+    stats.meshes = meshSlots.size();
+    stats.materials = materialSlots.size();
+    stats.textures = textureSlots.size();
+    stats.skeletons = skeletonSlots.size();
+    stats.animations = animationSlots.size();
+    stats.pendingFrees = static_cast<uint32_t>(pendingMeshFrees.size() + pendingMaterialFrees.size() +
+                                               pendingTextureFrees.size() + pendingSkeletonFrees.size() +
+                                               pendingAnimationFrees.size());
+    return stats;
+}
+
+void ResourceManager::printStats() const {
+    const Stats& current = getStats();
+    std::cout << "资源管理器: " << current.packs << " 个资源包" << std::endl;
+    std::cout << "  网格 " << current.meshes << ", 材质 " << current.materials
+              << ", 纹理 " << current.textures << ", 骨架 " << current.skeletons
+              << ", 动画 " << current.animations << std::endl;
+    std::cout << "  待释放 " << current.pendingFrees << ", 累计释放 " << current.freedResources << std::endl;
+}
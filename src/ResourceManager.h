@@ -0,0 +1,256 @@
+#pragma once
+
+#include "GltfTools/GltfTools.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace spartan::asset;
+
+// =========================================================================
+// 资源管理器 - 同时持有多个资源包，分配全局唯一的代际句柄
+// =========================================================================
+
+/**
+ * 稠密槽位表
+ * 句柄id为槽位下标+1，generation在槽位释放时递增，旧句柄查找时因代际不符而失效。
+ * 空闲槽位按后进先出复用，查找是一次下标访问加代际比较。
+ */
+template<typename Tag>
+class ResourceSlotTable {
+public:
+    struct Slot {
+        uint32_t generation = 1;
+        uint32_t refCount = 0;
+        uint32_t pack = 0;         // 所属资源包的槽位下标+1，0表示不属于任何包
+        bool alive = false;
+        bool pendingFree = false;  // 引用计数归零，等待帧尾释放
+    };
+
+    Handle<Tag> allocate(uint32_t pack) {
+        uint32_t index;
+        if (!freeList.empty()) {
+            index = freeList.back();
+            freeList.pop_back();
+        } else {
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        Slot& slot = slots[index];
+        slot.refCount = 0;
+        slot.pack = pack;
+        slot.alive = true;
+        slot.pendingFree = false;
+        ++liveCount;
+        return Handle<Tag>{index + 1, slot.generation};
+    }
+
+    void free(Handle<Tag> handle) {
+        Slot* slot = find(handle);
+        if (!slot) return;
+        slot->alive = false;
+        slot->pendingFree = false;
+        slot->refCount = 0;
+        ++slot->generation;
+        freeList.push_back(handle.id - 1);
+        --liveCount;
+    }
+
+    Slot* find(Handle<Tag> handle) {
+        if (handle.id == 0 || handle.id > slots.size()) return nullptr;
+        Slot& slot = slots[handle.id - 1];
+        return (slot.alive && slot.generation == handle.generation) ? &slot : nullptr;
+    }
+
+    const Slot* find(Handle<Tag> handle) const {
+        return const_cast<ResourceSlotTable*>(this)->find(handle);
+    }
+
+    uint32_t size() const { return liveCount; }
+    uint32_t capacity() const { return static_cast<uint32_t>(slots.size()); }
+
+private:
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeList;
+    uint32_t liveCount = 0;
+};
+
+/**
+ * 资源管理器
+ * 职责：加载多个资源包并把包内句柄重映射为全局句柄，资源统一存放在Renderer的资产中；
+ *      每个资源带引用计数，包自身持有一份引用，网格/材质/动画对其依赖（材质、纹理、骨架）各持一份，
+ *      由包创建的实体经ResourceReferenceComponent对所用网格/骨架/动画各持一份；
+ *      计数归零的资源在帧尾endFrame()统一释放GPU对象和CPU数据，绘制中的帧不会引用已删除的缓冲。
+ * 约定：所有接口只在主线程（GL线程）调用；异步加载只把解码放到后台线程，整合与上传仍在帧尾完成。
+ *      移除骨架/动画前等待动画任务完成，工作线程不会读到正在修改的容器。
+ */
+class ResourceManager {
+public:
+    static ResourceManager& getInstance() {
+        static ResourceManager instance;
+        return instance;
+    }
+
+    enum class PackState : uint8_t {
+        LOADING,   // 后台解码中或等待帧尾整合
+        READY,
+        FAILED,
+    };
+
+    /**
+     * 已加载的资源包：包内全部资源的全局句柄和场景节点（节点中的句柄已重映射）
+     */
+    struct Pack {
+        std::string path;
+        PackState state = PackState::LOADING;
+        std::string error;
+
+        std::vector<MeshHandle> meshes;
+        std::vector<MaterialHandle> materials;
+        std::vector<TextureHandle> textures;
+        std::vector<SkeletonHandle> skeletons;
+        std::vector<AnimationHandle> animations;
+
+        std::vector<SceneNode> nodes;
+        std::vector<int> rootNodes;
+    };
+
+    /**
+     * 资源统计
+     */
+    struct Stats {
+        uint32_t packs = 0;
+        uint32_t meshes = 0;
+        uint32_t materials = 0;
+        uint32_t textures = 0;
+        uint32_t skeletons = 0;
+        uint32_t animations = 0;
+        uint32_t pendingFrees = 0;     // 等待帧尾释放的资源
+        uint32_t freedResources = 0;   // 累计释放的资源
+    };
+
+    /**
+     * 同步加载资源包（经AssetCache整体反序列化，不经AssetPackReader按需加载），立即整合并上传网格
+     * @return 失败返回无效句柄，错误见getLastError()
+     */
+    PackHandle loadPack(const char* gltfPath);
+
+    /**
+     * 异步加载：后台线程解码，完成后在某次endFrame()中整合（每帧至多一个包）
+     * @return 包句柄，状态为LOADING，可用getPackState()轮询
+     */
+    PackHandle loadPackAsync(const char* gltfPath);
+
+    /**
+     * 卸载资源包：释放包持有的引用，仍被外部引用的资源在引用释放后才回收
+     */
+    void unloadPack(PackHandle pack);
+
+    PackState getPackState(PackHandle pack) const;
+    const Pack* getPack(PackHandle pack) const;
+
+    // 引用计数：acquire成功返回true；release到零的资源排队到帧尾释放
+    bool acquire(MeshHandle handle);
+    bool acquire(MaterialHandle handle);
+    bool acquire(TextureHandle handle);
+    bool acquire(SkeletonHandle handle);
+    bool acquire(AnimationHandle handle);
+    void release(MeshHandle handle);
+    void release(MaterialHandle handle);
+    void release(TextureHandle handle);
+    void release(SkeletonHandle handle);
+    void release(AnimationHandle handle);
+
+    uint32_t getRefCount(MeshHandle handle) const;
+    uint32_t getRefCount(MaterialHandle handle) const;
+    uint32_t getRefCount(TextureHandle handle) const;
+    uint32_t getRefCount(SkeletonHandle handle) const;
+    uint32_t getRefCount(AnimationHandle handle) const;
+    bool isAlive(MeshHandle handle) const { return meshSlots.find(handle) != nullptr; }
+    bool isAlive(SkeletonHandle handle) const { return skeletonSlots.find(handle) != nullptr; }
+    bool isAlive(AnimationHandle handle) const { return animationSlots.find(handle) != nullptr; }
+
+    /**
+     * 注册运行时生成的网格（如静态合批结果），上传GPU并返回持有一份引用的句柄，
+     * 调用方不再使用时release（或交给实体的ResourceReferenceComponent）
+     */
+    MeshHandle addMesh(MeshData&& mesh);
+
+    /**
+     * 帧尾调用：整合至多一个异步完成的包，并释放引用计数归零的资源
+     */
+    void endFrame();
+
+    /**
+     * 停止后台线程并丢弃未整合的加载结果（资源的GPU对象由Renderer::cleanup统一删除）
+     */
+    void shutdown();
+
+    const Stats& getStats() const;
+    const std::string& getLastError() const { return lastError; }
+    void printStats() const;
+
+private:
+    ResourceManager() = default;
+    ~ResourceManager() { shutdown(); }
+
+    struct LoadJob {
+        PackHandle pack;
+        std::string path;
+        std::unique_ptr<ProcessedAsset> asset;
+        bool succeeded = false;
+        std::string error;
+    };
+
+    static ProcessConfig makeRuntimeConfig();
+
+    // 把解码好的资产并入Renderer的资产：分配全局句柄、重映射引用、上传网格、排队纹理
+    void integrate(PackHandle packHandle, ProcessedAsset& source);
+
+    void retainDependencies(const MeshData& mesh);
+    void retainDependencies(const MaterialData& material);
+    void retainDependencies(const AnimationData& animation);
+
+    // 释放一个计数归零的资源：先释放其依赖，再删除GPU对象和CPU数据，最后回收槽位
+    void freeMesh(MeshHandle handle);
+    void freeMaterial(MaterialHandle handle);
+    void freeTexture(TextureHandle handle);
+    void freeSkeleton(SkeletonHandle handle);
+    void freeAnimation(AnimationHandle handle);
+
+    // 移除骨架/动画前确保动画工作线程没有在读容器
+    void waitForAnimationTasks();
+
+    void workerLoop();
+
+    ResourceSlotTable<MeshTag> meshSlots;
+    ResourceSlotTable<MaterialTag> materialSlots;
+    ResourceSlotTable<TextureTag> textureSlots;
+    ResourceSlotTable<SkeletonTag> skeletonSlots;
+    ResourceSlotTable<AnimationTag> animationSlots;
+    ResourceSlotTable<PackTag> packSlots;
+    std::vector<Pack> packs;  // 与packSlots的槽位一一对应
+
+    // 计数归零、等待帧尾释放的资源
+    std::vector<MeshHandle> pendingMeshFrees;
+    std::vector<MaterialHandle> pendingMaterialFrees;
+    std::vector<TextureHandle> pendingTextureFrees;
+    std::vector<SkeletonHandle> pendingSkeletonFrees;
+    std::vector<AnimationHandle> pendingAnimationFrees;
+
+    // 后台解码
+    std::thread worker;
+    std::mutex jobMutex;
+    std::condition_variable jobCondition;
+    std::deque<std::unique_ptr<LoadJob>> queuedJobs;
+    std::deque<std::unique_ptr<LoadJob>> finishedJobs;
+    bool stopWorker = false;
+
+    mutable Stats stats;
+    std::string lastError;
+};
@@ -0,0 +1,366 @@
+#include "ShaderCache.h"
+#include "RenderDevice.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+    // FNV-1a 64位哈希
+    constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    uint64_t hashString(uint64_t hash, const std::string& str) {
+        // 把长度也计入，避免拼接歧义
+        uint64_t length = str.size();
+        hash = hashBytes(hash, &length, sizeof(length));
+        return hashBytes(hash, str.data(), str.size());
+    }
+
+    const char* glString(GLenum name) {
+        const GLubyte* str = glGetString(name);
+        return str ? reinterpret_cast<const char*>(str) : "";
+    }
+
+    struct VariantDefine {
+        uint32_t flag;
+        const char* define;
+    };
+
+    constexpr VariantDefine VARIANT_DEFINES[] = {
+            {SHADER_VARIANT_SKINNING,      "#define VARIANT_SKINNING 1\n"},
+            {SHADER_VARIANT_INSTANCING,    "#define VARIANT_INSTANCING 1\n"},
+            {SHADER_VARIANT_DEBUG_WEIGHTS, "#define VARIANT_DEBUG_WEIGHTS 1\n"},
+    };
+
+} // namespace
+
+// =========================================================================
+// ShaderCache 实现
+// =========================================================================
+
+bool ShaderCache::initialize(const std::string& directory) {
+    if (isInitialized) {
+        return true;
+    }
+
+    cacheDirectory = directory;
+    driverSignature = std::string(glString(GL_RENDERER)) + "|" + glString(GL_VERSION);
+
+    // WebGL2等环境不提供任何二进制格式，此时只做源码编译
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    binarySupported = formatCount > 0;
+
+    if (binarySupported) {
+        std::error_code ec;
+        std::filesystem::create_directories(cacheDirectory, ec);
+        if (ec) {
+            std::cerr << "着色器缓存目录创建失败: " << cacheDirectory << " (" << ec.message() << ")" << std::endl;
+            binarySupported = false;
+        }
+    }
+
+    std::cout << "着色器二进制缓存: " << (binarySupported ? "启用" : "不可用")
+              << "，支持格式数量: " << formatCount << std::endl;
+
+    isInitialized = true;
+    return true;
+}
+
+GLuint ShaderCache::getOrCreateProgram(const char* vertexSource, const char* fragmentSource,
+                                       uint32_t variantFlags) {
+    if (!isInitialized) {
+        initialize();
+    }
+
+    std::string vs = applyVariantDefines(vertexSource, variantFlags);
+    std::string fs = applyVariantDefines(fragmentSource, variantFlags);
+    uint64_t key = computeKey(vs, fs, variantFlags);
+
+    auto it = programs.find(key);
+    if (it != programs.end()) {
+        return it->second;
+    }
+
+    GLuint program = 0;
+    if (binarySupported) {
+        program = loadBinary(key);
+    }
+
+    if (program == 0) {
+        program = compileFromSource(vs, fs);
+        if (program == 0) {
+            return 0;
+        }
+        if (binarySupported) {
+            saveBinary(key, program);
+        }
+    }
+
+    programs[key] = program;
+    return program;
+}
+
+void ShaderCache::queueWarmup(const char* vertexSource, const char* fragmentSource, uint32_t variantFlags) {
+    WarmupRequest request;
+    request.vertexSource = vertexSource;
+    request.fragmentSource = fragmentSource;
+    request.variantFlags = variantFlags;
+    warmupQueue.push_back(std::move(request));
+}
+
+uint32_t ShaderCache::tickWarmup(float budgetMs) {
+    if (warmupQueue.empty()) {
+        return 0;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    uint32_t compiled = 0;
+
+    // 链接是不可分割的，所以至少处理一个，之后按预算继续
+    while (!warmupQueue.empty()) {
+        WarmupRequest request = std::move(warmupQueue.front());
+        warmupQueue.pop_front();
+
+        if (getOrCreateProgram(request.vertexSource.c_str(), request.fragmentSource.c_str(),
+                               request.variantFlags) != 0) {
+            compiled++;
+            stats.warmupCompiled++;
+        }
+
+        float elapsedMs = std::chrono::duration<float, std::milli>(
+                std::chrono::high_resolution_clock::now() - start).count();
+        if (elapsedMs >= budgetMs) {
+            break;
+        }
+    }
+
+    if (warmupQueue.empty()) {
+        std::cout << "着色器预热完成" << std::endl;
+        printStats();
+    }
+
+    return compiled;
+}
+
+void ShaderCache::printStats() const {
+    std::cout << "着色器缓存统计: 二进制命中 " << stats.binaryHits
+              << ", 拒绝 " << stats.binaryRejected
+              << ", 源码编译 " << stats.sourceCompiles
+              << ", 写回 " << stats.binarySaved
+              << ", 预热 " << stats.warmupCompiled
+              << ", 待预热 " << warmupQueue.size() << std::endl;
+}
+
+void ShaderCache::cleanup() {
+    for (auto& [key, program] : programs) {
+        if (program) {
+            glDeleteProgram(program);
+        }
+    }
+    programs.clear();
+    warmupQueue.clear();
+    isInitialized = false;
+}
+
+uint64_t ShaderCache::computeKey(const std::string& vertexSource, const std::string& fragmentSource,
+                                 uint32_t variantFlags) const {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hash = hashString(hash, vertexSource);
+    hash = hashString(hash, fragmentSource);
+    hash = hashBytes(hash, &variantFlags, sizeof(variantFlags));
+    hash = hashString(hash, driverSignature);
+    return hash;
+}
+
+std::string ShaderCache::applyVariantDefines(const char* source, uint32_t variantFlags) {
+    std::string result(source ? source : "");
+    if (variantFlags == SHADER_VARIANT_NONE) {
+        return result;
+    }
+
+    std::string defines;
+    for (const auto& variant : VARIANT_DEFINES) {
+        if (variantFlags & variant.flag) {
+            defines += variant.define;
+        }
+    }
+
+    // #version必须是第一行，宏插在它后面
+    size_t lineEnd = result.find('\n');
+    if (lineEnd == std::string::npos) {
+        result += '\n';
+        lineEnd = result.size() - 1;
+    }
+    result.insert(lineEnd + 1, defines);
+    return result;
+}
+
+GLuint ShaderCache::loadBinary(uint64_t key) {
+    std::ifstream file(getCachePath(key), std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return 0;
+    }
+
+    std::streamsize fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    BinaryFileHeader header;
+    bool valid = fileSize >= static_cast<std::streamsize>(sizeof(header)) &&
+                 file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+                 header.magic == BinaryFileHeader::MAGIC &&
+                 header.version == BinaryFileHeader::VERSION &&
+                 header.key == key &&
+                 header.binaryLength > 0 &&
+                 fileSize == static_cast<std::streamsize>(sizeof(header) + header.binaryLength);
+
+    std::vector<char> binary;
+    if (valid) {
+        binary.resize(header.binaryLength);
+        valid = static_cast<bool>(file.read(binary.data(), header.binaryLength));
+    }
+    file.close();
+
+    if (!valid) {
+        std::cerr << "着色器缓存文件无效，回退到源码编译: " << getCachePath(key) << std::endl;
+        std::remove(getCachePath(key).c_str());
+        stats.binaryRejected++;
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // 驱动可以在任何时候拒绝旧二进制，以链接状态为准
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        std::cerr << "驱动拒绝着色器二进制，回退到源码编译" << std::endl;
+        glDeleteProgram(program);
+        std::remove(getCachePath(key).c_str());
+        stats.binaryRejected++;
+        return 0;
+    }
+
+    stats.binaryHits++;
+    return program;
+}
+
+GLuint ShaderCache::compileFromSource(const std::string& vertexSource, const std::string& fragmentSource) {
+    auto& device = RenderDevice::getInstance();
+    const char* vsSource = vertexSource.c_str();
+    const char* fsSource = fragmentSource.c_str();
+
+    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &vsSource, nullptr);
+    glCompileShader(vertexShader);
+
+    if (!device.checkShaderCompile(vertexShader, "顶点着色器")) {
+        glDeleteShader(vertexShader);
+        return 0;
+    }
+
+    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fsSource, nullptr);
+    glCompileShader(fragmentShader);
+
+    if (!device.checkShaderCompile(fragmentShader, "片段着色器")) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    if (binarySupported) {
+        // 必须在链接前设置，否则部分驱动返回空二进制
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(program);
+
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        char infoLog[512];
+        glGetProgramInfoLog(program, 512, nullptr, infoLog);
+        std::cerr << "着色器程序链接失败: " << infoLog << std::endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    stats.sourceCompiles++;
+    return program;
+}
+
+void ShaderCache::saveBinary(uint64_t key, GLuint program) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLsizei written = 0;
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) {
+        return;
+    }
+
+    BinaryFileHeader header;
+    header.key = key;
+    header.binaryFormat = format;
+    header.binaryLength = static_cast<uint32_t>(written);
+
+    // 先写临时文件再改名，避免中途退出留下半截缓存
+    std::string path = getCachePath(key);
+    std::string tempPath = path + ".tmp";
+    bool writeOk = false;
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "无法写入着色器缓存: " << tempPath << std::endl;
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+        writeOk = static_cast<bool>(file);
+    }
+    if (!writeOk) {
+        // 文件关闭后再删除半截的临时文件
+        std::cerr << "写入着色器缓存失败: " << tempPath << std::endl;
+        std::remove(tempPath.c_str());
+        return;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::remove(tempPath.c_str());
+        return;
+    }
+
+    stats.binarySaved++;
+}
+
+std::string ShaderCache::getCachePath(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return cacheDirectory + "/" + name;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "glad/glad.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// =========================================================================
+// 着色器程序二进制缓存 - 基于GLES 3.0核心的glGetProgramBinary/glProgramBinary
+// =========================================================================
+
+/**
+ * 着色器变体标志
+ * 每个置位的标志在#version行之后展开为一条#define，参与缓存键计算
+ */
+enum ShaderVariantFlags : uint32_t {
+    SHADER_VARIANT_NONE = 0,
+    SHADER_VARIANT_SKINNING = 1u << 0,
+    SHADER_VARIANT_INSTANCING = 1u << 1,
+    SHADER_VARIANT_DEBUG_WEIGHTS = 1u << 2,
+};
+
+/**
+ * 程序二进制缓存
+ * 职责：以(源码, 变体标志, GL_RENDERER, GL_VERSION)的哈希为键，
+ *      把链接好的程序二进制存到磁盘，下次启动直接glProgramBinary加载；
+ *      加载失败（驱动升级、文件损坏）时回退到源码编译并重写缓存。
+ */
+class ShaderCache {
+public:
+    static ShaderCache& getInstance() {
+        static ShaderCache instance;
+        return instance;
+    }
+
+    /**
+     * 缓存统计
+     */
+    struct CacheStats {
+        uint32_t binaryHits = 0;       // 从磁盘二进制加载成功
+        uint32_t binaryRejected = 0;   // 磁盘二进制被驱动拒绝或校验失败
+        uint32_t sourceCompiles = 0;   // 从源码编译
+        uint32_t binarySaved = 0;      // 写回磁盘的二进制数量
+        uint32_t warmupCompiled = 0;   // 预热阶段完成的程序数量
+    };
+
+    /**
+     * 初始化缓存（需要在GL上下文创建之后调用）
+     * @param directory 缓存文件目录
+     */
+    bool initialize(const std::string& directory = "shader_cache");
+
+    /**
+     * 获取或创建着色器程序，优先从二进制缓存加载
+     * @param vertexSource 顶点着色器源码（首行必须是#version）
+     * @param fragmentSource 片段着色器源码（首行必须是#version）
+     * @param variantFlags 变体标志
+     * @return 程序ID，失败返回0
+     */
+    GLuint getOrCreateProgram(const char* vertexSource, const char* fragmentSource,
+                              uint32_t variantFlags = SHADER_VARIANT_NONE);
+
+    /**
+     * 将变体加入后台预热队列，由tickWarmup分摊到后续若干帧
+     */
+    void queueWarmup(const char* vertexSource, const char* fragmentSource, uint32_t variantFlags);
+
+    /**
+     * 每帧调用一次，在时间预算内编译队列中的变体
+     * @param budgetMs 本帧允许的预热耗时（毫秒），至少处理一个变体
+     * @return 本帧完成的变体数量
+     */
+    uint32_t tickWarmup(float budgetMs);
+
+    bool hasPendingWarmup() const { return !warmupQueue.empty(); }
+    const CacheStats& getStats() const { return stats; }
+    void printStats() const;
+
+    /**
+     * 删除所有由缓存创建的程序
+     */
+    void cleanup();
+
+private:
+    ShaderCache() = default;
+    ~ShaderCache() = default;
+
+    // 磁盘文件头
+    struct BinaryFileHeader {
+        static constexpr uint32_t MAGIC = 0x43425053; // 'SPBC'
+        static constexpr uint32_t VERSION = 1;
+
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint64_t key = 0;
+        uint32_t binaryFormat = 0;
+        uint32_t binaryLength = 0;
+    };
+
+    struct WarmupRequest {
+        std::string vertexSource;
+        std::string fragmentSource;
+        uint32_t variantFlags = 0;
+    };
+
+    uint64_t computeKey(const std::string& vertexSource, const std::string& fragmentSource,
+                        uint32_t variantFlags) const;
+    static std::string applyVariantDefines(const char* source, uint32_t variantFlags);
+
+    GLuint loadBinary(uint64_t key);
+    GLuint compileFromSource(const std::string& vertexSource, const std::string& fragmentSource);
+    void saveBinary(uint64_t key, GLuint program);
+    std::string getCachePath(uint64_t key) const;
+
+    std::string cacheDirectory;
+    std::string driverSignature;    // GL_RENDERER + GL_VERSION
+    bool binarySupported = false;   // GL_NUM_PROGRAM_BINARY_FORMATS > 0
+    bool isInitialized = false;
+
+    std::unordered_map<uint64_t, GLuint> programs;  // key -> program
+    std::deque<WarmupRequest> warmupQueue;
+    CacheStats stats;
+};
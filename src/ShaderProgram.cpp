@@ -0,0 +1,147 @@
+#include "ShaderProgram.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+    // 与UniformId一一对应
+    constexpr const char* UNIFORM_NAMES[] = {
+            "uModel",
+            "uBoneTexture",
+            "uUseSkinning",
+            "uUseInstancing",
+            "uBoneOffset",
+            "uBaseColorTexture",
+            "uBaseColorFactor",
+            "uDebugWeights",
+            "uVertexQuantized",
+            "uPositionOffset",
+            "uPositionScale",
+    };
+
+    static_assert(sizeof(UNIFORM_NAMES) / sizeof(UNIFORM_NAMES[0]) == static_cast<size_t>(UniformId::Count),
+                  "UNIFORM_NAMES必须与UniformId保持一致");
+
+} // namespace
+
+const char* getUniformName(UniformId id) {
+    size_t index = static_cast<size_t>(id);
+    return index < static_cast<size_t>(UniformId::Count) ? UNIFORM_NAMES[index] : "";
+}
+
+// =========================================================================
+// ShaderProgram 实现
+// =========================================================================
+
+bool ShaderProgram::reflect(GLuint programId) {
+    reset();
+    if (programId == 0) {
+        return false;
+    }
+    program = programId;
+
+    GLint activeCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &activeCount);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::vector<GLchar> nameBuffer(static_cast<size_t>(std::max(maxNameLength, 1)));
+    uniforms.reserve(static_cast<size_t>(activeCount));
+
+    for (GLint i = 0; i < activeCount; ++i) {
+        GLsizei length = 0;
+        UniformInfo info;
+        glGetActiveUniform(program, static_cast<GLuint>(i), static_cast<GLsizei>(nameBuffer.size()),
+                           &length, &info.size, &info.type, nameBuffer.data());
+
+        info.name.assign(nameBuffer.data(), static_cast<size_t>(length));
+        if (info.name.size() > 3 && info.name.compare(info.name.size() - 3, 3, "[0]") == 0) {
+            info.name.resize(info.name.size() - 3);
+        }
+        info.location = glGetUniformLocation(program, info.name.c_str());
+        uniforms.push_back(std::move(info));
+    }
+
+    // 每帧常量块：所有程序共享同一个绑定点
+    GLuint blockIndex = glGetUniformBlockIndex(program, FRAME_CONSTANTS_BLOCK_NAME);
+    if (blockIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, blockIndex, FRAME_CONSTANTS_BINDING);
+    }
+
+    // 把引擎已知的uniform映射到反射表
+    for (size_t id = 0; id < locations.size(); ++id) {
+        int index = findUniform(UNIFORM_NAMES[id]);
+        if (index >= 0) {
+            locations[id] = uniforms[index].location;
+        }
+    }
+
+    std::cout << "着色器程序 " << program << " 反射到 " << uniforms.size() << " 个活动uniform" << std::endl;
+    return true;
+}
+
+void ShaderProgram::reset() {
+    program = 0;
+    uniforms.clear();
+    locations.fill(-1);
+    for (auto& shadow : shadows) {
+        shadow.valid = false;
+        shadow.size = 0;
+    }
+    stats = UniformStats{};
+}
+
+int ShaderProgram::findUniform(const char* name) const {
+    for (size_t i = 0; i < uniforms.size(); ++i) {
+        if (uniforms[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool ShaderProgram::updateShadow(UniformId id, const void* data, size_t size) {
+    auto& shadow = shadows[static_cast<size_t>(id)];
+    if (shadow.valid && shadow.size == size && std::memcmp(shadow.data, data, size) == 0) {
+        stats.skipped++;
+        return false;
+    }
+
+    std::memcpy(shadow.data, data, size);
+    shadow.size = static_cast<uint8_t>(size);
+    shadow.valid = true;
+    stats.uploads++;
+    return true;
+}
+
+void ShaderProgram::setInt(UniformId id, int value) {
+    GLint location = getLocation(id);
+    if (location == -1 || !updateShadow(id, &value, sizeof(value))) return;
+    glUniform1i(location, value);
+}
+
+void ShaderProgram::setFloat(UniformId id, float value) {
+    GLint location = getLocation(id);
+    if (location == -1 || !updateShadow(id, &value, sizeof(value))) return;
+    glUniform1f(location, value);
+}
+
+void ShaderProgram::setVec3(UniformId id, const glm::vec3& value) {
+    GLint location = getLocation(id);
+    if (location == -1 || !updateShadow(id, glm::value_ptr(value), sizeof(value))) return;
+    glUniform3fv(location, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::setVec4(UniformId id, const glm::vec4& value) {
+    GLint location = getLocation(id);
+    if (location == -1 || !updateShadow(id, glm::value_ptr(value), sizeof(value))) return;
+    glUniform4fv(location, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::setMat4(UniformId id, const glm::mat4& value) {
+    GLint location = getLocation(id);
+    if (location == -1 || !updateShadow(id, glm::value_ptr(value), sizeof(value))) return;
+    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
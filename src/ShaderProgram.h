@@ -0,0 +1,144 @@
+#pragma once
+
+#include "glad/glad.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// =========================================================================
+// 着色器程序对象 - 链接后一次性反射uniform，按整数ID访问并消除冗余上传
+// =========================================================================
+
+/**
+ * 引擎已知的uniform标识
+ * 渲染指令直接携带这个ID，不再在每次绘制时按字符串查询location
+ */
+enum class UniformId : uint8_t {
+    Model,
+    BoneTexture,
+    UseSkinning,
+    UseInstancing,
+    BoneOffset,
+    BaseColorTexture,
+    BaseColorFactor,
+    DebugWeights,
+    VertexQuantized,
+    PositionOffset,
+    PositionScale,
+    Count
+};
+
+/**
+ * 获取uniform在GLSL中的名字
+ */
+const char* getUniformName(UniformId id);
+
+// =========================================================================
+// 每帧常量UBO - std140布局，与着色器中的FrameConstants块逐字节对应
+// =========================================================================
+
+/**
+ * 帧常量块的名字和绑定点
+ * GLES 3.0不支持layout(binding=)，链接后通过glUniformBlockBinding绑定
+ */
+constexpr const char* FRAME_CONSTANTS_BLOCK_NAME = "FrameConstants";
+constexpr GLuint FRAME_CONSTANTS_BINDING = 0;
+
+struct FrameConstants {
+    static constexpr int MAX_LIGHTS = 4;
+
+    struct Light {
+        glm::vec4 direction{0.0f, -1.0f, 0.0f, 1.0f};  // xyz光线方向, w强度
+        glm::vec4 color{1.0f};                          // rgb颜色
+    };
+
+    glm::mat4 viewProjection{1.0f};
+    glm::mat4 view{1.0f};
+    glm::vec4 viewPos{0.0f};      // xyz相机位置
+    glm::vec4 time{0.0f};         // x总时间(秒), y帧间隔(秒)
+    glm::ivec4 lightCount{0};     // x方向光数量
+    Light lights[MAX_LIGHTS];
+};
+
+static_assert(sizeof(FrameConstants) == 64 * 2 + 16 * 3 + 32 * FrameConstants::MAX_LIGHTS,
+              "FrameConstants必须满足std140布局");
+
+class ShaderProgram {
+public:
+    /**
+     * 反射得到的活动uniform信息
+     */
+    struct UniformInfo {
+        std::string name;     // 数组会去掉末尾的[0]
+        GLint location = -1;  // uniform block成员为-1
+        GLenum type = 0;
+        GLint size = 0;
+    };
+
+    /**
+     * uniform上传统计
+     */
+    struct UniformStats {
+        uint32_t uploads = 0;   // 实际调用glUniform*的次数
+        uint32_t skipped = 0;   // 值未变化而跳过的次数
+    };
+
+    /**
+     * 反射程序的所有活动uniform（链接或加载二进制后调用一次），
+     * 同时把FrameConstants块绑定到FRAME_CONSTANTS_BINDING
+     * @param programId 已链接的程序
+     */
+    bool reflect(GLuint programId);
+
+    /**
+     * 清空反射结果和影子值（不删除GL程序，程序归ShaderCache所有）
+     */
+    void reset();
+
+    GLuint getProgram() const { return program; }
+    // 越界的id（如默认值UniformId::Count）视为不存在，setter和hasUniform都依赖这里的检查
+    GLint getLocation(UniformId id) const {
+        size_t index = static_cast<size_t>(id);
+        return index < static_cast<size_t>(UniformId::Count) ? locations[index] : -1;
+    }
+    bool hasUniform(UniformId id) const { return getLocation(id) != -1; }
+    const std::vector<UniformInfo>& getUniforms() const { return uniforms; }
+
+    /**
+     * 按名字查找反射表中的uniform（仅用于工具和调试，不要在绘制路径中调用）
+     * @return 在getUniforms()中的索引，未找到返回-1
+     */
+    int findUniform(const char* name) const;
+
+    // 设置uniform（调用方保证该程序当前已绑定），值未变化时跳过GL调用
+    void setInt(UniformId id, int value);
+    void setFloat(UniformId id, float value);
+    void setVec3(UniformId id, const glm::vec3& value);
+    void setVec4(UniformId id, const glm::vec4& value);
+    void setMat4(UniformId id, const glm::mat4& value);
+
+    const UniformStats& getStats() const { return stats; }
+    void resetStats() { stats = UniformStats{}; }
+
+private:
+    // CPU侧影子值，按最大的mat4分配
+    struct ShadowValue {
+        alignas(16) uint8_t data[sizeof(glm::mat4)];
+        uint8_t size = 0;
+        bool valid = false;
+    };
+
+    /**
+     * 比较并更新影子值
+     * @return 需要上传返回true
+     */
+    bool updateShadow(UniformId id, const void* data, size_t size);
+
+    GLuint program = 0;
+    std::vector<UniformInfo> uniforms;
+    std::array<GLint, static_cast<size_t>(UniformId::Count)> locations{};
+    std::array<ShadowValue, static_cast<size_t>(UniformId::Count)> shadows{};
+    UniformStats stats;
+};
@@ -1,10 +1,17 @@
 // SimpleApp.cpp - 使用插件式架构的渲染引擎示例
 #include "Core.h"
 #include "RenderDevice.h"
+#include "ShaderCache.h"
 #include "Renderer.h"
+#include "ResourceManager.h"
 #include "RenderPipeline.h"
 #include "RenderWorld.h"
 #include "EntityComponents.h"
+#include "StaticBatcher.h"
+#include "GltfTools/MeshOptimizer.h"
+#include "GltfTools/StreamFilter.h"
+#include "GltfTools/SlotMap.h"
+#include <cstring>
 
 class SimpleApplication {
 private:
@@ -14,11 +21,20 @@ private:
     // 核心组件引用
     Renderer& renderer = Renderer::getInstance();
     RenderPipeline& pipeline = RenderPipeline::getInstance();
+    ResourceManager& resources = ResourceManager::getInstance();
+
+    // 场景使用的资源包
+    PackHandle modelPack;
 
     // 新的插件式系统管理器
     std::unique_ptr<RenderWorld> renderWorld;
 
+    // 是否在场景创建后合并静态网格（--static-batch）
+    bool staticBatching = false;
+
 public:
+    void setStaticBatching(bool enabled) { staticBatching = enabled; }
+
     bool initialize() {
         std::cout << "=== 初始化插件式渲染应用程序 ===" << std::endl;
 
@@ -33,7 +49,8 @@ public:
                              "art/AnimatedCube/glTF/AnimatedCube.gltf", //纯节点测试
                              "art/robot/glTF/robot.gltf" //蒙皮+节点测试
                              };
-        if (!renderer.loadAsset(modelPath[0].c_str())) {
+        modelPack = resources.loadPack(modelPath[0].c_str());
+        if (!modelPack.IsValid()) {
             std::cerr << "模型加载失败" << std::endl;
             return false;
         }
@@ -69,8 +86,7 @@ public:
         std::cout << "创建输入处理器: " << static_cast<uint32_t>(inputHandler) << std::endl;
 
         // 创建动画模型
-        auto modelEntities = EntityFactory::createAnimatedModelFromAsset(
-                registry, renderer.getAsset(), 0);
+        auto modelEntities = EntityFactory::createAnimatedModelFromPack(registry, modelPack, 0);
         std::cout << "创建了 " << modelEntities.size() << " 个模型实体" << std::endl;
 
         // 查找并配置模型根节点
@@ -96,6 +112,17 @@ public:
             transformSystem->invalidateCache();
         }
 
+        // 静态合批需要世界矩阵，先让变换系统计算一次；
+        // 合批器从网格的CPU数据读取顶点：缓存命中时网格零拷贝加载、上传后只剩GPU数据，会被跳过，
+        // 只有首次处理glTF（缓存未命中）得到的网格能参与合批
+        if (staticBatching) {
+            if (auto* transformSystem = renderWorld->getSystem<ITransformSystem>()) {
+                transformSystem->update(registry, 0.0f);
+            }
+            auto& asset = renderer.getAsset();
+            StaticBatcher::build(registry, StaticBatcher::collectStaticEntities(registry, asset), asset);
+        }
+
         // 设置默认光照
         if (auto* lightManager = renderWorld->getSystem<ILightManager>()) {
             lightManager->addDirectionalLight(
@@ -161,11 +188,45 @@ private:
         // 处理渲染队列
         pipeline.processRenderQueue();
 
+        // 利用帧尾空闲时间预热剩余着色器变体
+        ShaderCache::getInstance().tickWarmup(2.0f);
+
+        // 分帧上传解码好的纹理，避免加载后第一帧长时间卡顿
+        renderer.tickTextureUploads(4 * 1024 * 1024);
+
+        // 整合后台加载完成的资源包，回收引用计数归零的资源
+        resources.endFrame();
+
         // 交换缓冲区
         SDL_GL_SwapWindow(RenderDevice::getInstance().getWindow());
     }
 
 public:
+    /**
+     * 卸载检查：卸载资源包并销毁所有实体后，网格（含静态合批生成的网格）、材质和纹理应全部回收
+     */
+    bool checkUnload() {
+        std::vector<MeshHandle> batchMeshes;
+        auto batchView = registry.view<StaticBatchComponent, MeshComponent>();
+        for (auto entity : batchView) {
+            batchMeshes.push_back(batchView.get<MeshComponent>(entity).handle);
+        }
+
+        resources.unloadPack(modelPack);
+        registry.clear();
+        resources.endFrame();
+
+        const auto& stats = resources.getStats();
+        bool ok = stats.meshes == 0 && stats.materials == 0 && stats.textures == 0;
+        for (auto handle : batchMeshes) {
+            ok = ok && !resources.isAlive(handle);
+        }
+        std::cout << "卸载检查: 合批网格 " << batchMeshes.size() << " 个, 剩余网格 " << stats.meshes
+                  << ", 材质 " << stats.materials << ", 纹理 " << stats.textures
+                  << (ok ? " [通过]" : " [未回收]") << std::endl;
+        return ok;
+    }
+
     void shutdown() {
         std::cout << "=== 安全清理VTF渲染应用程序 ===" << std::endl;
 
@@ -175,6 +236,7 @@ public:
             auto& instancedMesh = instancedView.get<InstancedMeshComponent>(entity);
             if (instancedMesh.instanceBuffer != 0) {
                 glDeleteBuffers(1, &instancedMesh.instanceBuffer);
+                RenderDevice::getInstance().getStateCache().onBufferDeleted(instancedMesh.instanceBuffer);
                 instancedMesh.instanceBuffer = 0;
             }
         }
@@ -186,6 +248,7 @@ public:
         }
 
         // 3. 【关键】手动清理渲染器资源，避免静态析构问题
+        resources.shutdown();
         renderer.cleanup();
 
         // 4. 清理ECS注册表
@@ -265,12 +328,51 @@ public:
 
 // 主函数
 int main(int argc, char* argv[]) {
+    // 离线基准，不创建窗口
+    if (argc > 1 && std::strcmp(argv[1], "--bench-vcache") == 0) {
+        spartan::asset::RunVertexCacheBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-dedup") == 0) {
+        spartan::asset::RunVertexDedupBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-filters") == 0) {
+        spartan::asset::RunStreamFilterBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-handles") == 0) {
+        spartan::asset::RunSlotMapBenchmark();
+        return 0;
+    }
+    if (argc > 2 && std::strcmp(argv[1], "--bench-load") == 0) {
+        spartan::asset::RunAssetLoadBenchmark(argv[2]);
+        return 0;
+    }
+
     SimpleApplication app;
+    bool checkUnload = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--static-batch") == 0) {
+            app.setStaticBatching(true);
+        }
+        // 合批后卸载，检查资源全部回收
+        if (std::strcmp(argv[i], "--check-unload") == 0) {
+            app.setStaticBatching(true);
+            checkUnload = true;
+        }
+    }
 
     if (!app.initialize()) {
         return -1;
     }
 
+    if (checkUnload) {
+        const bool ok = app.checkUnload();
+        app.shutdown();
+        return ok ? 0 : 1;
+    }
+
     app.printControls();
     app.run();
     app.shutdown();
@@ -0,0 +1,417 @@
+#include "StaticBatcher.h"
+#include "ResourceManager.h"
+#include "GltfTools/MeshOptimizer.h"
+#include <glm/gtc/matrix_inverse.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+
+    // 运行时着色器只读取位置、法线和UV0，合批网格只保留这三个属性（float布局）
+    constexpr uint32_t BATCH_ATTRIBUTES = VertexFormat::POSITION | VertexFormat::NORMAL | VertexFormat::UV0;
+
+    struct SourceItem {
+        entt::entity entity;
+        const MeshData* mesh;
+        uint32_t submeshIndex;
+        glm::mat4 world;
+        uint32_t vertexCount;  // 子网格引用到的唯一顶点数
+    };
+
+    // 分组键：材质稠密索引、属性集合、空间块坐标（std::map保证合批顺序与输入一致可复现）
+    using GroupKey = std::tuple<uint32_t, uint32_t, int, int, int>;
+
+    VertexFormat makeBatchFormat(uint32_t attributes) {
+        VertexFormat format;
+        format.attributes = attributes;
+        uint32_t offset = 0;
+        auto add = [&](VertexFormat::Attribute attr, uint32_t components) {
+            if (attributes & attr) {
+                format.attribute_map[attr] = {offset, components, GL_FLOAT, false};
+                offset += components * sizeof(float);
+            }
+        };
+        add(VertexFormat::POSITION, 3);
+        add(VertexFormat::NORMAL, 3);
+        add(VertexFormat::UV0, 2);
+        format.stride = offset;
+        return format;
+    }
+
+    /**
+     * 按属性描述把一个顶点属性解码成float（支持导入和量化阶段产生的所有类型）
+     */
+    bool readAttribute(const MeshData& mesh, VertexFormat::Attribute attr, uint32_t vertex, glm::vec4& out) {
+        auto it = mesh.format.attribute_map.find(attr);
+        if (it == mesh.format.attribute_map.end()) {
+            return false;
+        }
+        const auto& info = it->second;
+        const uint8_t* src = mesh.GetVertexData() + static_cast<size_t>(vertex) * mesh.format.stride + info.offset;
+
+        out = glm::vec4(0.0f);
+        for (uint32_t c = 0; c < info.components && c < 4; ++c) {
+            switch (info.type) {
+                case GL_FLOAT: {
+                    float value;
+                    std::memcpy(&value, src + c * sizeof(float), sizeof(value));
+                    out[c] = value;
+                    break;
+                }
+                case GL_HALF_FLOAT: {
+                    uint16_t value;
+                    std::memcpy(&value, src + c * sizeof(uint16_t), sizeof(value));
+                    out[c] = HalfToFloat(value);
+                    break;
+                }
+                case GL_SHORT: {
+                    int16_t value;
+                    std::memcpy(&value, src + c * sizeof(int16_t), sizeof(value));
+                    out[c] = info.normalized ? DequantizeSnorm16(value) : static_cast<float>(value);
+                    break;
+                }
+                case GL_BYTE: {
+                    int8_t value = static_cast<int8_t>(src[c]);
+                    out[c] = info.normalized ? DequantizeSnorm8(value) : static_cast<float>(value);
+                    break;
+                }
+                case GL_UNSIGNED_BYTE:
+                    out[c] = info.normalized ? src[c] / 255.0f : static_cast<float>(src[c]);
+                    break;
+                case GL_UNSIGNED_SHORT: {
+                    uint16_t value;
+                    std::memcpy(&value, src + c * sizeof(uint16_t), sizeof(value));
+                    out[c] = info.normalized ? value / 65535.0f : static_cast<float>(value);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    glm::vec3 readPosition(const MeshData& mesh, const MeshData::SubMesh& submesh, uint32_t vertex) {
+        glm::vec4 value;
+        readAttribute(mesh, VertexFormat::POSITION, vertex, value);
+        glm::vec3 position(value);
+        if (mesh.format.quantized) {
+            position = position * submesh.dequant_scale + submesh.dequant_offset;
+        }
+        return position;
+    }
+
+    glm::vec3 readNormal(const MeshData& mesh, uint32_t vertex) {
+        glm::vec4 value;
+        if (!readAttribute(mesh, VertexFormat::NORMAL, vertex, value)) {
+            return glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+        if (mesh.format.quantized) {
+            return DecodeOctahedral(glm::vec2(value));
+        }
+        return glm::vec3(value);
+    }
+
+    glm::ivec3 chunkOf(const glm::vec3& position, float chunkSize) {
+        return glm::ivec3(glm::floor(position / chunkSize));
+    }
+
+    // 子网格包围盒的8个角变换到世界空间后重新求包围盒
+    void transformBounds(const MeshData::SubMesh& submesh, const glm::mat4& world,
+                         glm::vec3& boundsMin, glm::vec3& boundsMax) {
+        glm::vec3 localMin(submesh.aabb_min.x, submesh.aabb_min.y, submesh.aabb_min.z);
+        glm::vec3 localMax(submesh.aabb_max.x, submesh.aabb_max.y, submesh.aabb_max.z);
+        for (int corner = 0; corner < 8; ++corner) {
+            glm::vec3 p((corner & 1) ? localMax.x : localMin.x,
+                        (corner & 2) ? localMax.y : localMin.y,
+                        (corner & 4) ? localMax.z : localMin.z);
+            glm::vec3 wp = glm::vec3(world * glm::vec4(p, 1.0f));
+            boundsMin = glm::min(boundsMin, wp);
+            boundsMax = glm::max(boundsMax, wp);
+        }
+    }
+
+    bool isAnimatedHierarchy(entt::registry& registry, entt::entity entity) {
+        entt::entity current = entity;
+        // 与RenderPipeline::findModelRoot一致，最多向上查找10层
+        for (int i = 0; i < 10 && registry.valid(current); ++i) {
+            if (registry.any_of<SkeletonComponent, AnimationControllerComponent, MultiTrackAnimationComponent>(current)) {
+                return true;
+            }
+            auto* parent = registry.try_get<ParentEntity>(current);
+            if (!parent) break;
+            current = parent->parent;
+        }
+        return false;
+    }
+
+} // namespace
+
+// =========================================================================
+// StaticBatcher 实现
+// =========================================================================
+
+std::vector<entt::entity> StaticBatcher::collectStaticEntities(entt::registry& registry, const ProcessedAsset& asset) {
+    std::vector<entt::entity> result;
+    auto view = registry.view<LocalTransform, MeshComponent, RenderStateComponent>();
+    for (auto entity : view) {
+        if (!view.get<RenderStateComponent>(entity).visible) continue;
+        if (registry.any_of<InstanceSourceComponent, StaticBatchComponent>(entity)) continue;
+
+        auto meshIt = asset.meshes.find(view.get<MeshComponent>(entity).handle);
+        if (meshIt == asset.meshes.end()) continue;
+        const auto& mesh = meshIt->second;
+        if (mesh.skeleton.has_value() || (mesh.format.attributes & VertexFormat::JOINTS0)) continue;
+
+        if (isAnimatedHierarchy(registry, entity)) continue;
+        result.push_back(entity);
+    }
+    return result;
+}
+
+StaticBatcher::Result StaticBatcher::build(entt::registry& registry, const std::vector<entt::entity>& entities,
+                                           ProcessedAsset& asset, const Config& config) {
+    Result result;
+    const float chunkSize = config.chunkSize > 0.0f ? config.chunkSize : 32.0f;
+    const uint32_t maxVertices = std::max(config.maxVerticesPerBatch, 3u);
+
+    // 顶点去重用的标记数组，按网格顶点数扩容，避免每个源重新分配
+    std::vector<uint32_t> stamp;
+    std::vector<uint32_t> remap;
+    uint32_t currentStamp = 0;
+    auto beginRemap = [&](uint32_t vertexCount) {
+        if (stamp.size() < vertexCount) {
+            stamp.resize(vertexCount, 0);
+            remap.resize(vertexCount, 0);
+        }
+        currentStamp++;
+    };
+
+    // --- 1. 收集源子网格并按（材质, 属性, 空间块）分组 ---
+    std::map<GroupKey, std::vector<SourceItem>> groups;
+    std::map<GroupKey, MaterialHandle> groupMaterials;
+    // 每个源实体还有多少可绘制的子网格没有进入合批，为0时才能隐藏
+    std::unordered_map<entt::entity, uint32_t> unbatchedSubmeshes;
+
+    for (auto entity : entities) {
+        auto* meshComp = registry.try_get<MeshComponent>(entity);
+        auto* localTransform = registry.try_get<LocalTransform>(entity);
+        auto meshIt = meshComp ? asset.meshes.find(meshComp->handle) : asset.meshes.end();
+        if (!localTransform || meshIt == asset.meshes.end()) {
+            result.skippedEntities++;
+            continue;
+        }
+
+        const auto& mesh = meshIt->second;
+        bool skinned = mesh.skeleton.has_value() || (mesh.format.attributes & VertexFormat::JOINTS0);
+        bool hasCPUData = mesh.HasCPUData() && mesh.vertex_count > 0 &&
+                          mesh.GetVertexDataSize() >= static_cast<size_t>(mesh.vertex_count) * mesh.format.stride &&
+                          mesh.format.attribute_map.count(VertexFormat::POSITION) > 0;
+        if (skinned || !hasCPUData) {
+            result.skippedEntities++;
+            continue;
+        }
+
+        // 整个实体归入同一个空间块，避免一个源被拆到多个合批
+        const glm::mat4& world = localTransform->matrix;
+        glm::vec3 boundsMin(FLT_MAX);
+        glm::vec3 boundsMax(-FLT_MAX);
+        for (const auto& submesh : mesh.submeshes) {
+            transformBounds(submesh, world, boundsMin, boundsMax);
+        }
+        if (boundsMin.x > boundsMax.x) {
+            result.skippedEntities++;
+            continue;
+        }
+        glm::ivec3 chunk = chunkOf((boundsMin + boundsMax) * 0.5f, chunkSize);
+        uint32_t attributes = mesh.format.attributes & BATCH_ATTRIBUTES;
+
+        uint32_t& unbatched = unbatchedSubmeshes[entity];
+        for (uint32_t s = 0; s < mesh.submeshes.size(); ++s) {
+            const auto& submesh = mesh.submeshes[s];
+            if (submesh.index_count < 3) {
+                continue;
+            }
+            unbatched++;
+            if (static_cast<size_t>(submesh.index_offset) + submesh.index_count > mesh.GetIndexCount()) {
+                continue;
+            }
+
+            beginRemap(mesh.vertex_count);
+            uint32_t uniqueVertices = 0;
+            for (uint32_t i = 0; i < submesh.index_count; ++i) {
+                uint32_t v = mesh.GetIndex(submesh.index_offset + i);
+                if (v < mesh.vertex_count && stamp[v] != currentStamp) {
+                    stamp[v] = currentStamp;
+                    uniqueVertices++;
+                }
+            }
+
+            GroupKey key{submesh.material_index, attributes, chunk.x, chunk.y, chunk.z};
+            groups[key].push_back({entity, &mesh, s, world, uniqueVertices});
+            groupMaterials.emplace(key, submesh.material);
+            result.drawsBefore++;
+        }
+        result.sourceEntities++;
+    }
+
+    // --- 2. 每组按顶点预算拆分，生成合批网格 ---
+    for (const auto& [key, items] : groups) {
+        const uint32_t materialIndex = std::get<0>(key);
+        const uint32_t attributes = std::get<1>(key);
+        const glm::ivec3 chunk(std::get<2>(key), std::get<3>(key), std::get<4>(key));
+        const VertexFormat format = makeBatchFormat(attributes);
+
+        size_t begin = 0;
+        while (begin < items.size()) {
+            // 尽量多地装入源，单个源超过预算时独占一个合批（使用32位索引）
+            size_t end = begin;
+            uint32_t batchVertices = 0;
+            while (end < items.size() &&
+                   (end == begin || batchVertices + items[end].vertexCount <= maxVertices)) {
+                batchVertices += items[end].vertexCount;
+                end++;
+            }
+
+            MeshData batch;
+            batch.format = format;
+            batch.vertex_buffer.reserve(static_cast<size_t>(batchVertices) * format.stride);
+
+            StaticBatchComponent batchComp;
+            batchComp.chunk = chunk;
+            batchComp.boundsMin = glm::vec3(FLT_MAX);
+            batchComp.boundsMax = glm::vec3(-FLT_MAX);
+
+            for (size_t n = begin; n < end; ++n) {
+                const auto& item = items[n];
+                const auto& mesh = *item.mesh;
+                const auto& submesh = mesh.submeshes[item.submeshIndex];
+                const glm::mat3 normalMatrix = glm::inverseTranspose(glm::mat3(item.world));
+                // 镜像变换会翻转三角形朝向，需要交换绕序
+                const bool mirrored = glm::determinant(glm::mat3(item.world)) < 0.0f;
+
+                StaticBatchComponent::SourceRange range;
+                range.source = item.entity;
+                range.indexOffset = static_cast<uint32_t>(batch.index_buffer.size());
+                range.boundsMin = glm::vec3(FLT_MAX);
+                range.boundsMax = glm::vec3(-FLT_MAX);
+
+                beginRemap(mesh.vertex_count);
+                auto emitVertex = [&](uint32_t v) -> uint32_t {
+                    if (stamp[v] == currentStamp) {
+                        return remap[v];
+                    }
+                    stamp[v] = currentStamp;
+                    remap[v] = batch.vertex_count++;
+
+                    glm::vec3 position = glm::vec3(item.world * glm::vec4(readPosition(mesh, submesh, v), 1.0f));
+                    range.boundsMin = glm::min(range.boundsMin, position);
+                    range.boundsMax = glm::max(range.boundsMax, position);
+
+                    size_t base = batch.vertex_buffer.size();
+                    batch.vertex_buffer.resize(base + format.stride);
+                    uint8_t* dst = batch.vertex_buffer.data() + base;
+                    std::memcpy(dst + format.attribute_map.at(VertexFormat::POSITION).offset, &position, sizeof(position));
+                    if (attributes & VertexFormat::NORMAL) {
+                        glm::vec3 normal = readNormal(mesh, v);
+                        normal = normalMatrix * normal;
+                        float length = glm::length(normal);
+                        normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+                        std::memcpy(dst + format.attribute_map.at(VertexFormat::NORMAL).offset, &normal, sizeof(normal));
+                    }
+                    if (attributes & VertexFormat::UV0) {
+                        glm::vec4 uv;
+                        readAttribute(mesh, VertexFormat::UV0, v, uv);
+                        glm::vec2 uv2(uv);
+                        std::memcpy(dst + format.attribute_map.at(VertexFormat::UV0).offset, &uv2, sizeof(uv2));
+                    }
+                    return remap[v];
+                };
+
+                const uint32_t triangleCount = submesh.index_count / 3;
+                for (uint32_t t = 0; t < triangleCount; ++t) {
+                    uint32_t a = mesh.GetIndex(submesh.index_offset + t * 3 + 0);
+                    uint32_t b = mesh.GetIndex(submesh.index_offset + t * 3 + 1);
+                    uint32_t c = mesh.GetIndex(submesh.index_offset + t * 3 + 2);
+                    if (a >= mesh.vertex_count || b >= mesh.vertex_count || c >= mesh.vertex_count) {
+                        continue;
+                    }
+                    if (mirrored) {
+                        std::swap(b, c);
+                    }
+                    batch.index_buffer.push_back(emitVertex(a));
+                    batch.index_buffer.push_back(emitVertex(b));
+                    batch.index_buffer.push_back(emitVertex(c));
+                }
+
+                range.indexCount = static_cast<uint32_t>(batch.index_buffer.size()) - range.indexOffset;
+                if (range.indexCount == 0) continue;
+                batchComp.boundsMin = glm::min(batchComp.boundsMin, range.boundsMin);
+                batchComp.boundsMax = glm::max(batchComp.boundsMax, range.boundsMax);
+                batchComp.sources.push_back(range);
+            }
+
+            begin = end;
+            if (batch.index_buffer.empty()) continue;
+
+            // 整个合批只有一个子网格，一次绘制；源范围保存在StaticBatchComponent里
+            MeshData::SubMesh merged;
+            merged.index_offset = 0;
+            merged.index_count = static_cast<uint32_t>(batch.index_buffer.size());
+            merged.material = groupMaterials.at(key);
+            merged.material_index = materialIndex;
+            merged.aabb_min = ozz::math::Float3(batchComp.boundsMin.x, batchComp.boundsMin.y, batchComp.boundsMin.z);
+            merged.aabb_max = ozz::math::Float3(batchComp.boundsMax.x, batchComp.boundsMax.y, batchComp.boundsMax.z);
+            batch.submeshes.push_back(merged);
+            batch.index_type = batch.vertex_count <= MeshData::MAX_16BIT_VERTEX_COUNT ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+            result.mergedVertices += batch.vertex_count;
+            result.mergedTriangles += merged.index_count / 3;
+            for (const auto& range : batchComp.sources) {
+                unbatchedSubmeshes[range.source]--;
+            }
+
+            // 句柄由资源管理器分配，避免与已加载资源包的全局句柄冲突；
+            // addMesh返回的引用交给合批实体，实体销毁时归还，合批网格及其材质随之释放
+            MeshHandle handle = ResourceManager::getInstance().addMesh(std::move(batch));
+
+            auto batchEntity = registry.create();
+            registry.emplace<Transform>(batchEntity);
+            auto& localTransform = registry.emplace<LocalTransform>(batchEntity);
+            localTransform.dirty = false;  // 顶点已在世界空间，模型矩阵保持单位矩阵
+            registry.emplace<MeshComponent>(batchEntity, MeshComponent{handle, {merged.material}});
+            registry.emplace<RenderStateComponent>(batchEntity);
+            registry.emplace<StaticBatchComponent>(batchEntity, std::move(batchComp));
+            EntityFactory::connectResourceReferences(registry);
+            registry.emplace<ResourceReferenceComponent>(batchEntity).meshes.push_back(handle);
+
+            result.batchEntities.push_back(batchEntity);
+            result.drawsAfter++;
+        }
+    }
+
+    // --- 3. 隐藏源实体：只隐藏所有可绘制子网格都已进入合批的实体，部分合批的实体保持原样绘制 ---
+    if (config.hideSources) {
+        for (const auto& [entity, unbatched] : unbatchedSubmeshes) {
+            if (unbatched != 0) continue;
+            if (auto* renderState = registry.try_get<RenderStateComponent>(entity)) {
+                renderState->visible = false;
+            }
+        }
+    }
+
+    std::cout << "静态合批: " << result.sourceEntities << " 个实体, 绘制 "
+              << result.drawsBefore << " -> " << result.drawsAfter
+              << ", 顶点 " << result.mergedVertices << ", 三角形 " << result.mergedTriangles;
+    if (result.skippedEntities > 0) {
+        std::cout << ", 跳过 " << result.skippedEntities << " 个实体";
+    }
+    std::cout << std::endl;
+
+    return result;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "EntityComponents.h"
+#include <entt/entt.hpp>
+#include <vector>
+
+// =========================================================================
+// 静态合批工具（README 8.5）- 加载阶段把静态网格预变换到世界空间并合并
+// =========================================================================
+
+/**
+ * 静态合批
+ * 职责：把带MeshComponent + LocalTransform的静态实体按（材质, 空间块）分组，
+ *      顶点预变换到世界空间后合并成少量MeshData，每个合批只需一次绘制。
+ * 约定：在资源包加载之后调用（依赖已编译的稠密材质索引），
+ *      且变换系统已经算好LocalTransform；蒙皮网格不参与合批。
+ *      源实体保留（用于拾取/逻辑），只把RenderStateComponent::visible置为false。
+ */
+class StaticBatcher {
+public:
+    struct Config {
+        float chunkSize = 32.0f;  // 空间块边长（世界单位），同一块内的源才会合并，合批仍可按块剔除
+        uint32_t maxVerticesPerBatch = MeshData::MAX_16BIT_VERTEX_COUNT;  // 超过后拆成多个合批，默认保证16位索引
+        bool hideSources = true;
+    };
+
+    struct Result {
+        uint32_t sourceEntities = 0;   // 参与合批的实体
+        uint32_t skippedEntities = 0;  // 蒙皮、缺少CPU数据等原因被跳过的实体
+        uint32_t drawsBefore = 0;      // 合批前的子网格绘制数
+        uint32_t drawsAfter = 0;       // 合批后的绘制数
+        uint32_t mergedVertices = 0;
+        uint32_t mergedTriangles = 0;
+        std::vector<entt::entity> batchEntities;
+    };
+
+    /**
+     * 合并给定实体，新建的合批网格经ResourceManager::addMesh注册并上传GPU，每个合批生成一个实体
+     */
+    static Result build(entt::registry& registry, const std::vector<entt::entity>& entities,
+                        ProcessedAsset& asset, const Config& config);
+    static Result build(entt::registry& registry, const std::vector<entt::entity>& entities,
+                        ProcessedAsset& asset) {
+        return build(registry, entities, asset, Config());
+    }
+
+    /**
+     * 收集场景中所有可合批的静态网格实体（非蒙皮、非实例源）
+     */
+    static std::vector<entt::entity> collectStaticEntities(entt::registry& registry, const ProcessedAsset& asset);
+};
@@ -2,6 +2,7 @@
 #include "EntityComponents.h"
 #include "Renderer.h"
 #include "RenderDevice.h"
+#include "RenderPipeline.h"
 #include "glad/glad.h"
 #include "AnimationTask.h"
 #include <algorithm>
@@ -360,11 +361,11 @@ void AnimationSystem::applyAnimationResults(entt::registry& registry) {
         auto& taskState = skeletonTasks[skeleton.handle.id];
 
         if (taskState.hasNewResult) {
-            auto skelIt = renderer.getAsset().skeletons.find(skeleton.handle);
-            if (skelIt == renderer.getAsset().skeletons.end()) {
+            const auto* skelEntry = renderer.getAsset().skeletons.get(skeleton.handle);
+            if (!skelEntry) {
                 continue;
             }
-            const auto& skelPtr = skelIt->second;
+            const auto& skelPtr = *skelEntry;
 
             skeleton.finalTransforms = taskState.cachedLocalTransforms;
 
@@ -905,10 +906,8 @@ void InstancedRenderSystem::forceUpdateInstances(entt::registry& registry) {
         if (instancedMesh.needsUpdate && instancedMesh.getInstanceCount() > 0) {
             updateInstanceBuffer(instancedMesh);
 
-            auto& asset = renderer.getAsset();
-            auto meshIt = asset.meshes.find(instancedMesh.handle);
-            if (meshIt != asset.meshes.end()) {
-                renderer.setupInstancedVAO(meshIt->second, instancedMesh.instanceBuffer);
+            if (auto* mesh = renderer.getAsset().meshes.get(instancedMesh.handle)) {
+                renderer.setupInstancedVAO(*mesh, instancedMesh.instanceBuffer);
             }
 
             instancedMesh.needsUpdate = false;
@@ -925,7 +924,7 @@ void InstancedRenderSystem::updateInstanceBuffer(InstancedMeshComponent& instanc
         glGenBuffers(1, &instancedMesh.instanceBuffer);
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, instancedMesh.instanceBuffer);
+    RenderDevice::getInstance().getStateCache().bindBuffer(GL_ARRAY_BUFFER, instancedMesh.instanceBuffer);
     glBufferData(GL_ARRAY_BUFFER,
                  instancedMesh.instanceMatrices.size() * sizeof(glm::mat4),
                  instancedMesh.instanceMatrices.data(),
@@ -1089,8 +1088,16 @@ entt::entity InstanceControlSystem::createInstanceSource(entt::registry& registr
 
 // LightManager 实现
 void LightManager::update(entt::registry& registry, float deltaTime) {
-    // 目前是空实现，预留给后续扩展
-    // 可以在这里更新动态光照、阴影等
+    // 把方向光写入每帧常量，由RenderPipeline统一上传到UBO
+    std::vector<FrameConstants::Light> lights;
+    lights.reserve(directionalLights.size());
+    for (const auto& light : directionalLights) {
+        FrameConstants::Light frameLight;
+        frameLight.direction = glm::vec4(light.direction, light.intensity);
+        frameLight.color = glm::vec4(light.color, 1.0f);
+        lights.push_back(frameLight);
+    }
+    RenderPipeline::getInstance().setDirectionalLights(lights);
 }
 
 void LightManager::addDirectionalLight(const glm::vec3& direction, const glm::vec3& color, float intensity) {